@@ -47,6 +47,10 @@ android {
     buildFeatures {
         viewBinding = true
     }
+    androidResources {
+        // corpus.bin se mapea en memoria desde el APK: no debe comprimirse
+        noCompress += "bin"
+    }
 }
 
 dependencies {
@@ -5,9 +5,20 @@
 #include <android/asset_manager.h>
 #include <android/asset_manager_jni.h>
 #include <opencv2/opencv.hpp>
+#include <memory>
 #include <vector>
-#include <sstream>
-#include <cmath>
+
+#include "corpus_binary.h"
+#include "corpus_io.h"
+#include "descriptor_matrix.h"
+#include "hnsw_index.h"
+#include "ink_crop.h"
+#include "latest_worker.h"
+#include "nn_index.h"
+#include "rgba_gray.h"
+#include "shape_log.h"
+#include "shape_pipeline.h"
+#include "stroke_contour.h"
 
 using namespace cv;
 using namespace std;
@@ -17,324 +28,298 @@ using namespace std;
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
 
-// CONSTANTES GLOBALES
+// logs del pipeline compartido (shape_core) → logcat
 
+void androidLogSink(LogLevel level, const char* message) {
+    int priority = (level == LogLevel::Error) ? ANDROID_LOG_ERROR : ANDROID_LOG_INFO;
+    __android_log_write(priority, LOG_TAG, message);
+}
 
-const int NUM_POINTS = 1024;
-const int NUM_HARMONICS = 15;
+JavaVM* javaVm = nullptr;
 
-struct ShapeDescriptor {
-    vector<float> features;
-    string label;
-    
-    ShapeDescriptor() {}
-    ShapeDescriptor(const vector<float>& f, const string& l) : features(f), label(l) {}
-};
+extern "C" JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* /* reserved */) {
+    javaVm = vm;
+    setLogSink(androidLogSink);
+    return JNI_VERSION_1_6;
+}
 
-// Extrae el contorno de la imagen
-bool extractContour(const Mat& image, vector<Point>& contour) {
-    Mat gray, binary;
-    
-    if (image.channels() == 3 || image.channels() == 4) {
-        cvtColor(image, gray, COLOR_BGR2GRAY);
-    } else {
-        gray = image.clone();
+// cargar corpus desde assets
+
+DescriptorMatrix loadCorpusFromAssets(AAssetManager* assetManager) {
+    AAsset* asset = AAssetManager_open(assetManager, "corpus.csv", AASSET_MODE_BUFFER);
+    if (!asset) {
+        LOGE("No se pudo abrir corpus.csv desde assets");
+        return DescriptorMatrix();
     }
     
-    adaptiveThreshold(gray, binary, 255, ADAPTIVE_THRESH_GAUSSIAN_C, 
-                      THRESH_BINARY_INV, 11, 2);
-    
-    Mat kernel = getStructuringElement(MORPH_ELLIPSE, Size(3, 3));
-    morphologyEx(binary, binary, MORPH_CLOSE, kernel);
-    morphologyEx(binary, binary, MORPH_OPEN, kernel);
-    
-    vector<vector<Point>> contours;
-    findContours(binary, contours, RETR_EXTERNAL, CHAIN_APPROX_NONE);
-    
-    if (contours.empty()) {
-        LOGE("No se encontraron contornos");
-        return false;
-    }
+    size_t fileSize = AAsset_getLength(asset);
+    const char* buffer = static_cast<const char*>(AAsset_getBuffer(asset));
     
-    double maxArea = 0;
-    int maxIdx = 0;
-    for (size_t i = 0; i < contours.size(); i++) {
-        double area = contourArea(contours[i]);
-        if (area > maxArea) {
-            maxArea = area;
-            maxIdx = i;
-        }
+    if (buffer == nullptr) {
+        LOGE("No se pudo leer corpus.csv desde assets");
+        AAsset_close(asset);
+        return DescriptorMatrix();
     }
     
-    contour = contours[maxIdx];
-    
-    if (maxArea < 100) {
-        LOGE("Contorno muy pequeño (área < 100)");
-        return false;
-    }
+    DescriptorMatrix corpus = parseCorpus(buffer, fileSize);
     
-    LOGI("Contorno extraído: %zu puntos, área = %.0f px²", contour.size(), maxArea);
-    return true;
+    AAsset_close(asset);
+    return corpus;
 }
 
-// Interpolacion lineal a 1024 puntos
-vector<Point2f> interpolateContour(const vector<Point>& contour) {
-    int n = contour.size();
-    
-    if (n < 3) {
-        LOGE("Contorno con muy pocos puntos: %d", n);
-        return vector<Point2f>();
+/**
+ * Carga corpus.bin si existe: el asset se guarda sin comprimir
+ * (noCompress en build.gradle.kts), así AAsset_getBuffer devuelve la
+ * memoria mapeada del APK y la matriz apunta directamente a ella. El asset
+ * queda abierto mientras viva la matriz.
+ */
+DescriptorMatrix loadBinaryCorpusFromAssets(AAssetManager* assetManager) {
+    AAsset* asset = AAssetManager_open(assetManager, "corpus.bin", AASSET_MODE_BUFFER);
+    if (!asset) {
+        return DescriptorMatrix();
     }
     
-    vector<float> cumulativeLength(n);
-    cumulativeLength[0] = 0.0f;
+    shared_ptr<AAsset> keepAlive(asset, AAsset_close);
+    const void* buffer = AAsset_getBuffer(asset);
+    size_t fileSize = AAsset_getLength(asset);
     
-    for (int i = 1; i < n; i++) {
-        float dx = contour[i].x - contour[i-1].x;
-        float dy = contour[i].y - contour[i-1].y;
-        float dist = sqrt(dx*dx + dy*dy);
-        cumulativeLength[i] = cumulativeLength[i-1] + dist;
+    if (buffer == nullptr) {
+        LOGE("No se pudo leer corpus.bin desde assets");
+        return DescriptorMatrix();
     }
     
-    float totalLength = cumulativeLength[n-1];
-    vector<Point2f> interpolated(NUM_POINTS);
-    
-    for (int i = 0; i < NUM_POINTS; i++) {
-        float targetLength = (totalLength * i) / NUM_POINTS;
-        
-        int idx = 0;
-        while (idx < n-1 && cumulativeLength[idx+1] < targetLength) {
-            idx++;
-        }
-        
-        if (idx < n-1) {
-            float segmentLength = cumulativeLength[idx+1] - cumulativeLength[idx];
-            float t = (targetLength - cumulativeLength[idx]) / segmentLength;
-            
-            interpolated[i].x = (1-t) * contour[idx].x + t * contour[idx+1].x;
-            interpolated[i].y = (1-t) * contour[idx].y + t * contour[idx+1].y;
-        } else {
-            interpolated[i] = contour[idx];
-        }
+    return corpusFromBinaryBuffer(buffer, fileSize, keepAlive);
+}
+
+/**
+ * Índice del corpus: corpus.hnsw si se empaquetó junto al corpus (generado
+ * con `shape_app index --corpus corpus.bin --index hnsw`); si no, o si es de
+ * otro corpus, fuerza bruta, que con el corpus de 80 filas es lo más rápido.
+ */
+unique_ptr<NearestNeighborIndex> loadIndexFromAssets(AAssetManager* assetManager,
+                                                     const DescriptorMatrix& corpus) {
+    AAsset* asset = AAssetManager_open(assetManager, "corpus.hnsw", AASSET_MODE_BUFFER);
+    if (asset) {
+        const char* buffer = static_cast<const char*>(AAsset_getBuffer(asset));
+        size_t fileSize = AAsset_getLength(asset);
+        unique_ptr<NearestNeighborIndex> index;
+        if (buffer) index = HnswIndex::fromBuffer(corpus, buffer, fileSize);
+        AAsset_close(asset);
+        if (index) return index;
     }
-    
-    LOGI("Contorno interpolado: %d → %d puntos", n, NUM_POINTS);
-    return interpolated;
+    return buildIndex(IndexKind::BruteForce, corpus);
 }
 
-//calcular centroide
+// conversión: Android Bitmap → OpenCV Mat
 
-Point2f calculateCentroid(const vector<Point2f>& contour) {
-    float sumX = 0, sumY = 0;
+// Lado mayor tras el recorte: el trazo (20 px en DrawingView) sigue siendo
+// grueso y los filtros del paso 1 recorren 4-16 veces menos píxeles
+const int MAX_IMAGE_SIDE = 512;
+
+/**
+ * Bitmap → imagen gris de la región con tinta, leyendo los píxeles
+ * bloqueados una sola vez: inkRegion localiza el trazo (con margen) y
+ * rgbaToGray convierte sólo esa región a 1 canal, directamente al Mat de
+ * salida. Sin copia RGBA intermedia; el bitmap se desbloquea en cuanto
+ * termina la conversión. Mat vacío si el bitmap no es RGBA_8888.
+ */
+Mat bitmapToGray(JNIEnv* env, jobject bitmap) {
+    AndroidBitmapInfo info;
+    void* pixels;
     
-    for (const auto& pt : contour) {
-        sumX += pt.x;
-        sumY += pt.y;
+    AndroidBitmap_getInfo(env, bitmap, &info);
+    if (info.format != ANDROID_BITMAP_FORMAT_RGBA_8888) {
+        LOGE("Formato de bitmap no soportado: %d", info.format);
+        return Mat();
     }
+    if (AndroidBitmap_lockPixels(env, bitmap, &pixels) != ANDROID_BITMAP_RESULT_SUCCESS) {
+        LOGE("No se pudo bloquear el bitmap");
+        return Mat();
+    }
+    
+    Mat rgba(info.height, info.width, CV_8UC4, pixels, info.stride);
+    Mat gray;
+    rgbaToGray(rgba(inkRegion(rgba)), gray);
     
-    Point2f centroid(sumX / contour.size(), sumY / contour.size());
-    LOGI("Centroide: (%.2f, %.2f)", centroid.x, centroid.y);
+    AndroidBitmap_unlockPixels(env, bitmap);
     
-    return centroid;
+    return gray;
 }
 
-// construir señal compleja
+// traducción a español
 
-Mat buildComplexSignal(const vector<Point2f>& contour, const Point2f& centroid) {
-    int n = contour.size();
-    Mat complexSignal(n, 1, CV_32FC2);
-    
-    for (int i = 0; i < n; i++) {
-        float real = contour[i].x - centroid.x;
-        float imag = contour[i].y - centroid.y;
-        complexSignal.at<Vec2f>(i, 0) = Vec2f(real, imag);
-    }
-    
-    LOGI("Señal compleja construida");
-    return complexSignal;
+string translateToSpanish(const string& label) {
+    if (label == "circle") return "Círculo";
+    if (label == "triangle") return "Triángulo";
+    if (label == "square") return "Cuadrado";
+    return label;
 }
 
-// fft
+// sesión de clasificación: corpus cargado una sola vez
 
-void computeFFT(const Mat& complexSignal, vector<float>& magnitudes) {
-    Mat dftOutput;
-    dft(complexSignal, dftOutput, DFT_COMPLEX_OUTPUT);
-    
-    vector<Mat> planes(2);
-    split(dftOutput, planes);
-    
-    Mat mag;
-    magnitude(planes[0], planes[1], mag);
-    
-    magnitudes.clear();
-    for (int i = 0; i < mag.rows; i++) {
-        magnitudes.push_back(mag.at<float>(i, 0));
-    }
-    
-    LOGI("FFT calculada: %zu coeficientes", magnitudes.size());
-}
+// Trazos copiados de Kotlin: x0, y0, x1, y1, ... y puntos de cada trazo
+struct StrokeJob {
+    vector<jfloat> xy;
+    vector<jint> lengths;
+};
 
-// normalizar descriptor
+/**
+ * Estado nativo que vive entre llamadas JNI. Kotlin sólo guarda el puntero
+ * como Long (handle): initClassifier lo crea, releaseClassifier lo libera.
+ * El corpus es inmutable tras la carga, así cada clasificación cuesta sólo
+ * la extracción del descriptor y la búsqueda.
+ *
+ * liveWorker clasifica en segundo plano los trazos que llegan con
+ * submitStrokes (gana el último) y devuelve cada resultado llamando a
+ * MainActivity.onLiveResult desde su propio hilo.
+ */
+struct ClassifierSession {
+    DescriptorMatrix corpus;
+    unique_ptr<NearestNeighborIndex> index;
+    jobject listener = nullptr;             // referencia global a MainActivity
+    jmethodID onLiveResult = nullptr;
+    unique_ptr<LatestWorker<StrokeJob>> liveWorker;
+};
 
-vector<float> normalizeDescriptor(const vector<float>& magnitudes) {
-    if (magnitudes.size() < 2) {
-        LOGE("Muy pocos coeficientes de Fourier");
-        return vector<float>(NUM_HARMONICS, 0.0f);
-    }
-    
-    float fundamental = magnitudes[1];
-    
-    if (fundamental < 1e-5) {
-        LOGE("Fundamental muy pequeño");
-        return vector<float>(NUM_HARMONICS, 0.0f);
+/**
+ * Copia la parte válida de los arrays de Kotlin (los primeros `numValues`
+ * y `numStrokes` elementos; DrawingView los hace crecer al doble). Falso si
+ * los tamaños no caben en los arrays o las longitudes no cuadran con los puntos.
+ */
+bool readStrokes(JNIEnv* env, jfloatArray points, jint numValues,
+                 jintArray strokeLengths, jint numStrokes, StrokeJob& job) {
+    if (numValues < 0 || numValues > env->GetArrayLength(points) ||
+        numStrokes < 0 || numStrokes > env->GetArrayLength(strokeLengths)) {
+        LOGE("Trazos inconsistentes: %d valores y %d trazos fuera de los arrays", numValues, numStrokes);
+        return false;
     }
-    
-    vector<float> descriptor;
-    
-    for (int k = 1; k <= NUM_HARMONICS && k < magnitudes.size(); k++) {
-        float normalized = magnitudes[k] / fundamental;
-        descriptor.push_back(normalized);
+    job.xy.resize(numValues);
+    job.lengths.resize(numStrokes);
+    env->GetFloatArrayRegion(points, 0, numValues, job.xy.data());
+    env->GetIntArrayRegion(strokeLengths, 0, numStrokes, job.lengths.data());
+    
+    // Longitudes negativas primero: con ellas la suma podría cuadrar y
+    // strokesToContour leería fuera de `xy`
+    long long totalPoints = 0;
+    for (jint length : job.lengths) {
+        if (length < 0) {
+            LOGE("Trazos inconsistentes: longitud negativa %d", length);
+            return false;
+        }
+        totalPoints += length;
     }
-    
-    while (descriptor.size() < NUM_HARMONICS) {
-        descriptor.push_back(0.0f);
+    if (2 * totalPoints != numValues) {
+        LOGE("Trazos inconsistentes: %lld puntos para %d valores", totalPoints, numValues);
+        return false;
     }
-    
-    LOGI("Descriptor normalizado: %zu armónicos", descriptor.size());
-    return descriptor;
+    return true;
 }
 
-// pipeline completo: extraer descriptor
-
-ShapeDescriptor extractShapeDescriptor(const Mat& image) {
-    LOGI("========================================");
-    LOGI("Iniciando extracción de descriptor");
-    LOGI("========================================");
-    
+/**
+ * Contorno directamente de los trazos (strokesToContour) + descriptor +
+ * búsqueda. Devuelve la etiqueta en español en `result`, o el mensaje de
+ * error si el dibujo aún no forma una figura.
+ */
+bool classifyStrokeJob(const ClassifierSession& session, const StrokeJob& job, string& result) {
     vector<Point> contour;
-    if (!extractContour(image, contour)) {
-        return ShapeDescriptor();
+    if (!strokesToContour(job.xy.data(), static_cast<int>(job.xy.size()), job.lengths.data(),
+                          static_cast<int>(job.lengths.size()), contour)) {
+        result = "Error: No se pudo extraer descriptor";
+        return false;
     }
     
-    vector<Point2f> interpolated = interpolateContour(contour);
-    if (interpolated.empty()) {
-        return ShapeDescriptor();
+    ShapeDescriptor testDescriptor = extractContourDescriptor(contour);
+    if (testDescriptor.features.empty()) {
+        result = "Error: No se pudo extraer descriptor";
+        return false;
     }
     
-    Point2f centroid = calculateCentroid(interpolated);
-    Mat complexSignal = buildComplexSignal(interpolated, centroid);
-    
-    vector<float> magnitudes;
-    computeFFT(complexSignal, magnitudes);
-    
-    vector<float> descriptor = normalizeDescriptor(magnitudes);
-    
-    LOGI("Descriptor extraído exitosamente");
-    return ShapeDescriptor(descriptor, "");
+    auto [label, distance] = classify(testDescriptor, *session.index);
+    result = translateToSpanish(label);
+    LOGI("Resultado (trazos): %s (distancia: %.4f)", result.c_str(), distance);
+    return true;
 }
 
-// clasificación: distancia euclidiana
-
-float euclideanDistance(const vector<float>& d1, const vector<float>& d2) {
-    if (d1.size() != d2.size()) {
-        LOGE("Descriptores de diferente tamaño");
-        return 1e9;
-    }
-    
-    float sum = 0.0f;
-    for (size_t i = 0; i < d1.size(); i++) {
-        float diff = d1[i] - d2[i];
-        sum += diff * diff;
+/**
+ * JNIEnv del hilo actual, enganchándolo a la JVM la primera vez. El guard
+ * thread_local lo desengancha al terminar el hilo (ART aborta si un hilo
+ * nativo enganchado sale sin DetachCurrentThread).
+ */
+JNIEnv* attachCurrentThread() {
+    struct AttachGuard {
+        JNIEnv* env = nullptr;
+        ~AttachGuard() {
+            if (env) javaVm->DetachCurrentThread();
+        }
+    };
+    thread_local AttachGuard guard;
+    if (guard.env == nullptr && javaVm->AttachCurrentThread(&guard.env, nullptr) != JNI_OK) {
+        guard.env = nullptr;
     }
-    
-    return sqrt(sum);
+    return guard.env;
 }
 
-pair<string, float> classify(const ShapeDescriptor& testDescriptor, 
-                             const vector<ShapeDescriptor>& corpus) {
-    if (corpus.empty()) {
-        LOGE("Corpus vacío");
-        return {"unknown", 1e9};
+// Manejador del hilo en vivo: clasifica y, si hay figura, avisa a Kotlin
+void deliverLiveResult(const ClassifierSession& session, const StrokeJob& job, uint64_t sequence) {
+    string result;
+    if (!classifyStrokeJob(session, job, result)) return;   // trazo aún abierto o muy pequeño
+    
+    JNIEnv* env = attachCurrentThread();
+    if (env == nullptr) {
+        LOGE("No se pudo enganchar el hilo de clasificación a la JVM");
+        return;
     }
-    
-    string bestLabel = "unknown";
-    float minDistance = 1e9;
-    
-    for (const auto& train : corpus) {
-        float dist = euclideanDistance(testDescriptor.features, train.features);
-        
-        if (dist < minDistance) {
-            minDistance = dist;
-            bestLabel = train.label;
-        }
+    jstring text = env->NewStringUTF(result.c_str());
+    env->CallVoidMethod(session.listener, session.onLiveResult, text, static_cast<jlong>(sequence));
+    env->DeleteLocalRef(text);
+    if (env->ExceptionCheck()) {
+        LOGE("Excepción en onLiveResult");
+        env->ExceptionClear();
     }
-    
-    LOGI("Clasificación: %s (distancia: %.4f)", bestLabel.c_str(), minDistance);
-    return {bestLabel, minDistance};
 }
 
-// cargar corpus desde assets
-
-vector<ShapeDescriptor> loadCorpusFromAssets(AAssetManager* assetManager) {
-    vector<ShapeDescriptor> corpus;
-    
-    AAsset* asset = AAssetManager_open(assetManager, "corpus.csv", AASSET_MODE_BUFFER);
-    if (!asset) {
-        LOGE("No se pudo abrir corpus.csv desde assets");
-        return corpus;
-    }
+// jni: crear sesión (carga corpus.bin o, si no está, corpus.csv, una vez)
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_example_android_1app_MainActivity_initClassifier(
+        JNIEnv* env,
+        jobject thiz,
+        jobject assetManager) {
     
-    size_t fileSize = AAsset_getLength(asset);
-    const char* buffer = static_cast<const char*>(AAsset_getBuffer(asset));
+    AAssetManager* mgr = AAssetManager_fromJava(env, assetManager);
     
-    stringstream ss(string(buffer, fileSize));
-    string line;
-    
-    while (getline(ss, line)) {
-        stringstream lineStream(line);
-        string label;
-        getline(lineStream, label, ',');
-        
-        vector<float> features;
-        string value;
-        while (getline(lineStream, value, ',')) {
-            features.push_back(stof(value));
-        }
-        
-        corpus.push_back(ShapeDescriptor(features, label));
+    auto* session = new ClassifierSession();
+    session->corpus = loadBinaryCorpusFromAssets(mgr);
+    if (session->corpus.empty()) {
+        session->corpus = loadCorpusFromAssets(mgr);
     }
-    
-    AAsset_close(asset);
-    LOGI("Corpus cargado: %zu ejemplos", corpus.size());
-    
-    return corpus;
+    session->index = loadIndexFromAssets(mgr, session->corpus);
+    LOGI("Sesión creada: corpus de %d ejemplos × %d armónicos, índice %s", 
+         session->corpus.rows(), session->corpus.dim(), indexKindName(session->index->kind()));
+    
+    // Hilo de clasificación en vivo (resultados → MainActivity.onLiveResult)
+    session->listener = env->NewGlobalRef(thiz);
+    session->onLiveResult = env->GetMethodID(env->GetObjectClass(thiz), "onLiveResult",
+                                             "(Ljava/lang/String;J)V");
+    session->liveWorker = make_unique<LatestWorker<StrokeJob>>(
+        [session](StrokeJob& job, uint64_t sequence) { deliverLiveResult(*session, job, sequence); });
+    
+    return reinterpret_cast<jlong>(session);
 }
 
-// conversión: Android Bitmap → OpenCV Mat
-
-Mat bitmapToMat(JNIEnv* env, jobject bitmap) {
-    AndroidBitmapInfo info;
-    void* pixels;
-    
-    AndroidBitmap_getInfo(env, bitmap, &info);
-    AndroidBitmap_lockPixels(env, bitmap, &pixels);
-    
-    Mat mat(info.height, info.width, CV_8UC4, pixels);
-    Mat result;
-    mat.copyTo(result);
+// jni: liberar sesión
+extern "C" JNIEXPORT void JNICALL
+Java_com_example_android_1app_MainActivity_releaseClassifier(
+        JNIEnv* env,
+        jobject /* this */,
+        jlong handle) {
     
-    AndroidBitmap_unlockPixels(env, bitmap);
+    auto* session = reinterpret_cast<ClassifierSession*>(handle);
+    if (session == nullptr) return;
     
-    return result;
-}
-
-// traducción a español
-
-string translateToSpanish(const string& label) {
-    if (label == "circle") return "Círculo";
-    if (label == "triangle") return "Triángulo";
-    if (label == "square") return "Cuadrado";
-    return label;
+    // Parar el hilo antes de soltar la referencia a la actividad que usa
+    session->liveWorker.reset();
+    env->DeleteGlobalRef(session->listener);
+    delete session;
 }
 
 // jni: función de clasificación
@@ -343,24 +328,25 @@ Java_com_example_android_1app_MainActivity_classifyImage(
         JNIEnv* env,
         jobject /* this */,
         jobject bitmap,
-        jobject assetManager) {
+        jlong handle) {
     
-    LOGI("========================================");
     LOGI("JNI: Iniciando clasificación");
-    LOGI("========================================");
-    
-    // Convertir Bitmap a Mat
-    Mat image = bitmapToMat(env, bitmap);
-    LOGI("Imagen recibida: %dx%d", image.cols, image.rows);
     
-    // Cargar corpus
-    AAssetManager* mgr = AAssetManager_fromJava(env, assetManager);
-    vector<ShapeDescriptor> corpus = loadCorpusFromAssets(mgr);
-    
-    if (corpus.empty()) {
+    auto* session = reinterpret_cast<ClassifierSession*>(handle);
+    if (session == nullptr || session->corpus.empty()) {
         return env->NewStringUTF("Error: Corpus vacío");
     }
     
+    // Convertir Bitmap a gris (sólo la región con tinta) y reducir
+    Mat cropped = bitmapToGray(env, bitmap);
+    if (cropped.empty()) {
+        return env->NewStringUTF("Error: Bitmap no válido");
+    }
+    Mat image;
+    downscaleToFit(cropped, image, MAX_IMAGE_SIDE);
+    LOGI("Imagen recibida: %dx%d (recorte), %dx%d (procesada)",
+         cropped.cols, cropped.rows, image.cols, image.rows);
+    
     // Extraer descriptor de la imagen
     ShapeDescriptor testDescriptor = extractShapeDescriptor(image);
     
@@ -368,12 +354,72 @@ Java_com_example_android_1app_MainActivity_classifyImage(
         return env->NewStringUTF("Error: No se pudo extraer descriptor");
     }
     
-    // Clasificar
-    auto [label, distance] = classify(testDescriptor, corpus);
+    // Clasificar contra el corpus ya cargado
+    auto [label, distance] = classify(testDescriptor, *session->index);
     
     // Traducir a español
     string result = translateToSpanish(label);
-    LOGI("Resultado final: %s", result.c_str());
+    LOGI("Resultado final: %s (distancia: %.4f)", result.c_str(), distance);
     
     return env->NewStringUTF(result.c_str());
-}
\ No newline at end of file
+}
+
+// jni: clasificación desde los trazos vectoriales (sin bitmap)
+
+/**
+ * `points` = x0, y0, x1, y1, ... de todos los trazos seguidos y
+ * `strokeLengths` los puntos de cada trazo (DrawingView los guarda al
+ * dibujar; sólo valen los primeros `numValues` y `numStrokes`). El contorno sale directamente de los trazos (strokesToContour):
+ * ni bitmap, ni umbral, ni findContours.
+ */
+extern "C" JNIEXPORT jstring JNICALL
+Java_com_example_android_1app_MainActivity_classifyStrokes(
+        JNIEnv* env,
+        jobject /* this */,
+        jfloatArray points,
+        jint numValues,
+        jintArray strokeLengths,
+        jint numStrokes,
+        jlong handle) {
+    
+    auto* session = reinterpret_cast<ClassifierSession*>(handle);
+    if (session == nullptr || session->corpus.empty()) {
+        return env->NewStringUTF("Error: Corpus vacío");
+    }
+    
+    StrokeJob job;
+    if (!readStrokes(env, points, numValues, strokeLengths, numStrokes, job)) {
+        return env->NewStringUTF("Error: Trazos no válidos");
+    }
+    
+    string result;
+    classifyStrokeJob(*session, job, result);
+    return env->NewStringUTF(result.c_str());
+}
+
+// jni: clasificación en vivo mientras se dibuja
+
+/**
+ * Copia los trazos y los deja en el buzón del hilo en vivo: no bloquea
+ * (se llama en cada ACTION_MOVE). Si el hilo aún no había empezado el
+ * envío anterior, éste lo sustituye. Devuelve el número de secuencia que
+ * acompañará al resultado en onLiveResult (0 si los trazos no son válidos).
+ */
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_example_android_1app_MainActivity_submitStrokes(
+        JNIEnv* env,
+        jobject /* this */,
+        jfloatArray points,
+        jint numValues,
+        jintArray strokeLengths,
+        jint numStrokes,
+        jlong handle) {
+    
+    auto* session = reinterpret_cast<ClassifierSession*>(handle);
+    if (session == nullptr || session->corpus.empty()) return 0;
+    
+    StrokeJob job;
+    if (!readStrokes(env, points, numValues, strokeLengths, numStrokes, job)) return 0;
+    
+    return static_cast<jlong>(session->liveWorker->submit(move(job)));
+}
@@ -16,6 +16,17 @@ class DrawingView(context: Context, attrs: AttributeSet) : View(context, attrs)
     private var mCanvasBitmap: Bitmap? = null
     private var drawCanvas: Canvas? = null
 
+    // Trazos en vectorial para classifyStrokes: x0, y0, x1, y1, ... y puntos por trazo.
+    // Arrays primitivos que crecen al doble; sólo son válidos los primeros
+    // mPointValues / mStrokeCount elementos (sin copiar en cada ACTION_MOVE)
+    private var mStrokePoints = FloatArray(1024)
+    private var mPointValues = 0
+    private var mStrokeLengths = IntArray(16)
+    private var mStrokeCount = 0
+
+    // Avisa de cada cambio en los trazos (clasificación en vivo mientras se dibuja)
+    var onStrokesChanged: (() -> Unit)? = null
+
     init {
         setupDrawing()
     }
@@ -51,9 +62,23 @@ class DrawingView(context: Context, attrs: AttributeSet) : View(context, attrs)
         when (event.action) {
             MotionEvent.ACTION_DOWN -> {
                 mDrawPath.moveTo(touchX, touchY)
+                if (mStrokeCount == mStrokeLengths.size) {
+                    mStrokeLengths = mStrokeLengths.copyOf(2 * mStrokeLengths.size)
+                }
+                mStrokeLengths[mStrokeCount++] = 0
+                addStrokePoint(touchX, touchY)
             }
             MotionEvent.ACTION_MOVE -> {
+                // Puntos intermedios agrupados por el sistema en este evento
+                for (i in 0 until event.historySize) {
+                    val x = event.getHistoricalX(i)
+                    val y = event.getHistoricalY(i)
+                    mDrawPath.lineTo(x, y)
+                    addStrokePoint(x, y)
+                }
                 mDrawPath.lineTo(touchX, touchY)
+                addStrokePoint(touchX, touchY)
+                onStrokesChanged?.invoke()
             }
             MotionEvent.ACTION_UP -> {
                 drawCanvas?.drawPath(mDrawPath, mDrawPaint)
@@ -65,12 +90,35 @@ class DrawingView(context: Context, attrs: AttributeSet) : View(context, attrs)
         return true
     }
 
+    private fun addStrokePoint(x: Float, y: Float) {
+        if (mPointValues + 2 > mStrokePoints.size) {
+            mStrokePoints = mStrokePoints.copyOf(2 * mStrokePoints.size)
+        }
+        mStrokePoints[mPointValues++] = x
+        mStrokePoints[mPointValues++] = y
+        mStrokeLengths[mStrokeCount - 1]++
+    }
+
     // Función pública para limpiar la pantalla
     fun clearCanvas() {
         drawCanvas?.drawColor(Color.WHITE)
+        mPointValues = 0
+        mStrokeCount = 0
         invalidate()
     }
 
+    fun hasStrokes(): Boolean = mStrokeCount > 0
+
+    // Trazos para C++ sin copia: coordenadas seguidas (válidas las primeras
+    // getStrokePointCount()) y puntos de cada trazo (válidos getStrokeCount())
+    fun getStrokePoints(): FloatArray = mStrokePoints
+
+    fun getStrokePointCount(): Int = mPointValues
+
+    fun getStrokeLengths(): IntArray = mStrokeLengths
+
+    fun getStrokeCount(): Int = mStrokeCount
+
     // Función para obtener el dibujo actual
     fun getBitmap(): Bitmap? {
         return mCanvasBitmap
@@ -10,24 +10,53 @@ class MainActivity : AppCompatActivity() {
 
     private lateinit var binding: ActivityMainBinding
 
+    // Sesión nativa con el corpus ya cargado (puntero C++ guardado como Long)
+    private var classifierHandle: Long = 0L
+
+    // Secuencia del último envío en vivo y del último borrado (sólo hilo de UI):
+    // los resultados de trazos anteriores al borrado se ignoran
+    private var lastLiveSequence: Long = 0L
+    private var clearedSequence: Long = 0L
+
     override fun onCreate(savedInstanceState: Bundle?) {
         super.onCreate(savedInstanceState)
 
         binding = ActivityMainBinding.inflate(layoutInflater)
         setContentView(binding.root)
 
+        // Cargar el corpus una sola vez
+        classifierHandle = initClassifier(assets)
+
+        // Clasificar en vivo mientras se dibuja: el envío no bloquea y el
+        // hilo nativo sólo procesa el más reciente (resultado en onLiveResult)
+        binding.drawingView.onStrokesChanged = {
+            val drawing = binding.drawingView
+            val sequence = submitStrokes(drawing.getStrokePoints(), drawing.getStrokePointCount(),
+                                         drawing.getStrokeLengths(), drawing.getStrokeCount(),
+                                         classifierHandle)
+            if (sequence > 0) lastLiveSequence = sequence
+        }
+
         // Configurar botón Borrar
         binding.btnClear.setOnClickListener {
+            clearedSequence = lastLiveSequence
             binding.drawingView.clearCanvas()
             binding.tvResult.text = "Lienzo limpio"
         }
 
-        // Configurar botón Clasificar
+        // Configurar botón Clasificar: con los trazos vectoriales si los hay
+        // (sin rasterizar); el bitmap queda como alternativa
         binding.btnClassify.setOnClickListener {
-            val bitmap = binding.drawingView.getBitmap()
-            if (bitmap != null) {
-                // Llamar a JNI con AssetManager
-                val result = classifyImage(bitmap, assets)
+            val drawing = binding.drawingView
+            val bitmap = drawing.getBitmap()
+            if (drawing.hasStrokes()) {
+                val result = classifyStrokes(drawing.getStrokePoints(), drawing.getStrokePointCount(),
+                                             drawing.getStrokeLengths(), drawing.getStrokeCount(),
+                                             classifierHandle)
+                binding.tvResult.text = "Resultado: $result"
+            } else if (bitmap != null) {
+                // Llamar a JNI con la sesión ya inicializada
+                val result = classifyImage(bitmap, classifierHandle)
                 binding.tvResult.text = "Resultado: $result"
             } else {
                 binding.tvResult.text = "Error: Lienzo vacío"
@@ -35,8 +64,30 @@ class MainActivity : AppCompatActivity() {
         }
 
     }
-    
-    external fun classifyImage(bitmap: Bitmap, assetManager: AssetManager): String
+
+    // Llamado desde el hilo nativo de clasificación en vivo
+    @Suppress("unused")
+    fun onLiveResult(result: String, sequence: Long) {
+        runOnUiThread {
+            if (sequence > clearedSequence) {
+                binding.tvResult.text = "En vivo: $result"
+            }
+        }
+    }
+
+    override fun onDestroy() {
+        releaseClassifier(classifierHandle)
+        classifierHandle = 0L
+        super.onDestroy()
+    }
+
+    external fun initClassifier(assetManager: AssetManager): Long
+    external fun releaseClassifier(handle: Long)
+    external fun classifyImage(bitmap: Bitmap, handle: Long): String
+    external fun classifyStrokes(points: FloatArray, numValues: Int, strokeLengths: IntArray,
+                                 numStrokes: Int, handle: Long): String
+    external fun submitStrokes(points: FloatArray, numValues: Int, strokeLengths: IntArray,
+                               numStrokes: Int, handle: Long): Long
 
     companion object {
         init {
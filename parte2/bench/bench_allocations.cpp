@@ -0,0 +1,121 @@
+/**
+ * Reservas de memoria por imagen en la extracción del descriptor.
+ *
+ * Este archivo reemplaza el operator new global de shape_bench para contar
+ * las reservas (un incremento atómico por llamada; el resto de benchmarks
+ * no se ve afectado de forma apreciable). Las reservas de OpenCV con
+ * fastMalloc (datos de los Mat) no pasan por aquí: para esas se comprueba
+ * que los búferes del ExtractionContext no cambian de dirección.
+ *
+ * Si algo de shape_core vuelve a reservar tras el calentamiento, el
+ * benchmark falla con failCheck y shape_bench termina con código distinto
+ * de 0. La garantía la fija tests/test_allocations.cpp (shape_tests).
+ */
+
+#include <benchmark/benchmark.h>
+#include <opencv2/core.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "bench_check.h"
+#include "contour_resample.h"
+#include "shape_pipeline.h"
+#include "synthetic_shapes.h"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+atomic<size_t> allocationCount{0};
+
+size_t allocations() {
+    return allocationCount.load(memory_order_relaxed);
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    if (void* ptr = malloc(size ? size : 1)) return ptr;
+    throw bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+namespace {
+
+const vector<int64_t> SHAPES = {SHAPE_CIRCLE, SHAPE_TRIANGLE, SHAPE_SQUARE};
+
+// Direcciones de los búferes del contexto: si cambian, el contexto se ha vuelto a reservar
+vector<const void*> bufferAddresses(const ExtractionContext& context) {
+    return {context.gray.data, context.binary.data, context.contour.data(),
+            context.cumulativeLength.data(), context.resampled.data(),
+            context.magnitudes.data(), context.features.data()};
+}
+
+/**
+ * Pasos 3-6 (computeDescriptor) con vectores reutilizados: cero reservas
+ * tras la primera llamada; es el código que depende sólo de shape_core.
+ */
+void BM_ComputeDescriptorAllocations(benchmark::State& state) {
+    vector<Point2f> resampled = resampleContour(makeShapeContour(state.range(0), 4096), NUM_POINTS);
+    vector<float> magnitudes, descriptor;
+    computeDescriptor(resampled, magnitudes, descriptor);   // calentamiento
+
+    size_t before = allocations();
+    for (auto _ : state) {
+        computeDescriptor(resampled, magnitudes, descriptor);
+        benchmark::DoNotOptimize(descriptor.data());
+    }
+    size_t count = allocations() - before;
+
+    state.counters["allocs_per_image"] = static_cast<double>(count) / state.iterations();
+    state.SetLabel(shapeName(state.range(0)));
+    if (count != 0) failCheck(state, "computeDescriptor reserva memoria tras el calentamiento");
+}
+
+/**
+ * Pipeline completo con un ExtractionContext reutilizado (range(2) = 1) o
+ * con uno nuevo por imagen (range(2) = 0, como antes del contexto).
+ * "allocs_per_image" cuenta todas las llamadas a operator new, incluidas
+ * las internas de OpenCV (motor de filtros, findContours); con el contexto
+ * reutilizado los búferes propios no pueden cambiar de dirección.
+ */
+void BM_ExtractionAllocations(benchmark::State& state) {
+    Mat image = makeShapeImage(state.range(0), state.range(1));
+    bool reuse = state.range(2) != 0;
+    ExtractionContext context;
+    extractShapeFeatures(image, context);   // calentamiento
+    vector<const void*> warm = bufferAddresses(context);
+
+    size_t before = allocations();
+    for (auto _ : state) {
+        if (reuse) {
+            benchmark::DoNotOptimize(extractShapeFeatures(image, context));
+        } else {
+            ExtractionContext fresh;
+            benchmark::DoNotOptimize(extractShapeFeatures(image, fresh));
+        }
+    }
+    size_t count = allocations() - before;
+
+    state.counters["allocs_per_image"] = static_cast<double>(count) / state.iterations();
+    state.SetLabel(string(shapeName(state.range(0))) + (reuse ? " context" : " fresh"));
+    if (reuse && bufferAddresses(context) != warm) {
+        failCheck(state, "el ExtractionContext se ha vuelto a reservar tras el calentamiento");
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_ComputeDescriptorAllocations)->ArgsProduct({SHAPES})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ExtractionAllocations)->ArgsProduct({SHAPES, {512, 2048}, {0, 1}})->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,23 @@
+/**
+ * Comprobaciones de corrección dentro de los benchmarks.
+ *
+ * failCheck marca el benchmark como erróneo (SkipWithError) y cuenta el
+ * fallo: shape_bench termina con código distinto de 0 si alguno falla.
+ * Para saltar un benchmark que no aplica (p. ej. un nivel SIMD que la CPU
+ * no tiene) se usa SkipWithError directamente, que no cuenta como fallo.
+ */
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+
+inline std::atomic<int>& benchmarkFailures() {
+    static std::atomic<int> failures{0};
+    return failures;
+}
+
+inline void failCheck(benchmark::State& state, const char* message) {
+    benchmarkFailures().fetch_add(1, std::memory_order_relaxed);
+    state.SkipWithError(message);
+}
@@ -0,0 +1,115 @@
+/**
+ * Latencia de una clasificación tal como la hace la app Android.
+ *
+ * - Reparse: el flujo anterior, que en cada llamada parseaba corpus.csv
+ *   (copia a string + stringstream + stof) a un vector<ShapeDescriptor> y
+ *   lo recorría entero. Se conserva aquí una copia de ese código: parseCorpus
+ *   y classify de shape_core ya no son los de entonces.
+ * - Cached: la sesión nativa (initClassifier) mantiene el corpus en un
+ *   DescriptorMatrix y cada llamada sólo extrae el descriptor y busca.
+ */
+
+#include <benchmark/benchmark.h>
+#include <opencv2/core.hpp>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "corpus_io.h"
+#include "descriptor_matrix.h"
+#include "shape_pipeline.h"
+#include "synthetic_shapes.h"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+// Texto CSV equivalente al asset corpus.csv, con `rows` filas
+string makeCorpusCsv(int rows) {
+    ostringstream csv;
+    for (const auto& desc : makeSyntheticCorpus(rows)) {
+        csv << desc.label;
+        for (float f : desc.features) csv << "," << f;
+        csv << "\n";
+    }
+    return csv.str();
+}
+
+// Implementación anterior de loadCorpusFromAssets (sin AAsset ni logs), como referencia
+vector<ShapeDescriptor> parseCorpusLegacy(const char* buffer, size_t fileSize) {
+    vector<ShapeDescriptor> corpus;
+    
+    stringstream ss(string(buffer, fileSize));
+    string line;
+    
+    while (getline(ss, line)) {
+        stringstream lineStream(line);
+        string label;
+        getline(lineStream, label, ',');
+        
+        vector<float> features;
+        string value;
+        while (getline(lineStream, value, ',')) {
+            features.push_back(stof(value));
+        }
+        
+        corpus.push_back(ShapeDescriptor(features, label));
+    }
+    
+    return corpus;
+}
+
+// Implementación anterior de classify sobre vector<ShapeDescriptor> (sin logs)
+pair<string, float> classifyLegacy(const ShapeDescriptor& testDescriptor,
+                                   const vector<ShapeDescriptor>& corpus) {
+    string bestLabel = "unknown";
+    float minDistance = 1e9;
+    
+    for (const auto& train : corpus) {
+        float dist = 1e9;
+        if (testDescriptor.features.size() == train.features.size()) {
+            float sum = 0.0f;
+            for (size_t i = 0; i < train.features.size(); i++) {
+                float diff = testDescriptor.features[i] - train.features[i];
+                sum += diff * diff;
+            }
+            dist = sqrt(sum);
+        }
+        
+        if (dist < minDistance) {
+            minDistance = dist;
+            bestLabel = train.label;
+        }
+    }
+    
+    return {bestLabel, minDistance};
+}
+
+void BM_ClassifyReparseCorpus(benchmark::State& state) {
+    string csv = makeCorpusCsv(state.range(0));
+    Mat image = makeShapeImage(SHAPE_TRIANGLE, 512);
+    for (auto _ : state) {
+        vector<ShapeDescriptor> corpus = parseCorpusLegacy(csv.data(), csv.size());
+        ShapeDescriptor desc = extractShapeDescriptor(image);
+        benchmark::DoNotOptimize(classifyLegacy(desc, corpus));
+    }
+}
+
+void BM_ClassifyCachedCorpus(benchmark::State& state) {
+    string csv = makeCorpusCsv(state.range(0));
+    DescriptorMatrix corpus = parseCorpus(csv.data(), csv.size());
+    Mat image = makeShapeImage(SHAPE_TRIANGLE, 512);
+    for (auto _ : state) {
+        ShapeDescriptor desc = extractShapeDescriptor(image);
+        benchmark::DoNotOptimize(classify(desc, corpus));
+    }
+}
+
+}  // namespace
+
+// 80 filas = corpus.csv actual de la app
+BENCHMARK(BM_ClassifyReparseCorpus)->Arg(80)->Arg(10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ClassifyCachedCorpus)->Arg(80)->Arg(10000)->Unit(benchmark::kMicrosecond);
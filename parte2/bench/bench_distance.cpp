@@ -0,0 +1,122 @@
+/**
+ * Micro-benchmark del vecino más cercano sobre el corpus contiguo.
+ *
+ * Compara los kernels de distancia al cuadrado (escalar, AVX2, AVX-512,
+ * NEON) con corpus aleatorios de 1k, 100k y 10M filas. A 10M filas el
+ * corpus ocupa ~640 MB y la consulta queda limitada por el ancho de banda
+ * de memoria; a 1k cabe en L1/L2 y se mide el kernel en sí.
+ *
+ * Los niveles que la CPU no soporta se marcan como omitidos.
+ *
+ * BM_ClassifyBatch clasifica 1000 consultas de una vez con classifyBatch
+ * (SGEMM por bloques + top-k) frente a BM_ClassifyPerQuery, que hace las
+ * mismas 1000 consultas una a una con nearestNeighbor.
+ *
+ * BM_QuantizedSearch repite la búsqueda sobre el corpus float16 / int8
+ * (kernels que decuantizan al vuelo + reordenación en float); el contador
+ * "agree" es la fracción de consultas con el mismo vecino que en float.
+ */
+
+#include <benchmark/benchmark.h>
+#include <map>
+
+#include "descriptor_matrix.h"
+#include "distance_kernels.h"
+#include "knn_batch.h"
+#include "quantized_corpus.h"
+#include "synthetic_shapes.h"
+
+namespace {
+
+// Los corpus grandes tardan en generarse: uno por tamaño para todo el proceso
+const DescriptorMatrix& cachedMatrix(int rows) {
+    static std::map<int, DescriptorMatrix> matrices;
+    auto it = matrices.find(rows);
+    if (it == matrices.end()) {
+        it = matrices.emplace(rows, makeSyntheticMatrix(rows)).first;
+    }
+    return it->second;
+}
+
+void BM_NearestNeighbor(benchmark::State& state) {
+    SimdLevel level = static_cast<SimdLevel>(state.range(0));
+    SquaredDistancesFn kernel = squaredDistancesKernel(level);
+    state.SetLabel(simdLevelName(level));
+    if (!kernel) {
+        state.SkipWithError("nivel SIMD no soportado en esta CPU");
+        return;
+    }
+    
+    const DescriptorMatrix& corpus = cachedMatrix(state.range(1));
+    DescriptorMatrix queries = makeSyntheticMatrix(16, 7);
+    
+    int q = 0;
+    float distance = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(nearestNeighbor(queries.row(q), corpus, &distance, kernel));
+        q = (q + 1) % queries.rows();
+    }
+    state.SetItemsProcessed(state.iterations() * corpus.rows());
+    state.SetBytesProcessed(state.iterations() * corpus.rows() * corpus.stride() * sizeof(float));
+}
+
+void nearestNeighborArgs(benchmark::internal::Benchmark* b) {
+    for (int level : {0, 1, 2, 3}) {
+        for (int rows : {1000, 100000, 10000000}) {
+            b->Args({level, rows});
+        }
+    }
+}
+
+void BM_ClassifyBatch(benchmark::State& state) {
+    const DescriptorMatrix& corpus = cachedMatrix(state.range(0));
+    DescriptorMatrix queries = makeSyntheticMatrix(1000, 7);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(classifyBatch(queries, corpus, state.range(1)));
+    }
+    state.SetItemsProcessed(state.iterations() * queries.rows());
+}
+
+void BM_ClassifyPerQuery(benchmark::State& state) {
+    const DescriptorMatrix& corpus = cachedMatrix(state.range(0));
+    DescriptorMatrix queries = makeSyntheticMatrix(1000, 7);
+    float distance = 0;
+    for (auto _ : state) {
+        for (int q = 0; q < queries.rows(); q++) {
+            benchmark::DoNotOptimize(nearestNeighbor(queries.row(q), corpus, &distance));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * queries.rows());
+}
+
+void BM_QuantizedSearch(benchmark::State& state) {
+    Quantization quantization = static_cast<Quantization>(state.range(0));
+    const DescriptorMatrix& corpus = cachedMatrix(state.range(1));
+    QuantizedCorpus quantized = QuantizedCorpus::build(corpus, quantization);
+    DescriptorMatrix queries = makeSyntheticMatrix(16, 7);
+    state.SetLabel(quantizationName(quantization));
+    
+    int agree = 0;
+    for (int q = 0; q < queries.rows(); q++) {
+        agree += quantized.search(queries.row(q), nullptr) == nearestNeighbor(queries.row(q), corpus, nullptr);
+    }
+    
+    int q = 0;
+    float distance = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(quantized.search(queries.row(q), &distance));
+        q = (q + 1) % queries.rows();
+    }
+    state.SetItemsProcessed(state.iterations() * corpus.rows());
+    state.counters["agree"] = static_cast<double>(agree) / queries.rows();
+    state.counters["bytes_per_row"] =
+        static_cast<double>(quantized.memoryBytes()) / corpus.rows();
+}
+
+}  // namespace
+
+BENCHMARK(BM_QuantizedSearch)->ArgsProduct({{0, 1}, {1000, 100000, 10000000}})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ClassifyBatch)->ArgsProduct({{1000, 100000}, {1, 10}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ClassifyPerQuery)->Arg(1000)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_NearestNeighbor)->Apply(nearestNeighborArgs)->Unit(benchmark::kMicrosecond);
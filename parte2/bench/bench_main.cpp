@@ -0,0 +1,20 @@
+/**
+ * Punto de entrada de shape_bench. Igual que benchmark_main, pero silencia
+ * los logs de shape_core para que la E/S no distorsione las medidas, y
+ * termina con 1 si alguna comprobación (failCheck) ha fallado.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "bench_check.h"
+#include "shape_log.h"
+
+int main(int argc, char** argv) {
+    setLogSink(nullptr);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return benchmarkFailures().load() > 0 ? 1 : 0;
+}
@@ -0,0 +1,571 @@
+/**
+ * Benchmarks por etapa de extractShapeDescriptor + classify.
+ *
+ * Entradas sintéticas (synthetic_shapes.h):
+ * - imágenes de círculo/triángulo/cuadrado a varias resoluciones
+ * - contornos de 256 a 16k puntos
+ * - corpus aleatorios de 80 (el corpus.csv real) a 100k filas
+ *
+ * Salida JSON para seguir regresiones:
+ *   ./shape_bench --benchmark_out=bench.json --benchmark_out_format=json
+ */
+
+#include <benchmark/benchmark.h>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <vector>
+
+#include "bench_check.h"
+#include "contour_resample.h"
+#include "descriptor_matrix.h"
+#include "hu_descriptor.h"
+#include "ink_crop.h"
+#include "rgba_gray.h"
+#include "roi_tracker.h"
+#include "shape_pipeline.h"
+#include "spectrum.h"
+#include "stroke_contour.h"
+#include "synthetic_shapes.h"
+#include "thread_pool.h"
+#include "zernike_descriptor.h"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+// Resoluciones de imagen y longitudes de contorno a probar
+const vector<int64_t> SHAPES = {SHAPE_CIRCLE, SHAPE_TRIANGLE, SHAPE_SQUARE};
+const vector<int64_t> RESOLUTIONS = {256, 512, 1024, 2048};
+const vector<int64_t> CONTOUR_LENGTHS = {256, 1024, 4096, 16384};
+
+// Contorno remuestreado de una forma sintética; `traced` = orientación de findContours
+vector<Point2f> makeResampledContour(int shape, bool traced = false) {
+    return resampleContour(traced ? makeTracedContour(shape, 4096) : makeShapeContour(shape, 4096),
+                           NUM_POINTS);
+}
+
+// Señal compleja lista para la DFT a partir de una forma sintética
+Mat makeComplexSignal(int shape, bool traced = false) {
+    vector<Point2f> interpolated = makeResampledContour(shape, traced);
+    return buildComplexSignal(interpolated, calculateCentroid(interpolated));
+}
+
+void BM_Binarize(benchmark::State& state) {
+    Mat image = makeShapeImage(state.range(0), state.range(1));
+    Mat binary;
+    for (auto _ : state) {
+        binarizeImage(image, binary);
+        benchmark::DoNotOptimize(binary.data);
+    }
+    state.SetLabel(shapeName(state.range(0)));
+    state.SetItemsProcessed(state.iterations() * image.total());
+}
+
+void BM_FindContours(benchmark::State& state) {
+    Mat image = makeShapeImage(state.range(0), state.range(1));
+    Mat binary, work;
+    binarizeImage(image, binary);
+    vector<Point> contour;
+    for (auto _ : state) {
+        binary.copyTo(work);   // findContours puede modificar la imagen
+        benchmark::DoNotOptimize(findLargestContour(work, contour));
+    }
+    state.SetLabel(shapeName(state.range(0)));
+    state.SetItemsProcessed(state.iterations() * image.total());
+}
+
+void BM_Resample(benchmark::State& state) {
+    vector<Point> contour = makeShapeContour(state.range(0), state.range(1));
+    vector<Point2f> interpolated;
+    vector<float> cumulativeLength;
+    for (auto _ : state) {
+        resampleContour(contour, NUM_POINTS, interpolated, cumulativeLength);
+        benchmark::DoNotOptimize(interpolated.data());
+    }
+    state.SetLabel(shapeName(state.range(0)));
+    state.SetItemsProcessed(state.iterations() * contour.size());
+}
+
+void BM_ComplexSignal(benchmark::State& state) {
+    vector<Point2f> interpolated = resampleContour(makeShapeContour(state.range(0), 4096), NUM_POINTS);
+    for (auto _ : state) {
+        Point2f centroid = calculateCentroid(interpolated);
+        Mat signal = buildComplexSignal(interpolated, centroid);
+        benchmark::DoNotOptimize(signal.data);
+    }
+    state.SetLabel(shapeName(state.range(0)));
+}
+
+void BM_DFT(benchmark::State& state) {
+    Mat signal = makeComplexSignal(state.range(0));
+    vector<float> magnitudes;
+    for (auto _ : state) {
+        computeFFT(signal, magnitudes);
+        benchmark::DoNotOptimize(magnitudes.data());
+    }
+    state.SetLabel(shapeName(state.range(0)));
+}
+
+/**
+ * Motor de espectro (computeHarmonics) frente a BM_DFT (cv::dft completa):
+ * mismo PASO 5 pero sólo F[0]..F[bins-1]. range(2) = 1 usa el contorno en
+ * la orientación de findContours (makeTracedContour, |F[1]| pequeño).
+ * "max_error" es la mayor diferencia del descriptor normalizado frente al
+ * de cv::dft; falla si supera descriptorTolerance (1e-5 · ‖F‖₂ / |F[1]|).
+ */
+void BM_Harmonics(benchmark::State& state) {
+    bool traced = state.range(2) != 0;
+    vector<Point2f> interpolated = makeResampledContour(state.range(0), traced);
+    Mat signal = buildComplexSignal(interpolated, calculateCentroid(interpolated));
+    int bins = state.range(1);
+    vector<float> magnitudes, reference;
+    for (auto _ : state) {
+        computeHarmonics(signal, magnitudes, bins);
+        benchmark::DoNotOptimize(magnitudes.data());
+    }
+    
+    computeFFT(signal, reference);
+    vector<float> expected = normalizeDescriptor(reference);
+    vector<float> actual = normalizeDescriptor(magnitudes);
+    double maxError = 0;
+    for (size_t k = 0; k < expected.size(); k++) {
+        maxError = max(maxError, static_cast<double>(fabs(expected[k] - actual[k])));
+    }
+    double tolerance = descriptorTolerance(interpolated);
+    state.counters["max_error"] = maxError;
+    state.counters["tolerance"] = tolerance;
+    state.SetLabel(string(shapeName(state.range(0))) + (traced ? " traced" : ""));
+
+    if (maxError > tolerance) failCheck(state, "computeHarmonics no coincide con cv::dft");
+}
+
+// FFT radix-4 de 1024 puntos completa (el camino de spectrumMagnitudes con muchos coeficientes)
+void BM_FFT1024(benchmark::State& state) {
+    Mat signal = makeComplexSignal(state.range(0));
+    vector<float> re(SPECTRUM_POINTS), im(SPECTRUM_POINTS), outRe(SPECTRUM_POINTS), outIm(SPECTRUM_POINTS);
+    for (int n = 0; n < SPECTRUM_POINTS; n++) {
+        re[n] = signal.at<Vec2f>(n, 0)[0];
+        im[n] = signal.at<Vec2f>(n, 0)[1];
+    }
+    for (auto _ : state) {
+        fft1024(re.data(), im.data(), outRe.data(), outIm.data());
+        benchmark::DoNotOptimize(outRe.data());
+    }
+    state.SetLabel(shapeName(state.range(0)));
+}
+
+/**
+ * N contornos remuestreados (círculo, triángulo, cuadrado, ... con tamaños
+ * distintos); los impares en la orientación de findContours
+ * (makeTracedContour), donde caen los descriptores del corpus real.
+ */
+vector<vector<Point2f>> makeContourBatch(int count) {
+    vector<vector<Point2f>> contours(count);
+    for (int i = 0; i < count; i++) {
+        int shape = SHAPES[i % SHAPES.size()];
+        int points = 1024 + 37 * i;
+        contours[i] = resampleContour(i % 2 ? makeTracedContour(shape, points) : makeShapeContour(shape, points),
+                                      NUM_POINTS);
+    }
+    return contours;
+}
+
+/**
+ * Pasos 3-6 contorno a contorno, como antes de computeDescriptorBatch:
+ * Mat de señal + DFT + vector normalizado por imagen. range(1) elige el
+ * PASO 5: 0 = cv::dft completa (computeFFT), 1 = computeHarmonics.
+ */
+void BM_DescriptorPerContour(benchmark::State& state) {
+    vector<vector<Point2f>> contours = makeContourBatch(state.range(0));
+    bool harmonics = state.range(1) != 0;
+    vector<float> magnitudes;
+    for (auto _ : state) {
+        for (const auto& contour : contours) {
+            Mat signal = buildComplexSignal(contour, calculateCentroid(contour));
+            if (harmonics) {
+                computeHarmonics(signal, magnitudes);
+            } else {
+                computeFFT(signal, magnitudes);
+            }
+            benchmark::DoNotOptimize(normalizeDescriptor(magnitudes));
+        }
+    }
+    state.SetLabel(harmonics ? "harmonics" : "dft");
+    state.SetItemsProcessed(state.iterations() * contours.size());
+}
+
+/**
+ * Los mismos contornos con computeDescriptorBatch (un carril SIMD por
+ * contorno). "max_error" frente al descriptor de cv::dft; falla si algún
+ * contorno supera su descriptorTolerance (1e-5 · ‖F‖₂ / |F[1]|) o si alguna
+ * fila sale a ceros (un contorno que se saltó).
+ */
+void BM_DescriptorBatch(benchmark::State& state) {
+    vector<vector<Point2f>> contours = makeContourBatch(state.range(0));
+    Mat descriptors;
+    for (auto _ : state) {
+        descriptors = computeDescriptorBatch(contours);
+        benchmark::DoNotOptimize(descriptors.data);
+    }
+    
+    double maxError = 0;
+    bool zeroRow = false, withinTolerance = true;
+    vector<float> reference;
+    for (size_t i = 0; i < contours.size(); i++) {
+        computeFFT(buildComplexSignal(contours[i], calculateCentroid(contours[i])), reference);
+        vector<float> expected = normalizeDescriptor(reference);
+        zeroRow = zeroRow || countNonZero(descriptors.row(i)) == 0;
+        double tolerance = descriptorTolerance(contours[i]);
+        for (int k = 0; k < NUM_HARMONICS; k++) {
+            double error = fabs(expected[k] - descriptors.at<float>(i, k));
+            maxError = max(maxError, error);
+            withinTolerance = withinTolerance && error <= tolerance;
+        }
+    }
+    state.counters["max_error"] = maxError;
+    state.SetItemsProcessed(state.iterations() * contours.size());
+
+    if (zeroRow) failCheck(state, "computeDescriptorBatch devolvió una fila a ceros");
+    else if (!withinTolerance) failCheck(state, "computeDescriptorBatch no coincide con cv::dft");
+}
+
+/**
+ * Modo multiobjeto (extractShapeObjects) sobre una hoja de range(0)×range(0)
+ * formas de 128 px con range(1) hilos. Falla si no sale un objeto con
+ * descriptor por forma.
+ */
+void BM_ShapeObjects(benchmark::State& state) {
+    const int grid = static_cast<int>(state.range(0));
+    const unsigned jobs = static_cast<unsigned>(state.range(1));
+    Mat sheet = makeShapeSheet(grid, 128);
+    ThreadPool pool(jobs);
+    
+    vector<ShapeObject> objects;
+    for (auto _ : state) {
+        objects = extractShapeObjects(sheet, MIN_OBJECT_AREA, jobs > 1 ? &pool : nullptr);
+        benchmark::DoNotOptimize(objects.data());
+    }
+    
+    size_t valid = 0;
+    for (const ShapeObject& object : objects) valid += !object.features.empty();
+    state.counters["objects_per_s"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * objects.size()), benchmark::Counter::kIsRate);
+    state.SetLabel(to_string(jobs) + " hilos");
+    if (valid != static_cast<size_t>(grid * grid)) {
+        failCheck(state, "no se ha extraído un objeto con descriptor por forma");
+    }
+}
+
+/**
+ * Secuencia sintética de 60 fotogramas 1280×720 con 6 formas en movimiento
+ * (makeMovingFrame): range(0) = 0 → extractShapeObjects en cada fotograma
+ * completo; 1 → RoiTracker (barrido completo cada TRACK_RESCAN_INTERVAL).
+ * "pixel_pct" = píxeles binarizados frente al fotograma completo. Falla si
+ * algún fotograma no tiene las 6 formas con descriptor.
+ */
+void BM_RoiTracking(benchmark::State& state) {
+    const int FRAMES = 60, OBJECTS = 6;
+    bool tracking = state.range(0) != 0;
+    vector<Mat> frames;
+    for (int f = 0; f < FRAMES; f++) frames.push_back(makeMovingFrame(f, OBJECTS, 1280, 720));
+    
+    size_t pixels = 0, total = 0;
+    bool complete = true;
+    for (auto _ : state) {
+        RoiTracker tracker;
+        for (const Mat& frame : frames) {
+            size_t found = 0;
+            if (tracking) {
+                TrackingStats stats;
+                for (const TrackedObject& object : tracker.update(frame, &stats)) {
+                    found += !object.features.empty();
+                }
+                pixels += stats.pixels;
+            } else {
+                for (const ShapeObject& object : extractShapeObjects(frame)) {
+                    found += !object.features.empty();
+                }
+                pixels += frame.total();
+            }
+            total += frame.total();
+            complete = complete && found == static_cast<size_t>(OBJECTS);
+        }
+    }
+    
+    state.SetItemsProcessed(state.iterations() * FRAMES);
+    state.counters["pixel_pct"] = total > 0 ? 100.0 * pixels / total : 0.0;
+    state.SetLabel(tracking ? "roi" : "full");
+    if (!complete) failCheck(state, "algún fotograma no tiene todas las formas");
+}
+
+/**
+ * Momentos de la imagen binaria de Hu: binaryMoments (una pasada por
+ * bloques, range(1) = 1) frente a cv::moments (range(1) = 0). Falla si
+ * algún momento difiere de cv::moments en más de 1e-9 relativo.
+ */
+void BM_BinaryMoments(benchmark::State& state) {
+    Mat gray, binary;
+    binarizeOtsu(makeShapeImage(SHAPE_TRIANGLE, state.range(0)), binary, gray);
+    bool blocks = state.range(1) != 0;
+    
+    Moments result;
+    for (auto _ : state) {
+        result = blocks ? binaryMoments(binary) : moments(binary);
+        benchmark::DoNotOptimize(result.m00);
+    }
+    
+    Moments reference = moments(binary);
+    const double got[] = {result.m00, result.m10, result.m01, result.m20, result.m11,
+                          result.m02, result.m30, result.m21, result.m12, result.m03};
+    const double expected[] = {reference.m00, reference.m10, reference.m01, reference.m20,
+                               reference.m11, reference.m02, reference.m30, reference.m21,
+                               reference.m12, reference.m03};
+    double maxError = 0;
+    for (int i = 0; i < 10; i++) {
+        maxError = max(maxError, fabs(got[i] - expected[i]) / max(1.0, fabs(expected[i])));
+    }
+    
+    state.counters["max_rel_error"] = maxError;
+    state.SetBytesProcessed(state.iterations() * binary.total());
+    state.SetLabel(blocks ? "binaryMoments" : "cv::moments");
+    if (maxError > 1e-9) failCheck(state, "binaryMoments no coincide con cv::moments");
+}
+
+/**
+ * Momentos de Zernike de un lote de range(0) imágenes de 512 px:
+ * algoritmo de mahotas píxel a píxel (range(1) = 0, zernikeMomentsDirect)
+ * frente a rejilla fija + un solo producto de matrices con la base en
+ * caché (range(1) = 1, extractZernikeDescriptorBatch). Los dos incluyen
+ * Otsu y la ROI. Falla si algún |Z_nl| del lote difiere del de la
+ * referencia en más de 0.02 (los momentos van de 0 a ~0.6).
+ */
+void BM_ZernikeBatch(benchmark::State& state) {
+    const int count = static_cast<int>(state.range(0));
+    const bool gemm = state.range(1) != 0;
+    const int shapes[] = {SHAPE_CIRCLE, SHAPE_TRIANGLE, SHAPE_SQUARE};
+    vector<Mat> images;
+    for (int i = 0; i < count; i++) images.push_back(makeShapeImage(shapes[i % 3], 512));
+    vector<string> names(count);
+    
+    ExtractionContext context;
+    zernikeBasis();     // la base se calcula una vez, fuera de la medida
+    Mat direct(count, NUM_ZERNIKE_MOMENTS, CV_32F, Scalar(0));
+    vector<ShapeDescriptor> batch;
+    
+    auto runDirect = [&] {
+        for (int i = 0; i < count; i++) {
+            Rect roi;
+            if (!findZernikeRoi(images[i], context, roi)) continue;
+            zernikeMomentsDirect(context.binary(roi), max(roi.width, roi.height) / 2.0,
+                                 ZERNIKE_DEGREE, direct.ptr<float>(i));
+        }
+    };
+    
+    for (auto _ : state) {
+        if (gemm) {
+            batch = extractZernikeDescriptorBatch(images, names, names, context);
+            benchmark::DoNotOptimize(batch.data());
+        } else {
+            runDirect();
+            benchmark::DoNotOptimize(direct.data);
+        }
+    }
+    
+    if (gemm) runDirect();
+    else batch = extractZernikeDescriptorBatch(images, names, names, context);
+    double maxError = 0;
+    bool complete = true;
+    for (int i = 0; i < count; i++) {
+        if (batch[i].features.size() != static_cast<size_t>(NUM_ZERNIKE_MOMENTS)) {
+            complete = false;
+            continue;
+        }
+        for (int k = 0; k < NUM_ZERNIKE_MOMENTS; k++) {
+            maxError = max(maxError, static_cast<double>(fabs(batch[i].features[k] - direct.at<float>(i, k))));
+        }
+    }
+    
+    state.counters["max_error"] = maxError;
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetLabel(gemm ? "rejilla + gemm" : "mahotas (directo)");
+    if (!complete) failCheck(state, "imágenes sin descriptor de Zernike");
+    else if (maxError > 0.02) failCheck(state, "los momentos de la rejilla no coinciden con la referencia");
+}
+
+/**
+ * Pipeline completo por imagen con cada descriptor (range(0): 0 = fft,
+ * 1 = hu, 2 = zernike) a varias resoluciones, en imágenes/s.
+ */
+void BM_DescriptorThroughput(benchmark::State& state) {
+    const DescriptorKind kinds[] = {DescriptorKind::Fft, DescriptorKind::Hu, DescriptorKind::Zernike};
+    DescriptorKind kind = kinds[state.range(0)];
+    Mat image = makeShapeImage(SHAPE_SQUARE, state.range(1));
+    for (auto _ : state) {
+        ShapeDescriptor descriptor = extractDescriptor(kind, image);
+        benchmark::DoNotOptimize(descriptor.features.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(descriptorKindName(kind));
+}
+
+void BM_Normalize(benchmark::State& state) {
+    vector<float> magnitudes;
+    computeFFT(makeComplexSignal(state.range(0)), magnitudes);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(normalizeDescriptor(magnitudes));
+    }
+    state.SetLabel(shapeName(state.range(0)));
+}
+
+void BM_Classify(benchmark::State& state) {
+    DescriptorMatrix corpus = DescriptorMatrix::fromDescriptors(makeSyntheticCorpus(state.range(0)));
+    ShapeDescriptor query = makeSyntheticCorpus(1, 7)[0];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(classify(query, corpus));
+    }
+    state.SetItemsProcessed(state.iterations() * corpus.rows());
+}
+
+void BM_ExtractShapeDescriptor(benchmark::State& state) {
+    Mat image = makeShapeImage(state.range(0), state.range(1));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(extractShapeDescriptor(image));
+    }
+    state.SetLabel(shapeName(state.range(0)));
+}
+
+// Diferencia admitida entre el descriptor del recorte y el de la imagen completa
+const double CROP_TOLERANCE = 1e-4;
+
+/**
+ * Clasificación de un lienzo 1080×2000 de la app, desde el bitmap:
+ * range(1) = 0: imagen completa; 1: recorte a la tinta (inkRegion, con su
+ * coste incluido); 2: recorte + downscaleToFit(512). "pixels" son los
+ * píxeles que recorren los filtros del paso 1. La diferencia del descriptor
+ * frente al de la imagen completa sale en "max_error" (modos 0-1; con
+ * INK_MARGIN el recorte binariza igual, así que falla si supera
+ * CROP_TOLERANCE) o en "downscale_error" (modo 2, sólo informativa). Falla
+ * en cualquier modo si no sale un descriptor completo.
+ */
+void BM_CanvasExtraction(benchmark::State& state) {
+    Mat canvas = makeCanvasImage(state.range(0), 1080, 2000);
+    int mode = state.range(1);
+    
+    auto extract = [&](ShapeDescriptor& desc, int& pixels) {
+        Mat image = canvas, scaled;
+        if (mode >= 1) image = canvas(inkRegion(canvas));
+        if (mode == 2) {
+            downscaleToFit(image, scaled, 512);
+            image = scaled;
+        }
+        pixels = image.cols * image.rows;
+        desc = extractShapeDescriptor(image);
+    };
+    
+    ShapeDescriptor desc;
+    int pixels = 0;
+    for (auto _ : state) {
+        extract(desc, pixels);
+        benchmark::DoNotOptimize(desc.features.data());
+    }
+    
+    static const char* modes[] = {"full", "crop", "crop+pyrDown"};
+    state.SetLabel(string(shapeName(state.range(0))) + " " + modes[mode]);
+    state.counters["pixels"] = pixels;
+    
+    ShapeDescriptor full = extractShapeDescriptor(canvas);
+    if (full.features.empty() || desc.features.size() != full.features.size()) {
+        failCheck(state, "el recorte no extrae el mismo descriptor que la imagen completa");
+        return;
+    }
+    double maxError = 0;
+    for (size_t k = 0; k < full.features.size(); k++) {
+        maxError = max(maxError, static_cast<double>(fabs(full.features[k] - desc.features[k])));
+    }
+    if (mode == 2) {
+        state.counters["downscale_error"] = maxError;
+    } else {
+        state.counters["max_error"] = maxError;
+        if (maxError > CROP_TOLERANCE) failCheck(state, "el descriptor del recorte difiere del de la imagen completa");
+    }
+}
+
+/**
+ * La misma forma que BM_CanvasExtraction pero desde el trazo vectorial
+ * (strokesToContour + extractContourDescriptor): sin trabajo por píxel.
+ * "distance" es la distancia euclídea al descriptor del lienzo rasterizado
+ * (línea central del trazo frente al borde exterior del trazo grueso).
+ */
+void BM_StrokeExtraction(benchmark::State& state) {
+    vector<float> xy = makeShapeStroke(state.range(0), 1080, 2000);
+    int strokeLength = xy.size() / 2;
+    vector<Point> contour;
+    ShapeDescriptor desc;
+    for (auto _ : state) {
+        strokesToContour(xy.data(), static_cast<int>(xy.size()), &strokeLength, 1, contour);
+        desc = extractContourDescriptor(contour);
+        benchmark::DoNotOptimize(desc.features.data());
+    }
+    
+    ShapeDescriptor raster = extractShapeDescriptor(makeCanvasImage(state.range(0), 1080, 2000));
+    state.counters["distance"] = euclideanDistance(desc.features, raster.features);
+    state.counters["points"] = strokeLength;
+    state.SetLabel(shapeName(state.range(0)));
+}
+
+void BM_InkBounds(benchmark::State& state) {
+    Mat canvas = makeCanvasImage(state.range(0), 1080, 2000);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(findInkBounds(canvas));
+    }
+    state.SetLabel(shapeName(state.range(0)));
+    state.SetBytesProcessed(state.iterations() * canvas.total() * canvas.elemSize());
+}
+
+/**
+ * Bitmap RGBA → gris como en la JNI. range(0) = 0: el camino anterior
+ * (copyTo del bitmap + cvtColor de 4 canales); 1: rgbaToGray en una pasada.
+ * La igualdad con cvtColor(COLOR_RGBA2GRAY) la comprueba test_rgba_gray.cpp.
+ */
+void BM_RgbaToGray(benchmark::State& state) {
+    Mat canvas = makeCanvasImage(SHAPE_CIRCLE, 1080, 2000);
+    bool fused = state.range(0) != 0;
+    Mat copy, gray;
+    for (auto _ : state) {
+        if (fused) {
+            rgbaToGray(canvas, gray);
+        } else {
+            canvas.copyTo(copy);
+            cvtColor(copy, gray, COLOR_BGR2GRAY);
+        }
+        benchmark::DoNotOptimize(gray.data);
+    }
+    
+    state.SetLabel(fused ? "rgbaToGray" : "copyTo+cvtColor");
+    state.SetBytesProcessed(state.iterations() * canvas.total() * canvas.elemSize());
+}
+
+}  // namespace
+
+BENCHMARK(BM_Binarize)->ArgsProduct({SHAPES, RESOLUTIONS})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FindContours)->ArgsProduct({SHAPES, RESOLUTIONS})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Resample)->ArgsProduct({SHAPES, CONTOUR_LENGTHS})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ComplexSignal)->ArgsProduct({SHAPES})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DFT)->ArgsProduct({SHAPES})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Harmonics)->ArgsProduct({SHAPES, {NUM_HARMONICS + 1, 64}, {0, 1}})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FFT1024)->ArgsProduct({SHAPES})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DescriptorPerContour)->ArgsProduct({{8, 256}, {0, 1}})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DescriptorBatch)->Arg(8)->Arg(256)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ShapeObjects)->ArgsProduct({{4, 16}, {1, 4}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_RoiTracking)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BinaryMoments)->ArgsProduct({RESOLUTIONS, {0, 1}})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ZernikeBatch)->ArgsProduct({{1, 32}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DescriptorThroughput)->ArgsProduct({{0, 1, 2}, RESOLUTIONS})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Normalize)->ArgsProduct({SHAPES})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Classify)->Arg(80)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ExtractShapeDescriptor)->ArgsProduct({SHAPES, RESOLUTIONS})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CanvasExtraction)->ArgsProduct({SHAPES, {0, 1, 2}})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StrokeExtraction)->ArgsProduct({SHAPES})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_InkBounds)->ArgsProduct({SHAPES})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_RgbaToGray)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
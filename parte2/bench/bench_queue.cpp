@@ -0,0 +1,84 @@
+/**
+ * Cola acotada sin cerrojos (BoundedQueue) entre las etapas de `stream`:
+ * range(0) productores y range(1) consumidores pasan ITEMS elementos por
+ * una cola de range(2) plazas. Con una cola pequeña los productores se
+ * frenan (contrapresión) en lugar de acumular.
+ *
+ * Comprueba que cada elemento sale exactamente una vez (número y suma); si
+ * no, failCheck. "max_depth" es la mayor profundidad que ven los
+ * consumidores (size() es aproximado: sólo informativo).
+ */
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "bench_check.h"
+#include "bounded_queue.h"
+
+using namespace std;
+
+namespace {
+
+const int ITEMS = 100000;
+
+void BM_BoundedQueue(benchmark::State& state) {
+    const int producers = static_cast<int>(state.range(0));
+    const int consumers = static_cast<int>(state.range(1));
+    const size_t capacity = static_cast<size_t>(state.range(2));
+
+    bool exact = true;
+    size_t maxDepth = 0;
+
+    for (auto _ : state) {
+        BoundedQueue<uint64_t> queue(capacity);
+        atomic<int> producersLeft{producers};
+        atomic<uint64_t> received{0}, sum{0};
+        atomic<size_t> depth{0};
+
+        vector<thread> threads;
+        for (int p = 0; p < producers; p++) {
+            threads.emplace_back([&, p] {
+                for (int i = p; i < ITEMS; i += producers) {
+                    queue.push(static_cast<uint64_t>(i));
+                }
+                if (producersLeft.fetch_sub(1) == 1) queue.close();
+            });
+        }
+        for (int c = 0; c < consumers; c++) {
+            threads.emplace_back([&] {
+                uint64_t item, count = 0, local = 0;
+                size_t deepest = 0;
+                while (queue.pop(item)) {
+                    count++;
+                    local += item;
+                    deepest = max(deepest, queue.size());
+                }
+                received += count;
+                sum += local;
+                size_t seen = depth.load();
+                while (deepest > seen && !depth.compare_exchange_weak(seen, deepest)) {
+                }
+            });
+        }
+        for (thread& t : threads) t.join();
+
+        uint64_t expected = static_cast<uint64_t>(ITEMS) * (ITEMS - 1) / 2;
+        exact = exact && received == static_cast<uint64_t>(ITEMS) && sum == expected;
+        maxDepth = max(maxDepth, depth.load());
+    }
+
+    state.SetItemsProcessed(state.iterations() * ITEMS);
+    state.counters["max_depth"] = static_cast<double>(maxDepth);
+    if (!exact) failCheck(state, "elementos perdidos o duplicados");
+}
+
+}  // namespace
+
+BENCHMARK(BM_BoundedQueue)
+    ->ArgsProduct({{1, 2}, {1, 4}, {4, 64}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
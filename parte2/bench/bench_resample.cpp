@@ -0,0 +1,94 @@
+/**
+ * Micro-benchmark del remuestreo de contornos.
+ *
+ * Compara la versión original (reinicia la búsqueda lineal desde idx = 0
+ * para cada una de las NUM_POINTS muestras, O(n · m)) con resampleContour
+ * (dos punteros, O(n + m)) sobre contornos circulares de 100 a 100k puntos.
+ */
+
+#include <benchmark/benchmark.h>
+#include <opencv2/core.hpp>
+#include <cmath>
+#include <vector>
+
+#include "contour_resample.h"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+const int NUM_POINTS = 1024;
+
+// Contorno tipo findContours: puntos enteros de un círculo con n muestras
+vector<Point> makeCircleContour(int n) {
+    vector<Point> contour(n);
+    double radius = n / (2 * CV_PI);
+    for (int i = 0; i < n; i++) {
+        double angle = 2 * CV_PI * i / n;
+        contour[i] = Point(cvRound(radius + radius * cos(angle)),
+                           cvRound(radius + radius * sin(angle)));
+    }
+    return contour;
+}
+
+// Implementación anterior de interpolateContour (sin logs), como referencia
+vector<Point2f> interpolateContourLegacy(const vector<Point>& contour) {
+    int n = contour.size();
+    
+    vector<float> cumulativeLength(n);
+    cumulativeLength[0] = 0.0f;
+    
+    for (int i = 1; i < n; i++) {
+        float dx = contour[i].x - contour[i-1].x;
+        float dy = contour[i].y - contour[i-1].y;
+        cumulativeLength[i] = cumulativeLength[i-1] + sqrt(dx*dx + dy*dy);
+    }
+    
+    float totalLength = cumulativeLength[n-1];
+    vector<Point2f> interpolated(NUM_POINTS);
+    
+    for (int i = 0; i < NUM_POINTS; i++) {
+        float targetLength = (totalLength * i) / NUM_POINTS;
+        
+        int idx = 0;
+        while (idx < n-1 && cumulativeLength[idx+1] < targetLength) {
+            idx++;
+        }
+        
+        if (idx < n-1) {
+            float segmentLength = cumulativeLength[idx+1] - cumulativeLength[idx];
+            float t = (targetLength - cumulativeLength[idx]) / segmentLength;
+            interpolated[i].x = (1-t) * contour[idx].x + t * contour[idx+1].x;
+            interpolated[i].y = (1-t) * contour[idx].y + t * contour[idx+1].y;
+        } else {
+            interpolated[i] = contour[idx];
+        }
+    }
+    
+    return interpolated;
+}
+
+void BM_ResampleLegacy(benchmark::State& state) {
+    vector<Point> contour = makeCircleContour(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(interpolateContourLegacy(contour));
+    }
+    state.SetItemsProcessed(state.iterations() * contour.size());
+}
+
+void BM_ResampleTwoPointer(benchmark::State& state) {
+    vector<Point> contour = makeCircleContour(state.range(0));
+    vector<Point2f> interpolated;
+    vector<float> cumulativeLength;
+    for (auto _ : state) {
+        resampleContour(contour, NUM_POINTS, interpolated, cumulativeLength);
+        benchmark::DoNotOptimize(interpolated.data());
+    }
+    state.SetItemsProcessed(state.iterations() * contour.size());
+}
+
+}  // namespace
+
+BENCHMARK(BM_ResampleLegacy)->RangeMultiplier(10)->Range(100, 100000);
+BENCHMARK(BM_ResampleTwoPointer)->RangeMultiplier(10)->Range(100, 100000);
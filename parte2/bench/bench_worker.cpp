@@ -0,0 +1,92 @@
+/**
+ * Prueba de estrés del hilo en vivo (LatestWorker): varios productores
+ * envían trazos tan rápido como pueden mientras el manejador simula una
+ * clasificación de `range(1)` µs. Mide el peor submit() y la latencia del
+ * último resultado; las garantías del buzón las comprueba
+ * test_latest_worker.cpp.
+ */
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "latest_worker.h"
+
+using namespace std;
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+const int SUBMISSIONS_PER_PRODUCER = 2000;
+const int STROKE_VALUES = 1024;         // ~512 puntos de trazo por envío
+
+// Espera activa: un sleep de pocos µs dura mucho más en la mayoría de sistemas
+void spinFor(chrono::microseconds duration) {
+    Clock::time_point end = Clock::now() + duration;
+    while (Clock::now() < end) {
+    }
+}
+
+void BM_LatestWorkerStress(benchmark::State& state) {
+    const int producers = static_cast<int>(state.range(0));
+    const chrono::microseconds work(state.range(1));
+
+    uint64_t totalSubmitted = 0, totalProcessed = 0;
+    double maxSubmitUs = 0.0, finalLatencyUs = 0.0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        atomic<int64_t> lastDoneNs{0};
+        LatestWorker<vector<float>> worker([&](vector<float>& stroke, uint64_t) {
+            benchmark::DoNotOptimize(stroke.data());
+            spinFor(work);
+            lastDoneNs.store(Clock::now().time_since_epoch().count(), memory_order_relaxed);
+        });
+        vector<double> slowestSubmit(producers, 0.0);
+        atomic<int64_t> lastSubmitNs{0};
+        state.ResumeTiming();
+
+        vector<thread> threads;
+        for (int p = 0; p < producers; p++) {
+            threads.emplace_back([&, p] {
+                vector<float> stroke(STROKE_VALUES, static_cast<float>(p));
+                for (int i = 0; i < SUBMISSIONS_PER_PRODUCER; i++) {
+                    Clock::time_point start = Clock::now();
+                    worker.submit(stroke);
+                    Clock::time_point end = Clock::now();
+                    double us = chrono::duration<double, micro>(end - start).count();
+                    slowestSubmit[p] = max(slowestSubmit[p], us);
+                    lastSubmitNs.store(end.time_since_epoch().count(), memory_order_relaxed);
+                }
+            });
+        }
+        for (thread& t : threads) t.join();
+        worker.drain();
+
+        state.PauseTiming();
+        LatestWorker<vector<float>>::Stats stats = worker.stats();
+        totalSubmitted += stats.submitted;
+        totalProcessed += stats.processed;
+        maxSubmitUs = max(maxSubmitUs, *max_element(slowestSubmit.begin(), slowestSubmit.end()));
+        finalLatencyUs = max(finalLatencyUs, (lastDoneNs - lastSubmitNs) / 1000.0);
+        state.ResumeTiming();   // el destructor (join) entra en la medida
+    }
+
+    state.counters["submits_per_s"] = benchmark::Counter(static_cast<double>(totalSubmitted),
+                                                         benchmark::Counter::kIsRate);
+    state.counters["processed_pct"] = 100.0 * totalProcessed / max<uint64_t>(totalSubmitted, 1);
+    state.counters["max_submit_us"] = maxSubmitUs;
+    state.counters["final_latency_us"] = finalLatencyUs;
+}
+
+}  // namespace
+
+BENCHMARK(BM_LatestWorkerStress)
+    ->ArgsProduct({{1, 4}, {0, 50, 1000}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,229 @@
+/**
+ * Entradas sintéticas para los benchmarks: círculos, triángulos y cuadrados
+ * negros sobre fondo blanco (como las imágenes del dataset) y corpus
+ * aleatorios de cualquier tamaño. Todo es determinista (semilla fija).
+ */
+
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "contour_resample.h"
+#include "descriptor_matrix.h"
+#include "shape_pipeline.h"
+
+enum SyntheticShape {
+    SHAPE_CIRCLE = 0,
+    SHAPE_TRIANGLE = 1,
+    SHAPE_SQUARE = 2
+};
+
+inline const char* shapeName(int shape) {
+    static const char* names[] = {"circle", "triangle", "square"};
+    return names[shape];
+}
+
+// Vértices de la forma centrada en (cx, cy) con "radio" r (el círculo se aproxima con 360)
+inline std::vector<cv::Point> shapeVertices(int shape, float cx, float cy, float r) {
+    int sides = (shape == SHAPE_TRIANGLE) ? 3 : (shape == SHAPE_SQUARE) ? 4 : 360;
+    float phase = (shape == SHAPE_SQUARE) ? CV_PI / 4 : -CV_PI / 2;
+
+    std::vector<cv::Point> vertices;
+    for (int i = 0; i < sides; i++) {
+        float angle = phase + 2 * CV_PI * i / sides;
+        vertices.push_back(cv::Point(cvRound(cx + r * std::cos(angle)),
+                                     cvRound(cy + r * std::sin(angle))));
+    }
+    return vertices;
+}
+
+// Imagen BGR size×size con la forma rellena en negro ocupando ~70% del lado
+inline cv::Mat makeShapeImage(int shape, int size) {
+    cv::Mat image(size, size, CV_8UC3, cv::Scalar(255, 255, 255));
+    std::vector<std::vector<cv::Point>> polygons = {
+        shapeVertices(shape, size / 2.0f, size / 2.0f, size * 0.35f)
+    };
+    cv::fillPoly(image, polygons, cv::Scalar(0, 0, 0), cv::LINE_AA);
+    return image;
+}
+
+/**
+ * Lienzo RGBA width×height como el bitmap de DrawingView: fondo blanco y
+ * la forma dibujada con trazo negro de 20 px (lado ~700 px), centrada.
+ */
+inline cv::Mat makeCanvasImage(int shape, int width, int height) {
+    cv::Mat canvas(height, width, CV_8UC4, cv::Scalar(255, 255, 255, 255));
+    std::vector<std::vector<cv::Point>> polygons = {
+        shapeVertices(shape, width / 2.0f, height / 2.0f, 350.0f)
+    };
+    cv::polylines(canvas, polygons, true, cv::Scalar(0, 0, 0, 255), 20, cv::LINE_AA);
+    return canvas;
+}
+
+/**
+ * Hoja escaneada: cuadrícula grid×grid de celdas de `cell` px, cada una con
+ * una forma rellena (círculo, triángulo, cuadrado, en rotación) que ocupa
+ * ~60% de la celda. Imagen BGR, fondo blanco.
+ */
+inline cv::Mat makeShapeSheet(int grid, int cell) {
+    cv::Mat sheet(grid * cell, grid * cell, CV_8UC3, cv::Scalar(255, 255, 255));
+    for (int row = 0; row < grid; row++) {
+        for (int col = 0; col < grid; col++) {
+            int shape = (row * grid + col) % 3;
+            std::vector<std::vector<cv::Point>> polygons = {
+                shapeVertices(shape, (col + 0.5f) * cell, (row + 0.5f) * cell, cell * 0.3f)
+            };
+            cv::fillPoly(sheet, polygons, cv::Scalar(0, 0, 0), cv::LINE_AA);
+        }
+    }
+    return sheet;
+}
+
+/**
+ * Fotograma `frame` de un vídeo sintético width×height (BGR): `count`
+ * formas rellenas de radio 50 px en una cuadrícula de 3 columnas, cada
+ * una desplazándose (±2, ±1) px por fotograma en una dirección distinta.
+ * Hasta ~60 fotogramas las formas no se tocan ni salen de 1280×720.
+ */
+inline cv::Mat makeMovingFrame(int frame, int count, int width, int height) {
+    cv::Mat image(height, width, CV_8UC3, cv::Scalar(255, 255, 255));
+    const int columns = 3;
+    const int rows = (count + columns - 1) / columns;
+    for (int i = 0; i < count; i++) {
+        float cx = (i % columns + 0.5f) * width / columns + ((i % 2) ? 2.0f : -2.0f) * frame;
+        float cy = (i / columns + 0.5f) * height / rows + (((i / 2) % 2) ? 1.0f : -1.0f) * frame;
+        std::vector<std::vector<cv::Point>> polygons = {shapeVertices(i % 3, cx, cy, 50.0f)};
+        cv::fillPoly(image, polygons, cv::Scalar(0, 0, 0), cv::LINE_AA);
+    }
+    return image;
+}
+
+/**
+ * La misma forma que makeCanvasImage como un único trazo táctil:
+ * x0, y0, x1, y1, ... con un punto cada ~8 px (ritmo típico de los eventos
+ * ACTION_MOVE), cerrado volviendo al punto inicial.
+ */
+inline std::vector<float> makeShapeStroke(int shape, int width, int height) {
+    std::vector<cv::Point> vertices = shapeVertices(shape, width / 2.0f, height / 2.0f, 350.0f);
+    vertices.push_back(vertices.front());
+
+    std::vector<float> xy;
+    for (size_t i = 0; i + 1 < vertices.size(); i++) {
+        cv::Point2f a = vertices[i], b = vertices[i + 1];
+        int steps = std::max(1, cvRound(cv::norm(b - a) / 8.0));
+        for (int k = 0; k < steps; k++) {
+            cv::Point2f p = a + (b - a) * (static_cast<float>(k) / steps);
+            xy.push_back(p.x);
+            xy.push_back(p.y);
+        }
+    }
+    xy.push_back(static_cast<float>(vertices.back().x));
+    xy.push_back(static_cast<float>(vertices.back().y));
+    return xy;
+}
+
+/**
+ * Contorno de la forma muestreado con `numPoints` puntos enteros a lo largo
+ * del perímetro (como un contorno de findContours con CHAIN_APPROX_NONE).
+ */
+inline std::vector<cv::Point> makeShapeContour(int shape, int numPoints) {
+    std::vector<cv::Point> vertices = shapeVertices(shape, 0, 0, numPoints / 4.0f);
+    std::vector<cv::Point2f> dense = resampleContour(vertices, numPoints);
+
+    std::vector<cv::Point> contour(dense.size());
+    for (size_t i = 0; i < dense.size(); i++) {
+        contour[i] = cv::Point(cvRound(dense[i].x), cvRound(dense[i].y));
+    }
+    return contour;
+}
+
+/**
+ * Contorno como el que da findContours en un dibujo: recorrido en el sentido
+ * contrario al de makeShapeContour (la energía queda en F[N-1] y |F[1]| es
+ * pequeño) y con el primer vértice desplazado hacia fuera una fracción
+ * `skew` del radio, que deja el |F[1]| residual de un trazo irregular. Con
+ * el valor por defecto el cuadrado da componentes de ~160, del orden de las
+ * de assets/corpus.csv.
+ */
+inline std::vector<cv::Point> makeTracedContour(int shape, int numPoints, float skew = 0.003f) {
+    std::vector<cv::Point> vertices = shapeVertices(shape, 0, 0, numPoints / 4.0f);
+    vertices[0] = cv::Point(cvRound(vertices[0].x * (1 + skew)), cvRound(vertices[0].y * (1 + skew)));
+    std::vector<cv::Point2f> dense = resampleContour(vertices, numPoints);
+
+    std::vector<cv::Point> contour(dense.size());
+    for (size_t i = 0; i < dense.size(); i++) {
+        contour[i] = cv::Point(cvRound(dense[i].x), cvRound(dense[i].y));
+    }
+    std::reverse(contour.begin(), contour.end());
+    return contour;
+}
+
+/**
+ * Tolerancia para comparar el descriptor de dos caminos de la DFT en float:
+ * `relative` · ‖F‖₂ / |F[1]|. El redondeo de cada |F[k]| es proporcional a
+ * la energía de todo el espectro (‖F‖₂² = N·Σ|z|²) y la normalización lo
+ * divide por |F[1]|. Si F[1] concentra la energía (makeShapeContour) la
+ * cota es `relative`; en makeTracedContour crece con |F[N-1]| / |F[1]|.
+ * |F[1]| se calcula en double sobre el contorno remuestreado.
+ */
+inline double descriptorTolerance(const std::vector<cv::Point2f>& contour, double relative = 1e-5) {
+    const size_t n = contour.size();
+    double cx = 0, cy = 0;
+    for (const cv::Point2f& p : contour) {
+        cx += p.x;
+        cy += p.y;
+    }
+    cx /= n;
+    cy /= n;
+
+    double energy = 0, fundamentalRe = 0, fundamentalIm = 0;
+    for (size_t i = 0; i < n; i++) {
+        double x = contour[i].x - cx, y = contour[i].y - cy;
+        double angle = -2 * CV_PI * i / n;
+        energy += x * x + y * y;
+        fundamentalRe += x * std::cos(angle) - y * std::sin(angle);
+        fundamentalIm += x * std::sin(angle) + y * std::cos(angle);
+    }
+    double fundamental = std::max(std::hypot(fundamentalRe, fundamentalIm), 1e-12);
+    return relative * std::sqrt(n * energy) / fundamental;
+}
+
+// Corpus aleatorio de `rows` descriptores repartidos entre las tres clases
+inline std::vector<ShapeDescriptor> makeSyntheticCorpus(int rows, uint64_t seed = 42) {
+    cv::RNG rng(seed);
+    std::vector<ShapeDescriptor> corpus;
+    corpus.reserve(rows);
+
+    for (int i = 0; i < rows; i++) {
+        std::vector<float> features(NUM_HARMONICS);
+        features[0] = 1.0f;
+        for (int k = 1; k < NUM_HARMONICS; k++) {
+            features[k] = rng.uniform(0.0f, 1.0f);
+        }
+        corpus.push_back(ShapeDescriptor(features, shapeName(i % 3)));
+    }
+    return corpus;
+}
+
+// Igual que makeSyntheticCorpus pero directo a memoria contigua (para
+// corpus de millones de filas sin un vector por descriptor)
+inline DescriptorMatrix makeSyntheticMatrix(int rows, uint64_t seed = 42) {
+    cv::RNG rng(seed);
+    DescriptorMatrixBuilder builder;
+    builder.reserve(rows);
+
+    float features[NUM_HARMONICS];
+    features[0] = 1.0f;
+    for (int i = 0; i < rows; i++) {
+        for (int k = 1; k < NUM_HARMONICS; k++) {
+            features[k] = rng.uniform(0.0f, 1.0f);
+        }
+        builder.add(features, NUM_HARMONICS, shapeName(i % 3));
+    }
+    return builder.build();
+}
@@ -9,6 +9,8 @@
  * 5. NORMALIZAR 
  * 6. COMPARAR con distancia euclídea → menor distancia = más parecido
  * 
+ * El pipeline vive en la librería shape_core (compartida con Android);
+ * este archivo sólo contiene la herramienta de línea de comandos.
  */
 
 #include <opencv2/opencv.hpp>
@@ -18,541 +20,1159 @@
 #include <cmath>
 #include <fstream>
 #include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <cstdio>
+#include <memory>
+
+#include "bounded_queue.h"
+#include "contour_resample.h"
+#include "corpus_binary.h"
+#include "corpus_io.h"
+#include "descriptor_matrix.h"
+#include "knn_batch.h"
+#include "nn_index.h"
+#include "quantized_corpus.h"
+#include "roi_tracker.h"
+#include "shape_log.h"
+#include "shape_pipeline.h"
+#include "thread_pool.h"
 
 using namespace cv;
 using namespace std;
 
 // CONSTANTES GLOBALES
 
-const int NUM_POINTS = 1024;        // Interpolación a 1024 puntos
-const int NUM_HARMONICS = 15;       // Número de armónicos para el descriptor
 const string TRAIN_DIR = "data/training/";  // Corpus de entrenamiento
 const string TEST_DIR = "data/testing/";    // Imágenes de prueba
 
-// ESTRUCTURA: Descriptor de Forma
-
-struct ShapeDescriptor {
-    vector<float> features;    
-    string label;              
-    string filename;           
-    
-    ShapeDescriptor() {}
-    ShapeDescriptor(const vector<float>& f, const string& l, const string& fn = "") 
-        : features(f), label(l), filename(fn) {}
-};
-
-// PASO 1: PREPROCESAMIENTO Y EXTRACCIÓN DE CONTORNO
-
 /**
- * Preprocesa la imagen y extrae el contorno principal.
- * 
- * Pipeline:
- * - Convertir a escala de grises 
- * - Binarización con umbral adaptativo 
- * - operaciones morfológicas para 
- * - Extraer contornos con findContours
- * - Seleccionar el contorno más grande
+ * Sink de logs para consola: errores a cerr, el resto a cout. Sin endl
+ * (no fuerza un flush por mensaje) y con un mutex para que los mensajes de
+ * varios hilos no se mezclen a mitad de línea.
  */
-bool extractContour(const Mat& image, vector<Point>& contour) {
-    Mat gray, binary;
+void consoleLogSink(LogLevel level, const char* message) {
+    static mutex sinkMutex;
+    lock_guard<mutex> lock(sinkMutex);
     
-    
-    if (image.channels() == 3) {
-        cvtColor(image, gray, COLOR_BGR2GRAY);
+    if (level == LogLevel::Error) {
+        cerr << " " << message << '\n';
     } else {
-        gray = image.clone();
+        cout << "✓ " << message << '\n';
     }
-    
-
-    adaptiveThreshold(gray, binary, 255, ADAPTIVE_THRESH_GAUSSIAN_C, 
-                      THRESH_BINARY_INV, 11, 2);
-    
-    // Operaciones morfológicas para limpiar ruido
-    Mat kernel = getStructuringElement(MORPH_ELLIPSE, Size(3, 3));
-    morphologyEx(binary, binary, MORPH_CLOSE, kernel);  
-    morphologyEx(binary, binary, MORPH_OPEN, kernel);   
-    
-    // Extraer todos los contornos
-    vector<vector<Point>> contours;
-    findContours(binary, contours, RETR_EXTERNAL, CHAIN_APPROX_NONE);
-    
-    if (contours.empty()) {
-        cerr << " No se encontraron contornos en la imagen" << endl;
-        return false;
-    }
-    
-    // Seleccionar el contorno más grande
-    double maxArea = 0;
-    int maxIdx = 0;
-    for (size_t i = 0; i < contours.size(); i++) {
-        double area = contourArea(contours[i]);
-        if (area > maxArea) {
-            maxArea = area;
-            maxIdx = i;
-        }
-    }
-    
-    contour = contours[maxIdx];
-    
-    
-    if (maxArea < 100) {
-        cerr << " Contorno muy pequeño (área < 100 píxeles)" << endl;
-        return false;
-    }
-    
-    cout << "✓ Contorno extraído: " << contour.size() << " puntos, área = " 
-         << maxArea << " px²" << endl;
-    
-    return true;
 }
 
-// PASO 2: INTERPOLACIÓN LINEAL A 1024 PUNTOS
+// UTILIDADES: LISTAR IMÁGENES DEL DATASET
+
+struct ImageEntry {
+    string label;
+    string path;
+};
 
 /**
- * Interpola el contorno a exactamente NUM_POINTS puntos.
- * - 1024 puntos captura suficientes detalles de la forma
+ * Lista las imágenes .png/.jpg de <rootDir>/<clase>/ en orden determinista:
+ * primero por el orden de `classes`, después por ruta. directory_iterator no
+ * garantiza ningún orden, así que ordenamos para que el corpus sea
+ * reproducible sin importar cuántos hilos se usen.
  */
-vector<Point2f> interpolateContour(const vector<Point>& contour) {
-    int n = contour.size();
+vector<ImageEntry> listImages(const string& rootDir, const vector<string>& classes) {
+    vector<ImageEntry> images;
     
-    if (n < 3) {
-        cerr << " Contorno con muy pocos puntos: " << n << endl;
-        return vector<Point2f>();
-    }
-    
-    // Calcular longitud acumulada del contorno
-    vector<float> cumulativeLength(n);
-    cumulativeLength[0] = 0.0f;
-    
-    for (int i = 1; i < n; i++) {
-        float dx = contour[i].x - contour[i-1].x;
-        float dy = contour[i].y - contour[i-1].y;
-        float dist = sqrt(dx*dx + dy*dy);
-        cumulativeLength[i] = cumulativeLength[i-1] + dist;
-    }
-    
-    float totalLength = cumulativeLength[n-1];
-    
-    
-    vector<Point2f> interpolated(NUM_POINTS);
-    
-    for (int i = 0; i < NUM_POINTS; i++) {
-        // Posición objetivo en el contorno
-        float targetLength = (totalLength * i) / NUM_POINTS;
+    for (const string& cls : classes) {
+        string classDir = rootDir + cls + "/";
         
+        if (!filesystem::exists(classDir)) {
+            cout << "  Directorio no existe: " << classDir << endl;
+            continue;
+        }
         
-        int idx = 0;
-        while (idx < n-1 && cumulativeLength[idx+1] < targetLength) {
-            idx++;
+        vector<string> paths;
+        for (const auto& entry : filesystem::directory_iterator(classDir)) {
+            if (entry.path().extension() == ".png" || 
+                entry.path().extension() == ".jpg") {
+                paths.push_back(entry.path().string());
+            }
         }
+        sort(paths.begin(), paths.end());
         
-        // Interpolar linealmente
-        if (idx < n-1) {
-            float segmentLength = cumulativeLength[idx+1] - cumulativeLength[idx];
-            float t = (targetLength - cumulativeLength[idx]) / segmentLength;
-            
-            interpolated[i].x = (1-t) * contour[idx].x + t * contour[idx+1].x;
-            interpolated[i].y = (1-t) * contour[idx].y + t * contour[idx+1].y;
-        } else {
-            interpolated[i] = contour[idx];
+        for (const string& path : paths) {
+            images.push_back({cls, path});
         }
     }
     
-    cout << "✓ Contorno interpolado: " << contour.size() 
-         << " → " << NUM_POINTS << " puntos" << endl;
-    
-    return interpolated;
+    return images;
 }
 
-// PASO 3: CALCULAR CENTROIDE
+// UTILIDADES: RESUMEN POR IMAGEN
+
+// Registro estructurado de una imagen procesada en train/test
+struct ImageRecord {
+    ExtractionSummary summary;
+    string predicted;           // sólo en test
+    float distance = 0;
+};
 
 /**
- * Calcula el centroide (centro de masa) del contorno.
+ * Guarda un registro por imagen en CSV. Se escribe una sola vez al final
+ * del lote, así el bucle de extracción no hace E/S por etapa.
  */
-Point2f calculateCentroid(const vector<Point2f>& contour) {
-    float sumX = 0, sumY = 0;
-    
-    for (const auto& pt : contour) {
-        sumX += pt.x;
-        sumY += pt.y;
+void saveImageRecords(const vector<ImageEntry>& images, const vector<ImageRecord>& records,
+                      const string& filename) {
+    ofstream file(filename);
+    if (!file.is_open()) {
+        cerr << " No se pudo crear archivo: " << filename << endl;
+        return;
     }
     
-    Point2f centroid(sumX / contour.size(), sumY / contour.size());
-    
-    cout << "✓ Centroide calculado: (" << centroid.x << ", " 
-         << centroid.y << ")" << endl;
+    file << "path,label,ok,failed_stage,contour_points,contour_area,fundamental,"
+            "elapsed_ms,predicted,distance\n";
+    for (size_t i = 0; i < images.size(); i++) {
+        const ExtractionSummary& s = records[i].summary;
+        file << images[i].path << "," << images[i].label << "," << s.ok << "," 
+             << s.failedStage << "," << s.contourPoints << "," << s.contourArea << ","
+             << s.fundamental << "," << s.elapsedMs << "," << records[i].predicted << ","
+             << records[i].distance << "\n";
+    }
     
-    return centroid;
+    cout << "✓ Resumen por imagen guardado: " << filename << endl;
 }
 
-// PASO 4: CONSTRUIR SEÑAL COMPLEJA (COORDENADAS COMPLEJAS)
+// UTILIDADES: EXTRACCIÓN POR LOTES
+
+// Imágenes por tarea del pool (los pasos 3-6 van de SPECTRUM_BATCH en SPECTRUM_BATCH)
+const size_t EXTRACT_CHUNK = 32;
 
 /**
- * Construye la señal compleja centrada en el centroide.
+ * Lee images[first, last) y extrae sus descriptores con una sola llamada
+ * a extractDescriptorBatch (FFT y Zernike por lotes, Hu imagen a imagen).
+ * Cada imagen escribe en su propia posición de `results` y `records`; las
+ * que no se pueden leer quedan vacías.
  */
-Mat buildComplexSignal(const vector<Point2f>& contour, const Point2f& centroid) {
-    int n = contour.size();
-    
-    Mat complexSignal(n, 1, CV_32FC2);
-    
-    for (int i = 0; i < n; i++) {
-        float real = contour[i].x - centroid.x;  
-        float imag = contour[i].y - centroid.y;
-        
-        complexSignal.at<Vec2f>(i, 0) = Vec2f(real, imag);
+void extractImageChunk(const vector<ImageEntry>& images, size_t first, size_t last,
+                       vector<ShapeDescriptor>& results, vector<ImageRecord>& records,
+                       DescriptorKind kind = DescriptorKind::Fft) {
+    vector<Mat> batch;
+    vector<string> labels, filenames;
+    vector<size_t> imageIndex;
+    
+    for (size_t i = first; i < last; i++) {
+        Mat img = imread(images[i].path);
+        if (img.empty()) continue;
+        batch.push_back(img);
+        labels.push_back(images[i].label);
+        filenames.push_back(filesystem::path(images[i].path).filename().string());
+        imageIndex.push_back(i);
     }
     
-    cout << "✓ Señal compleja construida: z(n) = (x-xc) + j(y-yc)" << endl;
+    vector<ExtractionSummary> summaries(batch.size());
+    vector<ShapeDescriptor> descriptors =
+        extractDescriptorBatch(kind, batch, labels, filenames, summaries.data());
     
-    return complexSignal;
+    for (size_t j = 0; j < batch.size(); j++) {
+        results[imageIndex[j]] = std::move(descriptors[j]);
+        records[imageIndex[j]].summary = summaries[j];
+    }
 }
 
-// PASO 5: TRANSFORMADA DE FOURIER (FFT)
+// Corpus por defecto de cada descriptor: data/corpus.csv (FFT), data/corpus_hu.csv...
+string defaultCorpusFile(DescriptorKind kind) {
+    if (kind == DescriptorKind::Fft) return "data/corpus.csv";
+    return string("data/corpus_") + descriptorKindName(kind) + ".csv";
+}
 
 /**
- * Aplica la Transformada Discreta de Fourier, es la firma de la figura
+ * Comprueba que el corpus se generó con el descriptor elegido (misma
+ * dimensión); si no, lo explica en lugar de comparar vectores distintos.
  */
-void computeFFT(const Mat& complexSignal, vector<float>& magnitudes) {
-    Mat dftOutput;
+bool checkCorpusDescriptor(const DescriptorMatrix& corpus, DescriptorKind kind) {
+    if (corpus.dim() == descriptorSize(kind)) return true;
+    cerr << " El corpus tiene " << corpus.dim() << " valores por ejemplo y el descriptor "
+         << descriptorKindName(kind) << " " << descriptorSize(kind) 
+         << " (¿falta --descriptor o --corpus?)" << endl;
+    return false;
+}
+
+// FUNCIÓN PRINCIPAL: GENERAR CORPUS DE ENTRENAMIENTO
+
+/**
+ * Genera el corpus de entrenamiento procesando todas las imágenes en TRAIN_DIR.
+ * 
+ * Las imágenes se procesan en bloques de EXTRACT_CHUNK (extractImageChunk).
+ * Con jobs > 1 los bloques se reparten en un pool con robo de trabajo. Cada
+ * tarea escribe en su propia posición de `results`, así el CSV sale en el
+ * mismo orden que con un hilo.
+ */
+void generateTrainingCorpus(unsigned jobs = 1, const string& summaryFile = "",
+                            DescriptorKind kind = DescriptorKind::Fft) {
+    cout << "\n GENERANDO CORPUS DE ENTRENAMIENTO (descriptor " << descriptorKindName(kind) << ")..." << endl;
     
+    vector<string> classes = {"circle", "triangle", "square"};
+    vector<ImageEntry> images = listImages(TRAIN_DIR, classes);
+    vector<ShapeDescriptor> results(images.size());
+    vector<ImageRecord> records(images.size());
     
-    dft(complexSignal, dftOutput, DFT_COMPLEX_OUTPUT);
+    auto processChunk = [&](size_t first) {
+        size_t last = first + EXTRACT_CHUNK < images.size() ? first + EXTRACT_CHUNK : images.size();
+        extractImageChunk(images, first, last, results, records, kind);
+    };
     
-    vector<Mat> planes(2);
-    split(dftOutput, planes); 
+    auto start = chrono::steady_clock::now();
     
-    // Calcular magnitudes
-    Mat mag;
-    magnitude(planes[0], planes[1], mag);
+    if (jobs == 1) {
+        for (size_t first = 0; first < images.size(); first += EXTRACT_CHUNK) {
+            processChunk(first);
+        }
+    } else {
+        ThreadPool pool(jobs);
+        cout << "  Procesando " << images.size() << " imágenes con " 
+             << pool.size() << " hilos..." << endl;
+        
+        for (size_t first = 0; first < images.size(); first += EXTRACT_CHUNK) {
+            pool.submit([&processChunk, first] { processChunk(first); });
+        }
+        pool.wait();
+    }
+    
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+    DescriptorMatrixBuilder builder;
+    builder.reserve(static_cast<int>(results.size()));
+    for (const auto& desc : results) {
+        if (!desc.features.empty()) {
+            builder.add(desc);
+        }
+    }
+    DescriptorMatrix corpus = builder.build();
     
-    magnitudes.clear();
-    for (int i = 0; i < mag.rows; i++) {
-        magnitudes.push_back(mag.at<float>(i, 0));
+    saveCorpus(corpus, defaultCorpusFile(kind));
+    
+    if (!summaryFile.empty()) {
+        saveImageRecords(images, records, summaryFile);
     }
     
-    cout << "✓ FFT calculada: " << magnitudes.size() << " coeficientes" << endl;
+    cout << "\n CORPUS GENERADO: " << corpus.rows() << " ejemplos ("
+         << corpus.memoryBytes() << " bytes en memoria)" << endl;
+    cout << " Rendimiento: " << images.size() << " imágenes en " << seconds 
+         << " s (" << (seconds > 0 ? images.size() / seconds : 0.0) 
+         << " imágenes/s)" << endl;
 }
 
-// PASO 6: NORMALIZACIÓN 
+// UTILIDADES: MATRIZ DE CONFUSIÓN
 
-/**
- * Normalizamos los coeficientes de Fourier para invarianza a escala.
+// confusion[real][predicho] = número de imágenes
+using ConfusionMatrix = map<string, map<string, int>>;
 
- * - El primer componente F[0] es solo ENERGÍA DE LA SEÑAL
- * - lo usamos para LOCALIZAR los demás coeficientes
+void mergeConfusion(ConfusionMatrix& dst, const ConfusionMatrix& src) {
+    for (const auto& [real, row] : src) {
+        for (const auto& [pred, count] : row) {
+            dst[real][pred] += count;
+        }
+    }
+}
 
+/**
+ * Guarda una matriz de confusión parcial (una línea "real,predicho,n" por
+ * celda) para combinarla después con las de otros shards.
  */
-vector<float> normalizeDescriptor(const vector<float>& magnitudes) {
-    if (magnitudes.size() < 2) {
-        cerr << " Muy pocos coeficientes de Fourier" << endl;
-        return vector<float>(NUM_HARMONICS, 0.0f);
+void saveConfusion(const ConfusionMatrix& matrix, const string& filename) {
+    ofstream file(filename);
+    if (!file.is_open()) {
+        cerr << " No se pudo crear archivo: " << filename << endl;
+        return;
     }
     
+    for (const auto& [real, row] : matrix) {
+        for (const auto& [pred, count] : row) {
+            file << real << "," << pred << "," << count << "\n";
+        }
+    }
     
-    float dc = magnitudes[0];
-    
-    float fundamental = magnitudes[1];
+    cout << "✓ Resultados parciales guardados: " << filename << endl;
+}
+
+bool loadConfusion(const string& filename, ConfusionMatrix& matrix) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        cerr << " No se pudo abrir archivo: " << filename << endl;
+        return false;
+    }
     
-    if (fundamental < 1e-5) {
-        cerr << "Fundamental muy pequeño, posible error en la señal" << endl;
-        return vector<float>(NUM_HARMONICS, 0.0f);
+    string line;
+    while (getline(file, line)) {
+        stringstream ss(line);
+        string real, pred, count;
+        if (getline(ss, real, ',') && getline(ss, pred, ',') && getline(ss, count)) {
+            matrix[real][pred] += stoi(count);
+        }
     }
     
-    vector<float> descriptor;
+    return true;
+}
+
+void printConfusionReport(ConfusionMatrix& confusionMatrix, const vector<string>& classes) {
+    // Imprimir matriz de confusión
+    cout << "\n MATRIZ DE CONFUSIÓN:" << endl;
+    cout << "           ";
+    for (const auto& c : classes) cout << c << "\t";
+    cout << endl;
     
-    for (int k = 1; k <= NUM_HARMONICS && k < magnitudes.size(); k++) {
-        float normalized = magnitudes[k] / fundamental;
-        descriptor.push_back(normalized);
+    for (const auto& real : classes) {
+        cout << real << "\t";
+        for (const auto& pred : classes) {
+            cout << confusionMatrix[real][pred] << "\t";
+        }
+        cout << endl;
     }
     
-    while (descriptor.size() < NUM_HARMONICS) {
-        descriptor.push_back(0.0f);
+    // Calcular accuracy
+    int total = 0, correct = 0;
+    for (const auto& cls : classes) {
+        correct += confusionMatrix[cls][cls];
+        for (const auto& pred : classes) {
+            total += confusionMatrix[cls][pred];
+        }
     }
     
-    cout << "✓ Descriptor normalizado: " << descriptor.size() 
-         << " armónicos (F[0]=" << dc << " descartado)" << endl;
-    
-    return descriptor;
+    float accuracy = (total > 0) ? (100.0f * correct / total) : 0.0f;
+    cout << "\n ACCURACY: " << accuracy << "%" << endl;
 }
 
-// F. PRINCIPAL: EXTRAER DESCRIPTOR COMPLETO
+// FUNCIÓN PRINCIPAL: EVALUAR EN DATASET DE PRUEBA
+
+/**
+ * Compara el corpus cuantizado con el float sobre las consultas del test:
+ * memoria de los vectores y acierto del vecino más cercano con cada uno.
+ * `labels[q]` es la clase real de la consulta q.
+ */
+void reportQuantization(const DescriptorMatrix& queries, const vector<string>& labels,
+                        const DescriptorMatrix& corpus, Quantization quantization) {
+    QuantizedCorpus quantized = QuantizedCorpus::build(corpus, quantization);
+    
+    // Una búsqueda por consulta y corpus: la fila float se guarda para
+    // comparar después con la cuantizada
+    int floatHits = 0, quantizedHits = 0, sameRow = 0;
+    vector<int> floatRows(queries.rows());
+    auto start = chrono::steady_clock::now();
+    for (int q = 0; q < queries.rows(); q++) {
+        floatRows[q] = nearestNeighbor(queries.row(q), corpus, nullptr);
+        if (corpus.label(floatRows[q]) == labels[q]) floatHits++;
+    }
+    double floatSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+    start = chrono::steady_clock::now();
+    for (int q = 0; q < queries.rows(); q++) {
+        int row = quantized.search(queries.row(q), nullptr);
+        if (corpus.label(row) == labels[q]) quantizedHits++;
+        if (row == floatRows[q]) sameRow++;
+    }
+    double quantizedSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+    double n = max(1, queries.rows());
+    double floatAccuracy = 100.0 * floatHits / n;
+    double quantizedAccuracy = 100.0 * quantizedHits / n;
+    size_t floatBytes = corpus.memoryBytes();
+    size_t quantizedBytes = quantized.memoryBytes();
+    
+    cout << "\n CUANTIZACIÓN " << quantizationName(quantization) 
+         << " (reordenando " << QuantizedCorpus::DEFAULT_RERANK << " candidatos en float)" << endl;
+    cout << " Memoria: " << floatBytes / 1024.0 << " KB (float) → " << quantizedBytes / 1024.0 
+         << " KB (ahorro " << 100.0 * (1.0 - static_cast<double>(quantizedBytes) / floatBytes) << "%)" << endl;
+    cout << " Precisión: " << floatAccuracy << "% (float) → " << quantizedAccuracy << "% (Δ "
+         << showpos << quantizedAccuracy - floatAccuracy << noshowpos << " puntos)" << endl;
+    cout << " Mismo vecino que con float: " << sameRow << "/" << queries.rows() << endl;
+    cout << " Tiempo: " << floatSeconds * 1000 << " ms (float) → " << quantizedSeconds * 1000 << " ms" << endl;
+}
 
 /**
- * Pipeline completo
+ * Evalúa el dataset de prueba contra el corpus (CSV o binario).
  * 
- * Pasos:
- * 1. Sacar el contorno
- * 2. Interpolar a 1024 puntos
- * 3. Calcular centroide
- * 4. Construir señal compleja
- * 5. Aplicar FFT → FIRMA
- * 6. Normalizar por |F[1]|
+ * Primero se extraen todos los descriptores en bloques de EXTRACT_CHUNK
+ * imágenes (en paralelo con jobs > 1, con una línea de progreso) y después
+ * se clasifican de una vez:
+ * - índice brute: classifyBatch con los k vecinos más cercanos y votación,
+ *   unas pocas operaciones de matriz grandes para todo el conjunto.
+ * - kdtree/hnsw: una búsqueda por imagen en el índice (k = 1).
+ * 
+ * - shardCount > 1: sólo se procesan las imágenes con índice
+ *   i % shardCount == shardIndex (sobre la lista ordenada), de modo que
+ *   varios procesos se reparten el directorio. La matriz parcial se guarda
+ *   en data/results_shard_<i>_of_<N>.csv para unirla con `merge`.
+ * - quantization ("f16" o "int8"): además compara el corpus cuantizado
+ *   con el float (ver reportQuantization).
  */
-ShapeDescriptor extractShapeDescriptor(const Mat& image, 
-                                       const string& label = "", 
-                                       const string& filename = "") {
-    cout << "\n========================================" << endl;
-    cout << "Procesando: " << (filename.empty() ? "imagen" : filename) << endl;
-    cout << "========================================" << endl;
+void evaluateTestSet(const string& corpusFile, IndexKind indexKind = IndexKind::BruteForce,
+                     int k = 1, unsigned jobs = 1, int shardIndex = 0, int shardCount = 1,
+                     const string& summaryFile = "", const string& quantization = "",
+                     DescriptorKind descriptorKind = DescriptorKind::Fft) {
+    cout << "\n EVALUANDO DATASET DE PRUEBA..." << endl;
     
-    // PASO 1: Extraer contorno
-    vector<Point> contour;
-    if (!extractContour(image, contour)) {
-        return ShapeDescriptor();
+    // Cargar corpus
+    DescriptorMatrix corpus = loadCorpusMatrix(corpusFile);
+    if (corpus.empty()) {
+        cerr << " No se pudo cargar el corpus" << endl;
+        return;
     }
+    if (!checkCorpusDescriptor(corpus, descriptorKind)) return;
+    unique_ptr<NearestNeighborIndex> index;
+    if (indexKind != IndexKind::BruteForce) {
+        index = loadOrBuildIndex(indexKind, corpus, corpusFile);
+        if (k > 1) cout << "  --k sólo se aplica con --index brute; se usa k = 1" << endl;
+    }
+    
+    vector<string> classes = {"circle", "triangle", "square"};
+    vector<ImageEntry> allImages = listImages(TEST_DIR, classes);
     
-    // PASO 2: Interpolar a 1024 puntos
-    vector<Point2f> interpolated = interpolateContour(contour);
-    if (interpolated.empty()) {
-        return ShapeDescriptor();
+    vector<ImageEntry> images;
+    for (size_t i = 0; i < allImages.size(); i++) {
+        if (static_cast<int>(i % shardCount) == shardIndex) {
+            images.push_back(allImages[i]);
+        }
     }
     
-    // PASO 3: Calcular centroide
-    Point2f centroid = calculateCentroid(interpolated);
+    if (shardCount > 1) {
+        cout << "  Shard " << shardIndex << "/" << shardCount << ": " 
+             << images.size() << " de " << allImages.size() << " imágenes" << endl;
+    }
     
-    // PASO 4: Construir señal compleja
-    Mat complexSignal = buildComplexSignal(interpolated, centroid);
+    // PASO 1: Extraer los descriptores de todas las imágenes
+    vector<ShapeDescriptor> descriptors(images.size());
+    vector<ImageRecord> records(images.size());
+    atomic<size_t> processed{0};
+    mutex progressMutex;
+    auto start = chrono::steady_clock::now();
     
-    // PASO 5: FFT (FIRMA)
-    vector<float> magnitudes;
-    computeFFT(complexSignal, magnitudes);
+    auto extractChunk = [&](size_t first) {
+        size_t last = first + EXTRACT_CHUNK < images.size() ? first + EXTRACT_CHUNK : images.size();
+        extractImageChunk(images, first, last, descriptors, records, descriptorKind);
+        
+        size_t done = processed += last - first;
+        if (jobs > 1) {
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            lock_guard<mutex> lock(progressMutex);
+            cout << "\r  Progreso: " << done << "/" << images.size() 
+                 << " (" << (seconds > 0 ? done / seconds : 0.0) << " imágenes/s)" << flush;
+        }
+    };
     
-    // PASO 6: Normalizar
-    vector<float> descriptor = normalizeDescriptor(magnitudes);
+    if (jobs == 1) {
+        for (size_t first = 0; first < images.size(); first += EXTRACT_CHUNK) {
+            extractChunk(first);
+        }
+    } else {
+        ThreadPool pool(jobs);
+        for (size_t first = 0; first < images.size(); first += EXTRACT_CHUNK) {
+            pool.submit([&extractChunk, first] { extractChunk(first); });
+        }
+        pool.wait();
+        cout << endl;
+    }
     
-    cout << "Descriptor extraído exitosamente" << endl;
+    // PASO 2: Clasificar todas las consultas de una vez
+    vector<size_t> imageOfQuery;
+    DescriptorMatrixBuilder builder;
+    builder.reserve(static_cast<int>(images.size()));
+    for (size_t i = 0; i < images.size(); i++) {
+        if (!descriptors[i].features.empty() && builder.add(descriptors[i])) {
+            imageOfQuery.push_back(i);
+        }
+    }
+    DescriptorMatrix queries = builder.build();
+    
+    auto classifyStart = chrono::steady_clock::now();
+    vector<pair<string, float>> predictions;
+    if (queries.empty()) {
+        // ninguna imagen válida: nada que clasificar
+    } else if (!index) {
+        for (const KnnPrediction& prediction : classifyBatch(queries, corpus, k)) {
+            predictions.push_back({prediction.label, prediction.distance});
+        }
+    } else {
+        for (int q = 0; q < queries.rows(); q++) {
+            predictions.push_back(classify(descriptors[imageOfQuery[q]], *index));
+        }
+    }
+    double classifySeconds = chrono::duration<double>(chrono::steady_clock::now() - classifyStart).count();
+    
+    // PASO 3: Matriz de confusión y registros, en el orden de las imágenes
+    ConfusionMatrix confusionMatrix;
+    for (size_t q = 0; q < predictions.size(); q++) {
+        size_t i = imageOfQuery[q];
+        const auto& [predicted, distance] = predictions[q];
+        confusionMatrix[images[i].label][predicted]++;
+        records[i].predicted = predicted;
+        records[i].distance = distance;
+        
+        if (jobs == 1) {
+            string status = (predicted == images[i].label) ? "✓" : "✗";
+            cout << status << " Real: " << images[i].label << " | Predicho: " 
+                 << predicted << " | Distancia: " << distance << '\n';
+        }
+    }
+    
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+    printConfusionReport(confusionMatrix, classes);
+    cout << " Rendimiento: " << images.size() << " imágenes en " << seconds 
+         << " s (" << (seconds > 0 ? images.size() / seconds : 0.0) 
+         << " imágenes/s)" << endl;
+    cout << " Clasificación (" << (index ? indexKindName(indexKind) : "lote")
+         << ", k = " << (index ? 1 : k) << "): " << queries.rows() << " consultas en "
+         << classifySeconds * 1000 << " ms" << endl;
+    
+    Quantization quantizationKind;
+    if (!queries.empty() && parseQuantization(quantization, quantizationKind)) {
+        vector<string> labels;
+        for (size_t i : imageOfQuery) labels.push_back(images[i].label);
+        reportQuantization(queries, labels, corpus, quantizationKind);
+    }
+    
+    if (!summaryFile.empty()) {
+        saveImageRecords(images, records, summaryFile);
+    }
+    
+    if (shardCount > 1) {
+        saveConfusion(confusionMatrix, "data/results_shard_" + to_string(shardIndex) + 
+                      "_of_" + to_string(shardCount) + ".csv");
+    }
+}
+
+// Une las matrices parciales de varios shards y muestra el resultado global
+void mergeResults(const vector<string>& files) {
+    cout << "\n UNIENDO RESULTADOS PARCIALES..." << endl;
+    
+    ConfusionMatrix confusionMatrix;
+    for (const string& file : files) {
+        if (loadConfusion(file, confusionMatrix)) {
+            cout << "✓ " << file << endl;
+        }
+    }
     
-    return ShapeDescriptor(descriptor, label, filename);
+    printConfusionReport(confusionMatrix, {"circle", "triangle", "square"});
 }
 
-// PASO 7: COMPARACIÓN (DISTANCIA EUCLÍDEA)
+// UTILIDADES: CONVERTIR CORPUS CSV ↔ BINARIO
 
 /**
- * Calcula la distancia euclídea entre dos descriptores.
- * tenemos en cuenta que mientras más parecidas sean las formas, MÁS PEQUEÑO el valor de la distancia
- 
+ * Si `input` es binario se escribe CSV; si es CSV se escribe el formato
+ * binario mapeable (ver corpus_binary.h).
  */
-float euclideanDistance(const vector<float>& d1, const vector<float>& d2) {
-    if (d1.size() != d2.size()) {
-        cerr << "Descriptores de diferente tamaño" << endl;
-        return 1e9;  
+bool convertCorpus(const string& input, const string& output) {
+    if (isBinaryCorpusFile(input)) {
+        DescriptorMatrix corpus = loadCorpusBinary(input);
+        if (corpus.empty()) return false;
+        saveCorpus(corpus, output);
+        return true;
     }
     
-    float sum = 0.0f;
-    for (size_t i = 0; i < d1.size(); i++) {
-        float diff = d1[i] - d2[i];
-        sum += diff * diff;
+    DescriptorMatrix corpus = loadCorpus(input);
+    if (corpus.empty()) {
+        cerr << " Corpus vacío: " << input << endl;
+        return false;
     }
-    
-    return sqrt(sum);
+    return saveCorpusBinary(corpus, output);
 }
 
-/**
- * Clasifica una imagen comparándola con el corpus de entrenamiento.
- * 
- * Método:
- * - Calculamos la distancia a TODOS los ejemplos del corpus
- * - Seleccionar el más cercano, la dist. minima
- * - Retornamos su etiqueta
- * 
+// UTILIDADES: ÍNDICE DE VECINO MÁS CERCANO
 
+/**
+ * Construye (o carga) el índice guardado junto al corpus y mide su recall
+ * frente a la fuerza bruta y las consultas por segundo. Las consultas son
+ * filas del corpus con ruido gaussiano, así su vecino más cercano no es
+ * trivialmente la propia fila.
  */
-pair<string, float> classify(const ShapeDescriptor& testDescriptor, 
-                             const vector<ShapeDescriptor>& trainingSet) {
-    if (trainingSet.empty()) {
-        cerr << " Corpus de entrenamiento vacío" << endl;
-        return {"unknown", 1e9};
+bool reportIndex(const string& corpusFile, IndexKind kind, int numQueries = 1000) {
+    DescriptorMatrix corpus = loadCorpusMatrix(corpusFile);
+    if (corpus.empty()) {
+        cerr << " No se pudo cargar el corpus" << endl;
+        return false;
     }
     
-    string bestLabel = "unknown";
-    float minDistance = 1e9;
+    unique_ptr<NearestNeighborIndex> index = loadOrBuildIndex(kind, corpus, corpusFile);
     
-    for (const auto& train : trainingSet) {
-        float dist = euclideanDistance(testDescriptor.features, train.features);
-        
-        if (dist < minDistance) {
-            minDistance = dist;
-            bestLabel = train.label;
+    RNG rng(7);
+    DescriptorMatrixBuilder builder;
+    vector<float> query(corpus.dim());
+    for (int i = 0; i < numQueries; i++) {
+        const float* row = corpus.row(rng.uniform(0, corpus.rows()));
+        for (int k = 0; k < corpus.dim(); k++) {
+            query[k] = row[k] + static_cast<float>(rng.gaussian(0.02));
         }
+        builder.add(query.data(), corpus.dim(), corpus.label(0));
     }
     
-    return {bestLabel, minDistance};
+    IndexQuality quality = measureIndexQuality(*index, builder.build());
+    cout << "\n ÍNDICE " << indexKindName(kind) << " (" << corpus.rows() << " filas)" << endl;
+    cout << " Recall@1 frente a fuerza bruta: " << quality.recall * 100 << "%" << endl;
+    cout << " Consultas/s: " << quality.queriesPerSecond 
+         << " (fuerza bruta: " << quality.bruteQueriesPerSecond << ")" << endl;
+    return true;
 }
 
-// UTILIDADES: CARGAR/GUARDAR CORPUS
+// MODO MULTIOBJETO: CLASIFICAR TODAS LAS FORMAS DE UNA IMAGEN
 
-
-void saveCorpus(const vector<ShapeDescriptor>& corpus, const string& filename) {
-    ofstream file(filename);
-    if (!file.is_open()) {
-        cerr << " No se pudo crear archivo: " << filename << endl;
-        return;
+/**
+ * Clasifica cada contorno con área >= minArea (hojas escaneadas, fotogramas
+ * con muchas formas): extractShapeObjects reparte remuestreo y descriptores
+ * entre `jobs` hilos y la búsqueda se hace después, objeto a objeto (es
+ * barata frente a la extracción, y el KD-tree serializa sus consultas de
+ * todos modos). Muestra la caja, la etiqueta y la distancia de cada objeto
+ * y el rendimiento en objetos/s.
+ */
+bool classifyAllObjects(const string& imgPath, const string& corpusFile, IndexKind indexKind,
+                        unsigned jobs, double minArea) {
+    Mat img = imread(imgPath);
+    if (img.empty()) {
+        cerr << " No se pudo cargar imagen: " << imgPath << endl;
+        return false;
     }
     
-    for (const auto& desc : corpus) {
-        file << desc.label;
-        for (float f : desc.features) {
-            file << "," << f;
+    DescriptorMatrix corpus = loadCorpusMatrix(corpusFile);
+    if (corpus.empty()) {
+        cerr << " No se pudo cargar el corpus" << endl;
+        return false;
+    }
+    if (!checkCorpusDescriptor(corpus, DescriptorKind::Fft)) return false;
+    unique_ptr<NearestNeighborIndex> index = loadOrBuildIndex(indexKind, corpus, corpusFile);
+    
+    // PASO 1: Descriptores de todos los objetos
+    auto start = chrono::steady_clock::now();
+    vector<ShapeObject> objects;
+    if (jobs > 1) {
+        ThreadPool pool(jobs);
+        objects = extractShapeObjects(img, minArea, &pool);
+    } else {
+        objects = extractShapeObjects(img, minArea);
+    }
+    double extractSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+    // PASO 2: Clasificar cada objeto
+    vector<pair<string, float>> predictions(objects.size());
+    size_t classified = 0;
+    for (size_t i = 0; i < objects.size(); i++) {
+        if (objects[i].features.empty()) continue;
+        predictions[i] = classify(ShapeDescriptor(objects[i].features, ""), *index);
+        classified++;
+    }
+    double totalSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+    // PASO 3: Un objeto por línea: caja (x, y, ancho×alto), etiqueta y distancia
+    cout << "\n OBJETOS (" << objects.size() << " con área >= " << minArea << " px²)" << endl;
+    for (size_t i = 0; i < objects.size(); i++) {
+        const Rect& box = objects[i].box;
+        cout << "  #" << i << " [" << box.x << ", " << box.y << ", " 
+             << box.width << "×" << box.height << "] ";
+        if (objects[i].features.empty()) {
+            cout << "sin descriptor" << endl;
+        } else {
+            cout << predictions[i].first << " (distancia: " << predictions[i].second << ")" << endl;
         }
-        file << "\n";
     }
     
-    file.close();
-    cout << "✓ Corpus guardado: " << filename << " (" 
-         << corpus.size() << " ejemplos)" << endl;
+    cout << "\n Clasificados: " << classified << "/" << objects.size() << endl;
+    cout << " Extracción: " << extractSeconds * 1000 << " ms ("
+         << (extractSeconds > 0 ? objects.size() / extractSeconds : 0.0) << " objetos/s, "
+         << max(1u, jobs) << " hilos)" << endl;
+    cout << " Total: " << totalSeconds * 1000 << " ms ("
+         << (totalSeconds > 0 ? objects.size() / totalSeconds : 0.0) << " objetos/s)" << endl;
+    return true;
 }
 
+// MODO STREAM: VÍDEO O SECUENCIA DE IMÁGENES EN ETAPAS CONCURRENTES
 
-vector<ShapeDescriptor> loadCorpus(const string& filename) {
-    vector<ShapeDescriptor> corpus;
-    ifstream file(filename);
-    
-    if (!file.is_open()) {
-        cerr << " No se pudo abrir archivo: " << filename << endl;
-        return corpus;
+/**
+ * Un fotograma recorre las etapas decodificar → preprocesar → contorno →
+ * descriptor → clasificar; cada etapa rellena su parte y suelta la que ya
+ * no hace falta (los Mat son referencias: moverlos entre colas no copia).
+ */
+struct StreamFrame {
+    long index = -1;
+    Mat image;                      // decodificar
+    Mat binary;                     // preprocesar
+    vector<Point2f> resampled;      // contorno (vacío si no hay forma)
+    vector<float> features;         // descriptor (vacío si no hay forma)
+};
+
+using FrameQueue = BoundedQueue<StreamFrame>;
+
+enum StreamStage { STAGE_DECODE, STAGE_PREPROCESS, STAGE_CONTOUR, STAGE_DESCRIPTOR, STAGE_CLASSIFY,
+                   STREAM_STAGES };
+const char* const STAGE_NAMES[STREAM_STAGES] = {
+    "decodificar", "preprocesar", "contorno", "descriptor", "clasificar"
+};
+
+// Contadores de una etapa (los hilos de la etapa suman con atómicos)
+struct StageStats {
+    unsigned threads = 1;
+    atomic<long> frames{0};
+    atomic<int64_t> busyNs{0};
+    // Profundidad de la cola de entrada, muestreada por el hilo principal
+    double depthSum = 0;
+    size_t depthMax = 0;
+    size_t depthSamples = 0;
+    
+    void record(chrono::steady_clock::time_point start) {
+        busyNs += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+        frames++;
+    }
+};
+
+/**
+ * Lanza los hilos de una etapa intermedia: sacan fotogramas de `in`,
+ * aplican `work` (con un ExtractionContext propio por hilo) y los dejan en
+ * `out`. push espera si `out` está llena, así una etapa lenta frena a las
+ * anteriores. El último hilo de la etapa en terminar cierra `out`.
+ */
+template <typename Work>
+void startStage(vector<thread>& threads, StageStats& stats, FrameQueue& in, FrameQueue& out,
+                Work work) {
+    auto remaining = make_shared<atomic<unsigned>>(stats.threads);
+    for (unsigned t = 0; t < stats.threads; t++) {
+        threads.emplace_back([&stats, &in, &out, work, remaining] {
+            ExtractionContext context;
+            StreamFrame frame;
+            while (in.pop(frame)) {
+                auto start = chrono::steady_clock::now();
+                work(frame, context);
+                stats.record(start);
+                out.push(move(frame));
+            }
+            if (remaining->fetch_sub(1) == 1) out.close();
+        });
+    }
+}
+
+/**
+ * Fuente de fotogramas: un patrón con * o ? (secuencia de imágenes, en
+ * orden de nombre), un número (cámara) o un archivo de vídeo.
+ */
+struct FrameSource {
+    vector<String> files;
+    VideoCapture capture;
+    size_t next = 0;
+    
+    bool open(const string& input) {
+        if (input.find_first_of("*?") != string::npos) {
+            glob(input, files, false);
+            sort(files.begin(), files.end());
+            return !files.empty();
+        }
+        if (!input.empty() && all_of(input.begin(), input.end(), ::isdigit)) {
+            return capture.open(atoi(input.c_str()));
+        }
+        return capture.open(input);
     }
     
-    string line;
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string label;
-        getline(ss, label, ',');
-        
-        vector<float> features;
-        string value;
-        while (getline(ss, value, ',')) {
-            features.push_back(stof(value));
+    bool read(Mat& image) {
+        if (!capture.isOpened()) {
+            while (next < files.size()) {
+                image = imread(files[next++]);
+                if (!image.empty()) return true;
+                cerr << " No se pudo cargar imagen: " << files[next - 1] << endl;
+            }
+            return false;
         }
-        
-        corpus.push_back(ShapeDescriptor(features, label));
+        return capture.read(image) && !image.empty();
+    }
+};
+
+/**
+ * Clasifica un vídeo, una cámara o una secuencia de imágenes con las
+ * etapas del pipeline en hilos concurrentes unidos por colas acotadas sin
+ * cerrojos (BoundedQueue) de `queueCapacity` plazas:
+ * - decodificar: 1 hilo (VideoCapture es secuencial)
+ * - preprocesar, contorno, descriptor: threads[etapa] hilos cada una
+ * - clasificar: 1 hilo (la búsqueda es barata y el KD-tree serializa sus
+ *   consultas de todos modos)
+ * Cada segundo muestra los fotogramas/s; al final, por etapa, el tiempo por
+ * fotograma, la ocupación de sus hilos y la profundidad media/máxima de su
+ * cola de entrada (la etapa con la cola llena delante es el cuello de botella).
+ */
+bool streamFrames(const string& input, const string& corpusFile, IndexKind indexKind,
+                  const unsigned (&threads)[STREAM_STAGES], size_t queueCapacity,
+                  const string& summaryFile) {
+    FrameSource source;
+    if (!source.open(input)) {
+        cerr << " No se pudo abrir la entrada: " << input << endl;
+        return false;
     }
     
-    file.close();
-    cout << "✓ Corpus cargado: " << filename << " (" 
-         << corpus.size() << " ejemplos)" << endl;
+    DescriptorMatrix corpus = loadCorpusMatrix(corpusFile);
+    if (corpus.empty()) {
+        cerr << " No se pudo cargar el corpus" << endl;
+        return false;
+    }
+    if (!checkCorpusDescriptor(corpus, DescriptorKind::Fft)) return false;
+    unique_ptr<NearestNeighborIndex> index = loadOrBuildIndex(indexKind, corpus, corpusFile);
     
-    return corpus;
-}
-
-
-// FUNCIÓN PRINCIPAL: GENERAR CORPUS DE ENTRENAMIENTO
-
-//Genera el corpus de entrenamiento procesando todas las imágenes en train_dir.
-void generateTrainingCorpus() {
-    cout << "\n GENERANDO CORPUS DE ENTRENAMIENTO..." << endl;
+    StageStats stats[STREAM_STAGES];
+    for (int s = 0; s < STREAM_STAGES; s++) stats[s].threads = threads[s];
     
-    vector<ShapeDescriptor> corpus;
-    vector<string> classes = {"circle", "triangle", "square"};
+    // queues[s] = entrada de la etapa s + 1
+    vector<unique_ptr<FrameQueue>> queues;
+    for (int s = 0; s + 1 < STREAM_STAGES; s++) {
+        queues.push_back(make_unique<FrameQueue>(queueCapacity));
+    }
     
-    for (const string& cls : classes) {
-        string classDir = TRAIN_DIR + cls + "/";
-        
-        if (!filesystem::exists(classDir)) {
-            cout << "  Directorio no existe: " << classDir << endl;
-            continue;
+    cout << "\n Stream: " << input << " (colas de " << queues[0]->capacity() << " plazas)" << endl;
+    auto start = chrono::steady_clock::now();
+    vector<thread> workers;
+    
+    // PASO 1: Decodificar
+    workers.emplace_back([&] {
+        StreamFrame frame;
+        for (long index = 0; ; index++) {
+            auto begin = chrono::steady_clock::now();
+            if (!source.read(frame.image)) break;
+            frame.index = index;
+            stats[STAGE_DECODE].record(begin);
+            queues[0]->push(move(frame));
         }
-        
-        for (const auto& entry : filesystem::directory_iterator(classDir)) {
-            if (entry.path().extension() == ".png" || 
-                entry.path().extension() == ".jpg") {
-                
-                Mat img = imread(entry.path().string());
-                if (img.empty()) continue;
-                
-                ShapeDescriptor desc = extractShapeDescriptor(
-                    img, cls, entry.path().filename().string()
-                );
-                
-                if (!desc.features.empty()) {
-                    corpus.push_back(desc);
-                }
+        queues[0]->close();
+    });
+    
+    // PASOS 2-4: Preprocesar, contorno + remuestreo, descriptor
+    startStage(workers, stats[STAGE_PREPROCESS], *queues[0], *queues[1],
+               [](StreamFrame& frame, ExtractionContext& context) {
+        binarizeImage(frame.image, frame.binary, context.gray);
+        frame.image.release();
+    });
+    startStage(workers, stats[STAGE_CONTOUR], *queues[1], *queues[2],
+               [](StreamFrame& frame, ExtractionContext& context) {
+        if (!findLargestContour(frame.binary, context.contour, nullptr, context.contours) ||
+            !resampleContour(context.contour, NUM_POINTS, frame.resampled, context.cumulativeLength)) {
+            frame.resampled.clear();
+        }
+        frame.binary.release();
+    });
+    startStage(workers, stats[STAGE_DESCRIPTOR], *queues[2], *queues[3],
+               [](StreamFrame& frame, ExtractionContext& context) {
+        if (!frame.resampled.empty()) {
+            computeDescriptor(frame.resampled, context.magnitudes, frame.features);
+        }
+    });
+    
+    // PASO 5: Clasificar (resultados por índice de fotograma: las etapas
+    // con varios hilos pueden entregarlos desordenados)
+    vector<pair<string, float>> results;
+    atomic<bool> finished{false};
+    workers.emplace_back([&] {
+        StreamFrame frame;
+        while (queues[3]->pop(frame)) {
+            auto begin = chrono::steady_clock::now();
+            if (results.size() <= static_cast<size_t>(frame.index)) results.resize(frame.index + 1);
+            if (!frame.features.empty()) {
+                results[frame.index] = classify(ShapeDescriptor(frame.features, ""), *index);
             }
+            stats[STAGE_CLASSIFY].record(begin);
+        }
+        finished = true;
+    });
+    
+    // Monitor: profundidad de las colas cada 10 ms, fotogramas/s cada segundo
+    auto lastReport = start;
+    while (!finished) {
+        this_thread::sleep_for(chrono::milliseconds(10));
+        for (int s = 1; s < STREAM_STAGES; s++) {
+            size_t depth = queues[s - 1]->size();
+            stats[s].depthSum += depth;
+            stats[s].depthMax = max(stats[s].depthMax, depth);
+            stats[s].depthSamples++;
+        }
+        
+        auto now = chrono::steady_clock::now();
+        if (now - lastReport >= chrono::seconds(1)) {
+            double seconds = chrono::duration<double>(now - start).count();
+            long done = stats[STAGE_CLASSIFY].frames;
+            cout << "\r  Fotogramas: " << done << " (" << done / seconds << " fps)" << flush;
+            lastReport = now;
+        }
+    }
+    for (thread& worker : workers) worker.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+    // PASO 6: Informe por etapa y resultados
+    long frames = stats[STAGE_CLASSIFY].frames;
+    cout << "\n\n ETAPAS" << endl;
+    cout << "  etapa         hilos   ms/fotograma   ocupación   cola media   cola máx" << endl;
+    for (int s = 0; s < STREAM_STAGES; s++) {
+        const StageStats& stage = stats[s];
+        double busySeconds = stage.busyNs / 1e9;
+        double perFrame = stage.frames > 0 ? busySeconds * 1000 / stage.frames : 0.0;
+        double occupancy = seconds > 0 ? 100.0 * busySeconds / (seconds * stage.threads) : 0.0;
+        char line[160];
+        if (s == STAGE_DECODE) {
+            snprintf(line, sizeof(line), "  %-13s %5u %14.3f %10.1f%% %12s %10s",
+                     STAGE_NAMES[s], stage.threads, perFrame, occupancy, "-", "-");
+        } else {
+            double meanDepth = stage.depthSamples > 0 ? stage.depthSum / stage.depthSamples : 0.0;
+            snprintf(line, sizeof(line), "  %-13s %5u %14.3f %10.1f%% %12.2f %10zu",
+                     STAGE_NAMES[s], stage.threads, perFrame, occupancy, meanDepth, stage.depthMax);
         }
+        cout << line << endl;
     }
     
-    saveCorpus(corpus, "data/corpus.csv");
+    map<string, int> counts;
+    size_t classified = 0;
+    for (const auto& [label, distance] : results) {
+        if (label.empty()) continue;
+        counts[label]++;
+        classified++;
+    }
+    cout << "\n Fotogramas: " << frames << " en " << seconds << " s (" 
+         << (seconds > 0 ? frames / seconds : 0.0) << " fps)" << endl;
+    cout << " Con forma: " << classified << "/" << frames << endl;
+    for (const auto& [label, count] : counts) {
+        cout << "  " << label << ": " << count << endl;
+    }
     
-    cout << "\n CORPUS GENERADO: " << corpus.size() << " ejemplos" << endl;
+    if (!summaryFile.empty()) {
+        ofstream out(summaryFile);
+        out << "frame,predicted,distance\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            out << i << "," << results[i].first << "," << results[i].second << "\n";
+        }
+        cout << " Resultados por fotograma guardados en: " << summaryFile << endl;
+    }
+    return true;
 }
 
-// FUNCIÓN PRINCIPAL: EVALUAR EN DATASET DE PRUEBA
+// MODO TRACK: SEGUIMIENTO POR ROI FRENTE AL FOTOGRAMA COMPLETO
 
-void evaluateTestSet() {
-    cout << "\n EVALUANDO DATASET DE PRUEBA..." << endl;
+// Percentil p (0-100) de una lista de tiempos (la reordena)
+double percentile(vector<double>& values, double p) {
+    if (values.empty()) return 0.0;
+    size_t k = min(values.size() - 1, static_cast<size_t>(p / 100.0 * values.size()));
+    nth_element(values.begin(), values.begin() + k, values.end());
+    return values[k];
+}
+
+/**
+ * Procesa una secuencia grabada dos veces por fotograma: con RoiTracker
+ * (sólo las cajas anteriores ampliadas, barrido completo periódico) y con
+ * extractShapeObjects sobre el fotograma entero. Informa de la fracción de
+ * píxeles binarizados, la latencia media y p95 por fotograma de cada
+ * camino y de la coincidencia de etiquetas: cada objeto seguido se compara
+ * con el objeto del barrido completo con el que más se solapa.
+ */
+bool trackFrames(const string& input, const string& corpusFile, IndexKind indexKind,
+                 int margin, int rescanInterval, double minArea) {
+    FrameSource source;
+    if (!source.open(input)) {
+        cerr << " No se pudo abrir la entrada: " << input << endl;
+        return false;
+    }
     
-    // Cargar corpus
-    auto corpus = loadCorpus("data/corpus.csv");
+    DescriptorMatrix corpus = loadCorpusMatrix(corpusFile);
     if (corpus.empty()) {
         cerr << " No se pudo cargar el corpus" << endl;
-        return;
+        return false;
     }
-    
-    // Matriz de confusión
-    map<string, map<string, int>> confusionMatrix;
-    vector<string> classes = {"circle", "triangle", "square"};
-    
-    for (const string& cls : classes) {
-        string classDir = TEST_DIR + cls + "/";
+    if (!checkCorpusDescriptor(corpus, DescriptorKind::Fft)) return false;
+    unique_ptr<NearestNeighborIndex> index = loadOrBuildIndex(indexKind, corpus, corpusFile);
+    
+    RoiTracker tracker(margin, rescanInterval, minArea);
+    vector<double> trackMs, fullMs;
+    size_t trackPixels = 0, framePixels = 0, fullScans = 0, lost = 0;
+    size_t trackedObjects = 0, fullObjects = 0, compared = 0, agreed = 0;
+    
+    cout << "\n Seguimiento: " << input << " (margen " << margin << " px, barrido cada "
+         << rescanInterval << " fotogramas)" << endl;
+    
+    Mat frame;
+    while (source.read(frame)) {
+        // PASO 1: Seguimiento por ROI
+        auto start = chrono::steady_clock::now();
+        TrackingStats stats;
+        const vector<TrackedObject>& tracked = tracker.update(frame, &stats);
+        trackMs.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
         
-        if (!filesystem::exists(classDir)) {
-            cout << "  Directorio no existe: " << classDir << endl;
-            continue;
-        }
+        // PASO 2: Referencia, fotograma completo
+        start = chrono::steady_clock::now();
+        vector<ShapeObject> full = extractShapeObjects(frame, minArea);
+        fullMs.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
         
-        for (const auto& entry : filesystem::directory_iterator(classDir)) {
-            if (entry.path().extension() == ".png" || 
-                entry.path().extension() == ".jpg") {
-                
-                Mat img = imread(entry.path().string());
-                if (img.empty()) continue;
-                
-                ShapeDescriptor desc = extractShapeDescriptor(
-                    img, cls, entry.path().filename().string()
-                );
-                
-                if (desc.features.empty()) continue;
-                
-                auto [predicted, distance] = classify(desc, corpus);
-                
-                confusionMatrix[cls][predicted]++;
-                
-                string status = (predicted == cls) ? "✓" : "✗";
-                cout << status << " Real: " << cls << " | Predicho: " 
-                     << predicted << " | Distancia: " << distance << endl;
+        trackPixels += stats.pixels;
+        framePixels += frame.total();
+        fullScans += stats.fullScan;
+        lost += stats.lost;
+        trackedObjects += tracked.size();
+        fullObjects += full.size();
+        
+        // PASO 3: Misma etiqueta que el objeto del barrido completo más solapado
+        for (const TrackedObject& object : tracked) {
+            const ShapeObject* match = nullptr;
+            int bestOverlap = 0;
+            for (const ShapeObject& candidate : full) {
+                int overlap = (object.box & candidate.box).area();
+                if (overlap > bestOverlap) {
+                    bestOverlap = overlap;
+                    match = &candidate;
+                }
             }
+            if (match == nullptr || object.features.empty() || match->features.empty()) continue;
+            
+            compared++;
+            string trackedLabel = classify(ShapeDescriptor(object.features, ""), *index).first;
+            string fullLabel = classify(ShapeDescriptor(match->features, ""), *index).first;
+            agreed += trackedLabel == fullLabel;
         }
     }
     
-    // Imprimir matriz de confusión
-    cout << "\n MATRIZ DE CONFUSIÓN:" << endl;
-    cout << "           ";
-    for (const auto& c : classes) cout << c << "\t";
-    cout << endl;
+    size_t frames = trackMs.size();
+    if (frames == 0) {
+        cerr << " La entrada no tiene fotogramas" << endl;
+        return false;
+    }
     
-    for (const auto& real : classes) {
-        cout << real << "\t";
-        for (const auto& pred : classes) {
-            cout << confusionMatrix[real][pred] << "\t";
-        }
-        cout << endl;
+    double trackMean = accumulate(trackMs.begin(), trackMs.end(), 0.0) / frames;
+    double fullMean = accumulate(fullMs.begin(), fullMs.end(), 0.0) / frames;
+    
+    cout << "\n Fotogramas: " << frames << " (" << fullScans << " con barrido completo)" << endl;
+    cout << " Píxeles binarizados: " << 100.0 * trackPixels / framePixels 
+         << "% del fotograma completo" << endl;
+    cout << " Latencia ROI:      media " << trackMean << " ms, p95 " << percentile(trackMs, 95) << " ms" << endl;
+    cout << " Latencia completa: media " << fullMean << " ms, p95 " << percentile(fullMs, 95) << " ms" << endl;
+    cout << " Aceleración media: " << (trackMean > 0 ? fullMean / trackMean : 0.0) << "x" << endl;
+    cout << " Objetos por fotograma: " << static_cast<double>(trackedObjects) / frames 
+         << " (completo: " << static_cast<double>(fullObjects) / frames << "), perdidos: " << lost << endl;
+    cout << " Misma etiqueta que el fotograma completo: " << agreed << "/" << compared << endl;
+    return true;
+}
+
+// MAIN: MENÚ PRINCIPAL
+
+// Devuelve el valor que sigue a `name` en la línea de comandos, o "" si no está
+string findOption(int argc, char** argv, const string& name) {
+    for (int i = 2; i + 1 < argc; i++) {
+        if (string(argv[i]) == name) return argv[i + 1];
     }
+    return "";
+}
+
+bool hasFlag(int argc, char** argv, const string& name) {
+    for (int i = 2; i < argc; i++) {
+        if (string(argv[i]) == name) return true;
+    }
+    return false;
+}
+
+/**
+ * Nivel de log para los modos por lotes: sólo mensajes por operación, sin
+ * formatear nada por etapa. --verbose recupera los mensajes de cada etapa.
+ */
+void configureBatchLogging(int argc, char** argv) {
+    setLogLevel(hasFlag(argc, argv, "--verbose") ? LogLevel::Debug : LogLevel::Info);
+}
+
+/**
+ * Lee la opción "--jobs N" de la línea de comandos.
+ * Sin la opción se usa 1 hilo; N = 0 usa un hilo por núcleo.
+ */
+unsigned parseJobs(int argc, char** argv) {
+    string value = findOption(argc, argv, "--jobs");
+    if (value.empty()) return 1;
     
-    // Calcular accuracy
-    int total = 0, correct = 0;
-    for (const auto& cls : classes) {
-        correct += confusionMatrix[cls][cls];
-        for (const auto& pred : classes) {
-            total += confusionMatrix[cls][pred];
-        }
+    int jobs = atoi(value.c_str());
+    if (jobs == 0) return max(1u, thread::hardware_concurrency());
+    return jobs > 0 ? jobs : 1;
+}
+
+/**
+ * Lee la opción "--<name> N" con N >= 1 (hilos de una etapa de stream,
+ * plazas de cola...). Sin la opción se usa `fallback`.
+ */
+unsigned parseCount(int argc, char** argv, const string& name, unsigned fallback) {
+    string value = findOption(argc, argv, name);
+    if (value.empty()) return fallback;
+    return static_cast<unsigned>(max(1, atoi(value.c_str())));
+}
+
+/**
+ * Lee la opción "--descriptor fft|hu|zernike" (por defecto fft).
+ * Devuelve false si el nombre no es válido.
+ */
+bool parseDescriptor(int argc, char** argv, DescriptorKind& kind) {
+    kind = DescriptorKind::Fft;
+    
+    string value = findOption(argc, argv, "--descriptor");
+    if (value.empty()) return true;
+    
+    if (!parseDescriptorKind(value, kind)) {
+        cerr << " Descriptor no válido: " << value << " (fft, hu o zernike)" << endl;
+        return false;
     }
+    return true;
+}
+
+/**
+ * Lee la opción "--index brute|kdtree|hnsw" (por defecto brute).
+ * Devuelve false si el nombre no es válido.
+ */
+bool parseIndex(int argc, char** argv, IndexKind& kind) {
+    kind = IndexKind::BruteForce;
     
-    float accuracy = (total > 0) ? (100.0f * correct / total) : 0.0f;
-    cout << "\n ACCURACY: " << accuracy << "%" << endl;
+    string value = findOption(argc, argv, "--index");
+    if (value.empty()) return true;
+    
+    if (!parseIndexKind(value, kind)) {
+        cerr << " Índice no válido: " << value << " (brute, kdtree o hnsw)" << endl;
+        return false;
+    }
+    return true;
 }
 
-// MAIN: MENÚ PRINCIPAL
+/**
+ * Lee la opción "--k N": vecinos que votan en la clasificación por lotes.
+ * Sin la opción, k = 1 (vecino más cercano).
+ */
+int parseK(int argc, char** argv) {
+    string value = findOption(argc, argv, "--k");
+    if (value.empty()) return 1;
+    return max(1, atoi(value.c_str()));
+}
+
+/**
+ * Lee la opción "--quantize f16|int8" ("" sin la opción).
+ * Devuelve false si el nombre no es válido.
+ */
+bool parseQuantize(int argc, char** argv, string& quantization) {
+    quantization = findOption(argc, argv, "--quantize");
+    Quantization kind;
+    if (!quantization.empty() && !parseQuantization(quantization, kind)) {
+        cerr << " Cuantización no válida: " << quantization << " (f16 o int8)" << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Lee la opción "--shard i/N". Devuelve false si el formato no es válido.
+ * Sin la opción: shard 0 de 1 (todo el directorio).
+ */
+bool parseShard(int argc, char** argv, int& shardIndex, int& shardCount) {
+    shardIndex = 0;
+    shardCount = 1;
+    
+    string value = findOption(argc, argv, "--shard");
+    if (value.empty()) return true;
+    
+    if (sscanf(value.c_str(), "%d/%d", &shardIndex, &shardCount) != 2 ||
+        shardCount < 1 || shardIndex < 0 || shardIndex >= shardCount) {
+        cerr << " Shard no válido: " << value << " (formato i/N, 0 <= i < N)" << endl;
+        return false;
+    }
+    return true;
+}
 
 int main(int argc, char** argv) {
+    setLogSink(consoleLogSink);
+    
     cout << "================================================" << endl;
     cout << "  SHAPE SIGNATURE - FFT COORDENADAS COMPLEJAS  " << endl;
     cout << "       Práctica 3-2 - Visión por Computador    " << endl;
@@ -561,18 +1181,77 @@ int main(int argc, char** argv) {
     if (argc < 2) {
         cout << "\nUso:" << endl;
         cout << "  ./shape_app train         - Generar corpus de entrenamiento" << endl;
+        cout << "      [--jobs N]            - N hilos (0 = todos los núcleos)" << endl;
         cout << "  ./shape_app test          - Evaluar dataset de prueba" << endl;
+        cout << "      [--jobs N] [--shard i/N] - N hilos / procesar sólo el shard i de N" << endl;
+        cout << "      [--k N]               - k vecinos con votación (por defecto 1)" << endl;
+        cout << "      [--quantize f16|int8] - Comparar memoria y precisión con el corpus cuantizado" << endl;
+        cout << "  ./shape_app merge <f>...  - Unir resultados parciales de los shards" << endl;
+        cout << "  Opciones de train/test: --summary <csv> (registro por imagen)," << endl;
+        cout << "                          --descriptor fft|hu|zernike (también classify e index; por" << endl;
+        cout << "                          defecto fft, corpus data/corpus.csv o data/corpus_<descriptor>.csv;" << endl;
+        cout << "                          classify-all, stream y track sólo admiten fft)," << endl;
+        cout << "                          --verbose (mensajes de cada etapa)" << endl;
         cout << "  ./shape_app classify <img> - Clasificar una imagen" << endl;
+        cout << "  ./shape_app classify-all <img> - Clasificar todas las formas de la imagen" << endl;
+        cout << "      [--jobs N] [--min-area A] - N hilos / área mínima por objeto (px², por defecto "
+             << MIN_OBJECT_AREA << ")" << endl;
+        cout << "  ./shape_app stream <vídeo|patrón|cámara> - Clasificar fotogramas en etapas concurrentes" << endl;
+        cout << "      [--preprocess N] [--contour N] [--descriptor-threads N] - hilos por etapa (por defecto 1)" << endl;
+        cout << "      [--queue N] [--summary <csv>] - plazas por cola (8) / resultado por fotograma" << endl;
+        cout << "  ./shape_app track <vídeo|patrón|cámara> - Seguimiento por ROI frente al fotograma completo" << endl;
+        cout << "      [--margin N] [--rescan N] [--min-area A] - margen de la ROI (px) / barrido completo cada N" << endl;
+        cout << "  ./shape_app convert <in> <out> - Corpus CSV ↔ binario (según la firma de <in>)" << endl;
+        cout << "  ./shape_app index         - Construir el índice y medir recall y consultas/s" << endl;
+        cout << "  Opciones de test/classify/classify-all/stream/track/index: --corpus <archivo> (CSV o binario," << endl;
+        cout << "                           por defecto data/corpus.csv)," << endl;
+        cout << "                           --index brute|kdtree|hnsw (se guarda junto al corpus)" << endl;
         return 0;
     }
     
     string mode = argv[1];
     
+    DescriptorKind descriptorKind;
+    if (!parseDescriptor(argc, argv, descriptorKind)) return -1;
+    
+    // classify-all, stream y track sólo extraen la firma FFT
+    if ((mode == "classify-all" || mode == "stream" || mode == "track") &&
+        descriptorKind != DescriptorKind::Fft) {
+        cerr << " El modo " << mode << " sólo admite --descriptor fft" << endl;
+        return -1;
+    }
+    
+    // Corpus de entrenamiento: CSV o binario (se detecta por la firma)
+    string corpusFile = findOption(argc, argv, "--corpus");
+    if (corpusFile.empty()) corpusFile = defaultCorpusFile(descriptorKind);
+    
+    IndexKind indexKind;
+    if (!parseIndex(argc, argv, indexKind)) return -1;
+    
     if (mode == "train") {
-        generateTrainingCorpus();
+        configureBatchLogging(argc, argv);
+        generateTrainingCorpus(parseJobs(argc, argv), findOption(argc, argv, "--summary"), descriptorKind);
     } 
     else if (mode == "test") {
-        evaluateTestSet();
+        int shardIndex, shardCount;
+        if (!parseShard(argc, argv, shardIndex, shardCount)) return -1;
+        string quantization;
+        if (!parseQuantize(argc, argv, quantization)) return -1;
+        configureBatchLogging(argc, argv);
+        evaluateTestSet(corpusFile, indexKind, parseK(argc, argv), parseJobs(argc, argv),
+                        shardIndex, shardCount, findOption(argc, argv, "--summary"), quantization,
+                        descriptorKind);
+    } 
+    else if (mode == "convert" && argc >= 4) {
+        if (!convertCorpus(argv[2], argv[3])) return -1;
+    } 
+    else if (mode == "index") {
+        // Sin --index se evalúa HNSW (la fuerza bruta es la referencia)
+        if (findOption(argc, argv, "--index").empty()) indexKind = IndexKind::Hnsw;
+        if (!reportIndex(corpusFile, indexKind)) return -1;
+    } 
+    else if (mode == "merge" && argc >= 3) {
+        mergeResults(vector<string>(argv + 2, argv + argc));
     } 
     else if (mode == "classify" && argc >= 3) {
         string imgPath = argv[2];
@@ -583,15 +1262,48 @@ int main(int argc, char** argv) {
             return -1;
         }
         
-        auto corpus = loadCorpus("data/corpus.csv");
-        auto desc = extractShapeDescriptor(img, "", imgPath);
+        DescriptorMatrix corpus = loadCorpusMatrix(corpusFile);
+        if (!checkCorpusDescriptor(corpus, descriptorKind)) return -1;
+        unique_ptr<NearestNeighborIndex> index = loadOrBuildIndex(indexKind, corpus, corpusFile);
+        auto desc = extractDescriptor(descriptorKind, img, "", imgPath);
         
         if (!desc.features.empty()) {
-            auto [predicted, distance] = classify(desc, corpus);
+            auto [predicted, distance] = classify(desc, *index);
             cout << "\n RESULTADO: " << predicted 
                  << " (distancia: " << distance << ")" << endl;
         }
     } 
+    else if (mode == "classify-all" && argc >= 3) {
+        string minArea = findOption(argc, argv, "--min-area");
+        if (!classifyAllObjects(argv[2], corpusFile, indexKind, parseJobs(argc, argv),
+                                minArea.empty() ? MIN_OBJECT_AREA : atof(minArea.c_str()))) {
+            return -1;
+        }
+    } 
+    else if (mode == "stream" && argc >= 3) {
+        const unsigned threads[STREAM_STAGES] = {
+            1,
+            parseCount(argc, argv, "--preprocess", 1),
+            parseCount(argc, argv, "--contour", 1),
+            parseCount(argc, argv, "--descriptor-threads", 1),
+            1
+        };
+        configureBatchLogging(argc, argv);
+        if (!streamFrames(argv[2], corpusFile, indexKind, threads, parseCount(argc, argv, "--queue", 8),
+                          findOption(argc, argv, "--summary"))) {
+            return -1;
+        }
+    } 
+    else if (mode == "track" && argc >= 3) {
+        string minArea = findOption(argc, argv, "--min-area");
+        configureBatchLogging(argc, argv);
+        if (!trackFrames(argv[2], corpusFile, indexKind,
+                         static_cast<int>(parseCount(argc, argv, "--margin", TRACK_MARGIN)),
+                         static_cast<int>(parseCount(argc, argv, "--rescan", TRACK_RESCAN_INTERVAL)),
+                         minArea.empty() ? MIN_OBJECT_AREA : atof(minArea.c_str()))) {
+            return -1;
+        }
+    } 
     else {
         cerr << " Modo no reconocido: " << mode << endl;
         return -1;
@@ -0,0 +1,147 @@
+/**
+ * Cola acotada sin cerrojos, varios productores / varios consumidores.
+ *
+ * Anillo de capacidad potencia de dos en el que cada celda lleva un número
+ * de secuencia (esquema de D. Vyukov): productores y consumidores reservan
+ * posición con un compare-exchange sobre su contador y la secuencia de la
+ * celda indica si ya está llena o vacía. Sin mutex ni reservas tras la
+ * construcción.
+ *
+ * push() espera mientras la cola está llena (contrapresión: una etapa
+ * lenta frena a las anteriores en lugar de acumular fotogramas) y pop()
+ * mientras está vacía; la espera gira un poco, después cede el núcleo y
+ * finalmente duerme unos µs. close() marca el fin del flujo: pop() devuelve
+ * false cuando la cola está cerrada y vacía.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+template <typename T>
+class BoundedQueue {
+public:
+    // capacity se redondea a la siguiente potencia de dos (mínimo 2)
+    explicit BoundedQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size *= 2;
+        mask_ = size - 1;
+        cells_ = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; i++) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    size_t capacity() const { return mask_ + 1; }
+
+    /**
+     * Elementos en la cola (aproximado con hilos activos; para monitorizar).
+     * Las dos posiciones se leen por separado: entre una lectura y otra
+     * pueden avanzar las dos, así que la diferencia se limita a [0, capacity].
+     */
+    size_t size() const {
+        size_t tail = dequeuePos_.load(std::memory_order_relaxed);
+        size_t head = enqueuePos_.load(std::memory_order_relaxed);
+        return head > tail ? std::min(head - tail, capacity()) : 0;
+    }
+
+    // Sin esperar: false si la cola está llena
+    bool tryPush(T& item) {
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells_[pos & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(item);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // la celda aún guarda un elemento sin consumir
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Sin esperar: false si la cola está vacía
+    bool tryPop(T& item) {
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells_[pos & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    item = std::move(cell.value);
+                    cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // la celda aún no se ha llenado
+            } else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Espera mientras la cola esté llena (no se debe llamar tras close)
+    void push(T item) {
+        for (int attempt = 0; !tryPush(item); attempt++) {
+            backoff(attempt);
+        }
+    }
+
+    // Espera un elemento; false si la cola está cerrada y vacía
+    bool pop(T& item) {
+        for (int attempt = 0; ; attempt++) {
+            if (tryPop(item)) return true;
+            if (closed_.load(std::memory_order_acquire)) {
+                // Todo push ocurrió antes de close: un último intento basta
+                return tryPop(item);
+            }
+            backoff(attempt);
+        }
+    }
+
+    // Fin del flujo: lo llama el último productor tras su último push
+    void close() { closed_.store(true, std::memory_order_release); }
+
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T value;
+    };
+
+    // Girar es lo más rápido si la espera es corta; después no quemar el núcleo
+    static void backoff(int attempt) {
+        if (attempt < 64) return;
+        if (attempt < 1024) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_ = 0;
+
+    // Contadores en líneas de caché distintas: productores y consumidores no se pisan
+    alignas(64) std::atomic<size_t> enqueuePos_{0};
+    alignas(64) std::atomic<size_t> dequeuePos_{0};
+    alignas(64) std::atomic<bool> closed_{false};
+};
@@ -0,0 +1,78 @@
+/**
+ * Remuestreo de un contorno cerrado a un número fijo de puntos equidistantes
+ * (interpolación lineal sobre la longitud de arco).
+ *
+ * Se recorre el contorno una sola vez con dos punteros: el índice del
+ * segmento actual sólo avanza, porque las posiciones objetivo son
+ * crecientes. Coste O(n + m) en lugar de O(n · m) de reiniciar la búsqueda
+ * para cada muestra.
+ *
+ * El contorno se trata como cerrado: el segmento último → primero también
+ * forma parte de la longitud total.
+ */
+
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <cmath>
+#include <vector>
+
+/**
+ * Versión sin reservas de memoria: `interpolated` y `cumulativeLength` se
+ * reutilizan entre llamadas (sólo crecen si hace falta).
+ * Devuelve false si el contorno tiene menos de 3 puntos.
+ */
+template <typename PointT>
+bool resampleContour(const std::vector<PointT>& contour, int numPoints,
+                     std::vector<cv::Point2f>& interpolated,
+                     std::vector<float>& cumulativeLength) {
+    const int n = static_cast<int>(contour.size());
+    if (n < 3 || numPoints <= 0) {
+        interpolated.clear();
+        return false;
+    }
+
+    // Longitud acumulada incluyendo el segmento de cierre: cumulativeLength[n] = perímetro
+    cumulativeLength.resize(n + 1);
+    cumulativeLength[0] = 0.0f;
+    for (int i = 1; i <= n; i++) {
+        const PointT& a = contour[i - 1];
+        const PointT& b = contour[i == n ? 0 : i];
+        float dx = static_cast<float>(b.x) - static_cast<float>(a.x);
+        float dy = static_cast<float>(b.y) - static_cast<float>(a.y);
+        cumulativeLength[i] = cumulativeLength[i - 1] + std::sqrt(dx * dx + dy * dy);
+    }
+
+    const float totalLength = cumulativeLength[n];
+    interpolated.resize(numPoints);
+
+    int seg = 0;  // segmento actual: contour[seg] → contour[seg + 1] (mod n)
+    for (int i = 0; i < numPoints; i++) {
+        float targetLength = (totalLength * i) / numPoints;
+
+        while (seg < n - 1 && cumulativeLength[seg + 1] < targetLength) {
+            seg++;
+        }
+
+        const PointT& a = contour[seg];
+        const PointT& b = contour[seg + 1 == n ? 0 : seg + 1];
+        float segmentLength = cumulativeLength[seg + 1] - cumulativeLength[seg];
+        float t = (segmentLength > 0.0f)
+            ? (targetLength - cumulativeLength[seg]) / segmentLength
+            : 0.0f;
+
+        interpolated[i].x = (1 - t) * a.x + t * b.x;
+        interpolated[i].y = (1 - t) * a.y + t * b.y;
+    }
+
+    return true;
+}
+
+// Versión cómoda que devuelve un vector nuevo (vacío si el contorno no es válido)
+template <typename PointT>
+std::vector<cv::Point2f> resampleContour(const std::vector<PointT>& contour, int numPoints) {
+    std::vector<cv::Point2f> interpolated;
+    std::vector<float> cumulativeLength;
+    resampleContour(contour, numPoints, interpolated, cumulativeLength);
+    return interpolated;
+}
@@ -0,0 +1,235 @@
+#include "corpus_binary.h"
+
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SHAPE_HAVE_MMAP 1
+#endif
+
+#include "corpus_io.h"
+#include "shape_log.h"
+
+using namespace std;
+
+namespace {
+
+const char CORPUS_MAGIC[4] = {'S', 'H', 'P', 'C'};
+const size_t DATA_ALIGNMENT = 64;
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+#ifdef SHAPE_HAVE_MMAP
+// Región mapeada; se desmapea al destruirse la última vista
+struct MappedFile {
+    void* address = MAP_FAILED;
+    size_t size = 0;
+    
+    ~MappedFile() {
+        if (address != MAP_FAILED) munmap(address, size);
+    }
+};
+#endif
+
+}  // namespace
+
+bool isBinaryCorpus(const void* data, size_t size) {
+    return size >= sizeof(CorpusFileHeader) && memcmp(data, CORPUS_MAGIC, 4) == 0;
+}
+
+bool isBinaryCorpusFile(const string& filename) {
+    ifstream file(filename, ios::binary);
+    char magic[4] = {};
+    file.read(magic, sizeof(magic));
+    return file.gcount() == 4 && memcmp(magic, CORPUS_MAGIC, 4) == 0;
+}
+
+bool saveCorpusBinary(const DescriptorMatrix& corpus, const string& filename) {
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        SHAPE_LOGE("No se pudo crear archivo: %s", filename.c_str());
+        return false;
+    }
+    
+    // Tabla de clases
+    string classTable;
+    for (const string& name : corpus.classNames()) {
+        uint32_t length = name.size();
+        classTable.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        classTable.append(name);
+    }
+    
+    CorpusFileHeader header;
+    memcpy(header.magic, CORPUS_MAGIC, 4);
+    header.version = CORPUS_BINARY_VERSION;
+    header.dim = corpus.dim();
+    header.stride = corpus.stride();
+    header.rows = corpus.rows();
+    header.numClasses = corpus.classNames().size();
+    header.dataOffset = alignUp(sizeof(header) + classTable.size(), DATA_ALIGNMENT);
+    
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(classTable.data(), classTable.size());
+    
+    string padding(header.dataOffset - sizeof(header) - classTable.size(), '\0');
+    file.write(padding.data(), padding.size());
+    
+    file.write(reinterpret_cast<const char*>(corpus.data()), 
+               sizeof(float) * static_cast<size_t>(corpus.rows()) * corpus.stride());
+    file.write(reinterpret_cast<const char*>(corpus.labels()), 
+               sizeof(int32_t) * static_cast<size_t>(corpus.rows()));
+    
+    if (!file.good()) {
+        SHAPE_LOGE("Error escribiendo %s", filename.c_str());
+        return false;
+    }
+    
+    SHAPE_LOGI("Corpus binario guardado: %s (%d ejemplos)", filename.c_str(), corpus.rows());
+    return true;
+}
+
+DescriptorMatrix corpusFromBinaryBuffer(const void* data, size_t size,
+                                        shared_ptr<const void> storage) {
+    if (!isBinaryCorpus(data, size)) {
+        SHAPE_LOGE("Corpus binario no válido (firma incorrecta)");
+        return DescriptorMatrix();
+    }
+    
+    CorpusFileHeader header;
+    memcpy(&header, data, sizeof(header));
+    
+    if (header.version != CORPUS_BINARY_VERSION) {
+        SHAPE_LOGE("Versión de corpus binario no soportada: %u", header.version);
+        return DescriptorMatrix();
+    }
+    
+    // Campos de la cabecera sin verificar: comprobaciones por resta y
+    // división para que un fichero dañado no desborde los tamaños
+    if (header.dim == 0 || header.stride < header.dim ||
+        header.rows > static_cast<uint32_t>(INT_MAX) ||
+        header.dataOffset < sizeof(header) || header.dataOffset > size) {
+        SHAPE_LOGE("Corpus binario truncado o con cabecera inconsistente");
+        return DescriptorMatrix();
+    }
+    size_t available = size - header.dataOffset;
+    size_t labelBytes = sizeof(int32_t) * static_cast<size_t>(header.rows);
+    if (labelBytes > available ||
+        (header.rows > 0 && header.stride > (available - labelBytes) / sizeof(float) / header.rows)) {
+        SHAPE_LOGE("Corpus binario truncado o con cabecera inconsistente");
+        return DescriptorMatrix();
+    }
+    size_t matrixBytes = sizeof(float) * static_cast<size_t>(header.rows) * header.stride;
+    
+    // Tabla de clases (lo único que se copia: unos pocos nombres)
+    const char* bytes = static_cast<const char*>(data);
+    size_t offset = sizeof(header);
+    vector<string> classNames;
+    for (uint32_t c = 0; c < header.numClasses; c++) {
+        uint32_t length;
+        if (offset + sizeof(length) > header.dataOffset) break;
+        memcpy(&length, bytes + offset, sizeof(length));
+        offset += sizeof(length);
+        if (offset + length > header.dataOffset) break;
+        classNames.push_back(string(bytes + offset, length));
+        offset += length;
+    }
+    
+    if (classNames.size() != header.numClasses) {
+        SHAPE_LOGE("Tabla de clases del corpus binario dañada");
+        return DescriptorMatrix();
+    }
+    
+    const char* matrix = bytes + header.dataOffset;
+    const char* labels = matrix + matrixBytes;
+    
+    // Etiquetas dentro de la tabla de clases en los dos caminos: la vista
+    // sin copia indexa classNames con ellas directamente
+    for (uint32_t r = 0; r < header.rows; r++) {
+        int32_t labelId;
+        memcpy(&labelId, labels + sizeof(int32_t) * r, sizeof(labelId));
+        if (labelId < 0 || labelId >= static_cast<int32_t>(classNames.size())) {
+            SHAPE_LOGE("Etiqueta fuera de rango en el corpus binario");
+            return DescriptorMatrix();
+        }
+    }
+    
+    // Acceso directo si la matriz está alineada y ya tiene el stride con
+    // relleno que espera DescriptorMatrix; si no, se reempaqueta
+    bool aligned = reinterpret_cast<uintptr_t>(matrix) % alignof(float) == 0;
+    if (!aligned || header.stride != static_cast<uint32_t>(paddedStride(header.dim))) {
+        DescriptorMatrixBuilder builder;
+        builder.reserve(header.rows);
+        
+        vector<float> features(header.dim);
+        for (uint32_t r = 0; r < header.rows; r++) {
+            memcpy(features.data(), matrix + sizeof(float) * static_cast<size_t>(r) * header.stride, 
+                   sizeof(float) * header.dim);
+            int32_t labelId;
+            memcpy(&labelId, labels + sizeof(int32_t) * r, sizeof(labelId));
+            builder.add(features.data(), header.dim, classNames[labelId]);
+        }
+        return builder.build();
+    }
+    
+    return DescriptorMatrix::view(
+        reinterpret_cast<const float*>(matrix),
+        reinterpret_cast<const int32_t*>(labels),
+        header.rows, header.dim,
+        std::move(classNames), std::move(storage)
+    );
+}
+
+DescriptorMatrix loadCorpusBinary(const string& filename) {
+#ifdef SHAPE_HAVE_MMAP
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        SHAPE_LOGE("No se pudo abrir archivo: %s", filename.c_str());
+        return DescriptorMatrix();
+    }
+    
+    struct stat info;
+    auto mapping = make_shared<MappedFile>();
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        mapping->size = info.st_size;
+        mapping->address = mmap(nullptr, mapping->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    
+    if (mapping->address == MAP_FAILED) {
+        SHAPE_LOGE("No se pudo mapear %s", filename.c_str());
+        return DescriptorMatrix();
+    }
+    
+    const void* address = mapping->address;
+    DescriptorMatrix corpus = corpusFromBinaryBuffer(address, mapping->size, mapping);
+#else
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        SHAPE_LOGE("No se pudo abrir archivo: %s", filename.c_str());
+        return DescriptorMatrix();
+    }
+    
+    auto buffer = make_shared<vector<char>>(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    DescriptorMatrix corpus = corpusFromBinaryBuffer(buffer->data(), buffer->size(), buffer);
+#endif
+    
+    if (!corpus.empty()) {
+        SHAPE_LOGI("Corpus binario cargado: %s (%d ejemplos)", filename.c_str(), corpus.rows());
+    }
+    return corpus;
+}
+
+DescriptorMatrix loadCorpusMatrix(const string& filename) {
+    if (isBinaryCorpusFile(filename)) {
+        return loadCorpusBinary(filename);
+    }
+    return loadCorpus(filename);
+}
@@ -0,0 +1,60 @@
+/**
+ * Formato binario del corpus, pensado para mapearse en memoria sin parsear
+ * ni copiar la matriz de características.
+ *
+ * Disposición (little-endian):
+ *
+ *   CorpusFileHeader                         (32 bytes)
+ *   tabla de clases: por clase, uint32 longitud + bytes UTF-8 (sin '\0')
+ *   relleno hasta dataOffset (múltiplo de 64)
+ *   float32 [rows × stride]                  características, fila a fila
+ *   int32   [rows]                           índice de clase por fila
+ *
+ * El corpus CSV sigue siendo el formato de intercambio; `shape_app convert`
+ * pasa de uno a otro.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "descriptor_matrix.h"
+
+const uint32_t CORPUS_BINARY_VERSION = 1;
+
+struct CorpusFileHeader {
+    char magic[4];              // "SHPC"
+    uint32_t version;           // CORPUS_BINARY_VERSION
+    uint32_t dim;               // armónicos por descriptor
+    uint32_t stride;            // floats por fila en disco (>= dim, relleno a 0)
+    uint32_t rows;
+    uint32_t numClasses;
+    uint64_t dataOffset;        // inicio de la matriz float32 desde el principio del fichero
+};
+
+static_assert(sizeof(CorpusFileHeader) == 32, "CorpusFileHeader debe ocupar 32 bytes");
+
+// ¿Empieza el buffer/fichero con la firma del formato binario?
+bool isBinaryCorpus(const void* data, size_t size);
+bool isBinaryCorpusFile(const std::string& filename);
+
+bool saveCorpusBinary(const DescriptorMatrix& corpus, const std::string& filename);
+
+/**
+ * Construye una vista sobre un corpus binario ya en memoria. Si el buffer
+ * está alineado a 4 bytes y el stride en disco es paddedStride(dim), la
+ * matriz apunta directamente a él (sin copia) y `storage` debe mantenerlo
+ * vivo; si no, se reempaqueta. Devuelve una matriz vacía si el buffer no es
+ * válido.
+ */
+DescriptorMatrix corpusFromBinaryBuffer(const void* data, size_t size,
+                                        std::shared_ptr<const void> storage);
+
+// Mapea el fichero con mmap y devuelve una vista sin copia sobre él
+DescriptorMatrix loadCorpusBinary(const std::string& filename);
+
+// Carga un corpus en CSV o binario según su firma
+DescriptorMatrix loadCorpusMatrix(const std::string& filename);
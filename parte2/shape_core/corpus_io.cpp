@@ -0,0 +1,108 @@
+#include "corpus_io.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "shape_log.h"
+
+using namespace std;
+
+namespace {
+
+/**
+ * Interpreta una línea "etiqueta,f1,...,fN". Los valores se leen con strtof
+ * directamente sobre el buffer, sin crear un string por campo; strtof se
+ * detiene en la coma o en el fin de línea, así que [begin, end) debe ir
+ * seguido de un carácter no numérico.
+ */
+void parseLine(const char* begin, const char* end, vector<float>& features, string& label,
+               DescriptorMatrixBuilder& builder) {
+    const char* comma = static_cast<const char*>(memchr(begin, ',', end - begin));
+    if (comma == nullptr) return;
+    
+    label.assign(begin, comma);
+    features.clear();
+    
+    const char* cursor = comma;
+    while (cursor < end && *cursor == ',') {
+        char* next = nullptr;
+        features.push_back(strtof(cursor + 1, &next));
+        cursor = next;
+    }
+    
+    builder.add(features.data(), features.size(), label);
+}
+
+// Añade al builder cada línea de [begin, end)
+void readCorpus(const char* begin, const char* end, DescriptorMatrixBuilder& builder) {
+    vector<float> features;
+    string label;
+    
+    while (begin < end) {
+        const char* lineEnd = static_cast<const char*>(memchr(begin, '\n', end - begin));
+        
+        if (lineEnd == nullptr) {
+            // Última línea sin '\n' (p. ej. un asset sin terminador): copia
+            // terminada en '\0' para que strtof no lea fuera del buffer
+            string lastLine(begin, end);
+            parseLine(lastLine.data(), lastLine.data() + lastLine.size(), features, label, builder);
+            break;
+        }
+        
+        parseLine(begin, lineEnd, features, label, builder);
+        begin = lineEnd + 1;
+    }
+}
+
+}  // namespace
+
+void saveCorpus(const DescriptorMatrix& corpus, const string& filename) {
+    ofstream file(filename);
+    if (!file.is_open()) {
+        SHAPE_LOGE("No se pudo crear archivo: %s", filename.c_str());
+        return;
+    }
+    
+    for (int r = 0; r < corpus.rows(); r++) {
+        file << corpus.label(r);
+        const float* features = corpus.row(r);
+        for (int k = 0; k < corpus.dim(); k++) {
+            file << "," << features[k];
+        }
+        file << "\n";
+    }
+    
+    file.close();
+    SHAPE_LOGI("Corpus guardado: %s (%d ejemplos)", filename.c_str(), corpus.rows());
+}
+
+DescriptorMatrix loadCorpus(const string& filename) {
+    ifstream file(filename, ios::binary);
+    
+    if (!file.is_open()) {
+        SHAPE_LOGE("No se pudo abrir archivo: %s", filename.c_str());
+        return DescriptorMatrix();
+    }
+    
+    string content((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    DescriptorMatrixBuilder builder;
+    readCorpus(content.data(), content.data() + content.size(), builder);
+    
+    DescriptorMatrix corpus = builder.build();
+    SHAPE_LOGI("Corpus cargado: %s (%d ejemplos)", filename.c_str(), corpus.rows());
+    
+    return corpus;
+}
+
+DescriptorMatrix parseCorpus(const char* data, size_t size) {
+    DescriptorMatrixBuilder builder;
+    readCorpus(data, data + size, builder);
+    
+    DescriptorMatrix corpus = builder.build();
+    SHAPE_LOGI("Corpus cargado: %d ejemplos", corpus.rows());
+    
+    return corpus;
+}
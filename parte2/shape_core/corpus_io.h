@@ -0,0 +1,18 @@
+/**
+ * Lectura y escritura del corpus de entrenamiento en CSV:
+ * una línea por ejemplo, "etiqueta,f1,f2,...,fN".
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "descriptor_matrix.h"
+
+void saveCorpus(const DescriptorMatrix& corpus, const std::string& filename);
+
+DescriptorMatrix loadCorpus(const std::string& filename);
+
+// Interpreta un CSV ya cargado en memoria (p. ej. un asset de Android)
+DescriptorMatrix parseCorpus(const char* data, size_t size);
@@ -0,0 +1,179 @@
+#include "descriptor_matrix.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "shape_log.h"
+
+using namespace std;
+
+namespace {
+
+// Memoria propia de una matriz construida con DescriptorMatrixBuilder
+struct OwnedStorage {
+    AlignedVector<float> data;
+    vector<int32_t> labels;
+};
+
+}  // namespace
+
+/**
+ * Mínimo de un bloque con 8 mínimos parciales independientes: evita la
+ * cadena de dependencias de un único acumulador y el compilador lo
+ * vectoriza. Con un solo acumulador la búsqueda costaba más que el kernel.
+ */
+float blockMinimum(const float* values, int count) {
+    float lanes[8];
+    fill(lanes, lanes + 8, numeric_limits<float>::max());
+    
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        for (int j = 0; j < 8; j++) {
+            lanes[j] = values[i + j] < lanes[j] ? values[i + j] : lanes[j];
+        }
+    }
+    for (; i < count; i++) {
+        lanes[0] = values[i] < lanes[0] ? values[i] : lanes[0];
+    }
+    return *min_element(lanes, lanes + 8);
+}
+
+DescriptorMatrix DescriptorMatrix::fromDescriptors(const vector<ShapeDescriptor>& descriptors) {
+    DescriptorMatrixBuilder builder;
+    builder.reserve(descriptors.size());
+    
+    for (const auto& desc : descriptors) {
+        if (!desc.features.empty()) {
+            builder.add(desc);
+        }
+    }
+    
+    return builder.build();
+}
+
+DescriptorMatrix DescriptorMatrix::view(const float* data, const int32_t* labels,
+                                        int rows, int dim,
+                                        vector<string> classNames,
+                                        shared_ptr<const void> storage) {
+    DescriptorMatrix matrix;
+    matrix.rows_ = rows;
+    matrix.dim_ = dim;
+    matrix.stride_ = paddedStride(dim);
+    matrix.data_ = data;
+    matrix.labels_ = labels;
+    matrix.classNames_ = std::move(classNames);
+    matrix.storage_ = std::move(storage);
+    return matrix;
+}
+
+void DescriptorMatrixBuilder::reserve(int rows) {
+    labels_.reserve(rows);
+    if (dim_ > 0) {
+        data_.reserve(static_cast<size_t>(rows) * paddedStride(dim_));
+    }
+}
+
+bool DescriptorMatrixBuilder::add(const float* features, int dim, const string& label) {
+    if (dim <= 0) return false;
+    
+    if (dim_ == 0) {
+        dim_ = dim;
+        data_.reserve(labels_.capacity() * paddedStride(dim_));
+    } else if (dim != dim_) {
+        SHAPE_LOGE("Descriptor de dimensión %d ignorado (se esperaba %d)", dim, dim_);
+        return false;
+    }
+    
+    auto it = find(classNames_.begin(), classNames_.end(), label);
+    int labelId = it - classNames_.begin();
+    if (it == classNames_.end()) {
+        classNames_.push_back(label);
+    }
+    
+    // Fila con relleno a 0 hasta el stride
+    size_t offset = data_.size();
+    data_.resize(offset + paddedStride(dim_), 0.0f);
+    copy(features, features + dim_, data_.begin() + offset);
+    labels_.push_back(labelId);
+    
+    return true;
+}
+
+DescriptorMatrix DescriptorMatrixBuilder::build() {
+    auto storage = make_shared<OwnedStorage>();
+    storage->data = std::move(data_);
+    storage->labels = std::move(labels_);
+    
+    const float* data = storage->data.data();
+    const int32_t* labels = storage->labels.data();
+    int rows = storage->labels.size();
+    DescriptorMatrix matrix = DescriptorMatrix::view(data, labels, rows, dim_, 
+                                                     std::move(classNames_), std::move(storage));
+    
+    *this = DescriptorMatrixBuilder();
+    return matrix;
+}
+
+PaddedQuery::PaddedQuery(const float* query, const DescriptorMatrix& corpus) : data_(stack_) {
+    const int stride = corpus.stride();
+    if (stride > 64) {
+        heap_.resize(stride);
+        data_ = heap_.data();
+    }
+    fill(data_, data_ + stride, 0.0f);
+    copy(query, query + corpus.dim(), data_);
+}
+
+int nearestNeighbor(const float* query, const DescriptorMatrix& corpus, float* distance,
+                    SquaredDistancesFn kernel) {
+    if (corpus.empty()) return -1;
+    if (!kernel) kernel = squaredDistances;
+    
+    const int stride = corpus.stride();
+    PaddedQuery q(query, corpus);
+    
+    // Distancias por bloques que caben en L1; sólo si el bloque mejora el
+    // mínimo se busca qué fila es
+    const int BLOCK_ROWS = 256;
+    alignas(64) float block[BLOCK_ROWS];
+    
+    int bestRow = 0;
+    float minSquared = numeric_limits<float>::max();
+    
+    for (int start = 0; start < corpus.rows(); start += BLOCK_ROWS) {
+        int count = min(BLOCK_ROWS, corpus.rows() - start);
+        kernel(q.data(), corpus.row(start), count, stride, block);
+        
+        float blockMin = blockMinimum(block, count);
+        if (blockMin < minSquared) {
+            minSquared = blockMin;
+            bestRow = start + static_cast<int>(find(block, block + count, blockMin) - block);
+        }
+    }
+    
+    if (distance) *distance = sqrt(minSquared);
+    return bestRow;
+}
+
+/**
+ * Clasifica un descriptor con el vecino más cercano del corpus.
+ */
+pair<string, float> classify(const ShapeDescriptor& testDescriptor, 
+                             const DescriptorMatrix& corpus) {
+    if (corpus.empty()) {
+        SHAPE_LOGE("Corpus de entrenamiento vacío");
+        return {"unknown", 1e9};
+    }
+    
+    if (static_cast<int>(testDescriptor.features.size()) != corpus.dim()) {
+        SHAPE_LOGE("Descriptores de diferente tamaño");
+        return {"unknown", 1e9};
+    }
+    
+    float minDistance = 0;
+    int bestRow = nearestNeighbor(testDescriptor.features.data(), corpus, &minDistance);
+    
+    SHAPE_LOGD("Clasificación: %s (distancia: %.4f)", corpus.label(bestRow).c_str(), minDistance);
+    return {corpus.label(bestRow), minDistance};
+}
@@ -0,0 +1,136 @@
+/**
+ * Corpus en memoria contigua e inmutable (estructura de arrays).
+ *
+ * - Características: un único buffer alineado, fila a fila, con un paso
+ *   (stride) fijo múltiplo de 8 floats. Las columnas de relleno valen 0,
+ *   así una distancia calculada sobre todo el stride es la misma que sobre
+ *   dim, y cada fila de 15 armónicos ocupa 16 floats = 64 bytes.
+ * - Etiquetas: un int32 por fila, índice a una tabla de nombres de clase.
+ *
+ * Se construye una vez (al cargar o generar el corpus) y después sólo se
+ * lee, así puede compartirse entre llamadas e hilos sin copias ni bloqueos.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "aligned_allocator.h"
+#include "distance_kernels.h"
+#include "shape_pipeline.h"
+
+// Paso en floats para filas de `dim` características (múltiplo de 8)
+inline int paddedStride(int dim) {
+    return (dim + 7) / 8 * 8;
+}
+
+class DescriptorMatrix {
+public:
+    DescriptorMatrix() = default;
+
+    // Copia los descriptores (con features no vacías) a memoria contigua
+    static DescriptorMatrix fromDescriptors(const std::vector<ShapeDescriptor>& descriptors);
+
+    /**
+     * Vista sin copia sobre memoria externa (p. ej. un corpus binario
+     * mapeado con mmap). `data` debe tener stride == paddedStride(dim) y
+     * columnas de relleno a 0. `storage` mantiene viva esa memoria mientras
+     * exista la matriz o cualquier copia suya.
+     */
+    static DescriptorMatrix view(const float* data, const int32_t* labels,
+                                 int rows, int dim,
+                                 std::vector<std::string> classNames,
+                                 std::shared_ptr<const void> storage);
+
+    int rows() const { return rows_; }
+    int dim() const { return dim_; }
+    int stride() const { return stride_; }   // floats entre filas consecutivas
+    bool empty() const { return rows_ == 0; }
+
+    const float* data() const { return data_; }
+    const int32_t* labels() const { return labels_; }
+
+    const float* row(int i) const { return data_ + static_cast<size_t>(i) * stride_; }
+    int labelId(int i) const { return labels_[i]; }
+    const std::string& label(int i) const { return classNames_[labels_[i]]; }
+    const std::vector<std::string>& classNames() const { return classNames_; }
+
+    // Bytes de características + etiquetas (sin contar la tabla de clases)
+    size_t memoryBytes() const {
+        return static_cast<size_t>(rows_) * (stride_ * sizeof(float) + sizeof(int32_t));
+    }
+
+private:
+    int rows_ = 0;
+    int dim_ = 0;
+    int stride_ = 0;
+    const float* data_ = nullptr;           // rows_ × stride_, fila a fila
+    const int32_t* labels_ = nullptr;       // índice en classNames_ por fila
+    std::vector<std::string> classNames_;
+    std::shared_ptr<const void> storage_;   // dueño de data_/labels_ (buffer propio o mmap)
+};
+
+/**
+ * Construye un DescriptorMatrix fila a fila sin pasar por
+ * vector<ShapeDescriptor> (un vector y dos strings por fila).
+ */
+class DescriptorMatrixBuilder {
+public:
+    void reserve(int rows);
+
+    // Añade una fila; la primera fija la dimensión. false si no coincide.
+    bool add(const float* features, int dim, const std::string& label);
+    bool add(const ShapeDescriptor& desc) {
+        return add(desc.features.data(), desc.features.size(), desc.label);
+    }
+
+    int rows() const { return static_cast<int>(labels_.size()); }
+
+    // Entrega la matriz; el builder queda vacío
+    DescriptorMatrix build();
+
+private:
+    int dim_ = 0;
+    AlignedVector<float> data_;
+    std::vector<int32_t> labels_;
+    std::vector<std::string> classNames_;
+};
+
+/**
+ * Copia de una consulta de dim() valores con el mismo relleno a 0 que las
+ * filas del corpus, para que los kernels recorran el stride completo sin
+ * tratar la cola. Sin memoria dinámica para strides de hasta 64 floats.
+ */
+class PaddedQuery {
+public:
+    PaddedQuery(const float* query, const DescriptorMatrix& corpus);
+    PaddedQuery(const PaddedQuery&) = delete;
+    PaddedQuery& operator=(const PaddedQuery&) = delete;
+
+    const float* data() const { return data_; }
+
+private:
+    alignas(64) float stack_[64];
+    std::vector<float> heap_;
+    float* data_;
+};
+
+// Mínimo de `count` distancias de un bloque (vectorizable)
+float blockMinimum(const float* values, int count);
+
+/**
+ * Vecino más cercano: distancias al cuadrado por bloques con el kernel SIMD
+ * de la CPU (o `kernel` si se indica, p. ej. para comparar en shape_bench);
+ * la raíz sólo se calcula para el ganador. `query` tiene dim() valores.
+ * Devuelve la fila ganadora (-1 si el corpus está vacío).
+ */
+int nearestNeighbor(const float* query, const DescriptorMatrix& corpus, float* distance,
+                    SquaredDistancesFn kernel = nullptr);
+
+// Vecino más cercano sobre el corpus contiguo: {etiqueta, distancia}
+std::pair<std::string, float> classify(const ShapeDescriptor& testDescriptor,
+                                       const DescriptorMatrix& corpus);
@@ -0,0 +1,360 @@
+#include "distance_kernels.h"
+
+#include "half_float.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(SHAPE_HAVE_X86_KERNELS)
+// Definidos en distance_kernels_avx2.cpp / distance_kernels_avx512.cpp,
+// compilados con -mavx2 -mfma / -mavx512f
+void squaredDistancesAvx2(const float* query, const float* rows, int count, int stride, float* out);
+void squaredDistancesAvx512(const float* query, const float* rows, int count, int stride, float* out);
+void distanceTileAvx2(const float* const* queries, const float* queryNorms,
+                      const float* panel, const float* panelNorms, int stride, float* out);
+void squaredDistancesF16Avx2(const float* query, const uint16_t* rows, int count, int stride, float* out);
+void squaredDistancesInt8Avx2(const float* query, const uint8_t* rows, int count, int stride,
+                              const float* scale, const float* offset, float* out);
+#endif
+
+namespace {
+
+void squaredDistancesScalar(const float* query, const float* rows, int count, int stride, float* out) {
+    for (int r = 0; r < count; r++, rows += stride) {
+        float sum = 0.0f;
+        for (int k = 0; k < stride; k++) {
+            float diff = query[k] - rows[k];
+            sum += diff * diff;
+        }
+        out[r] = sum;
+    }
+}
+
+void squaredDistancesF16Scalar(const float* query, const uint16_t* rows, int count, int stride, float* out) {
+    for (int r = 0; r < count; r++, rows += stride) {
+        float sum = 0.0f;
+        for (int k = 0; k < stride; k++) {
+            float diff = query[k] - halfToFloat(rows[k]);
+            sum += diff * diff;
+        }
+        out[r] = sum;
+    }
+}
+
+void squaredDistancesInt8Scalar(const float* query, const uint8_t* rows, int count, int stride,
+                                const float* scale, const float* offset, float* out) {
+    for (int r = 0; r < count; r++, rows += stride) {
+        float sum = 0.0f;
+        for (int k = 0; k < stride; k++) {
+            float diff = query[k] - (offset[k] + scale[k] * rows[k]);
+            sum += diff * diff;
+        }
+        out[r] = sum;
+    }
+}
+
+/**
+ * Tesela genérica: bucles de longitud fija que el compilador vectoriza con
+ * los flags base (SSE2 en x86, NEON en ARM).
+ */
+void distanceTileGeneric(const float* const* queries, const float* queryNorms,
+                         const float* panel, const float* panelNorms, int stride, float* out) {
+    float acc[TILE_QUERIES][TILE_ROWS] = {};
+    for (int k = 0; k < stride; k++) {
+        const float* b = panel + k * TILE_ROWS;
+        for (int i = 0; i < TILE_QUERIES; i++) {
+            float a = queries[i][k];
+            for (int j = 0; j < TILE_ROWS; j++) {
+                acc[i][j] += a * b[j];
+            }
+        }
+    }
+    for (int i = 0; i < TILE_QUERIES; i++) {
+        for (int j = 0; j < TILE_ROWS; j++) {
+            // max(0, ·): la cancelación puede dar valores ligeramente negativos
+            float squared = queryNorms[i] + panelNorms[j] - 2.0f * acc[i][j];
+            out[i * TILE_ROWS + j] = squared > 0.0f ? squared : 0.0f;
+        }
+    }
+}
+
+#if defined(__ARM_NEON)
+
+inline float32x4_t accumulate(float32x4_t acc, float32x4_t diff) {
+#if defined(__aarch64__)
+    return vfmaq_f32(acc, diff, diff);
+#else
+    return vmlaq_f32(acc, diff, diff);
+#endif
+}
+
+// Suma horizontal de cuatro acumuladores → {Σa0, Σa1, Σa2, Σa3}
+inline float32x4_t reduce4(float32x4_t a0, float32x4_t a1, float32x4_t a2, float32x4_t a3) {
+#if defined(__aarch64__)
+    return vpaddq_f32(vpaddq_f32(a0, a1), vpaddq_f32(a2, a3));
+#else
+    float32x2_t s0 = vadd_f32(vget_low_f32(a0), vget_high_f32(a0));
+    float32x2_t s1 = vadd_f32(vget_low_f32(a1), vget_high_f32(a1));
+    float32x2_t s2 = vadd_f32(vget_low_f32(a2), vget_high_f32(a2));
+    float32x2_t s3 = vadd_f32(vget_low_f32(a3), vget_high_f32(a3));
+    return vcombine_f32(vpadd_f32(s0, s1), vpadd_f32(s2, s3));
+#endif
+}
+
+inline float reduce1(float32x4_t a) {
+#if defined(__aarch64__)
+    return vaddvq_f32(a);
+#else
+    float32x2_t s = vadd_f32(vget_low_f32(a), vget_high_f32(a));
+    return vget_lane_f32(vpadd_f32(s, s), 0);
+#endif
+}
+
+/**
+ * Cuatro filas por iteración: cada fila acumula en su propio registro y la
+ * reducción horizontal se hace una vez para las cuatro.
+ */
+void squaredDistancesNeon(const float* query, const float* rows, int count, int stride, float* out) {
+    int r = 0;
+    for (; r + 4 <= count; r += 4, rows += 4 * stride) {
+        float32x4_t a0 = vdupq_n_f32(0.0f), a1 = a0, a2 = a0, a3 = a0;
+        for (int k = 0; k < stride; k += 4) {
+            float32x4_t q = vld1q_f32(query + k);
+            a0 = accumulate(a0, vsubq_f32(q, vld1q_f32(rows + k)));
+            a1 = accumulate(a1, vsubq_f32(q, vld1q_f32(rows + stride + k)));
+            a2 = accumulate(a2, vsubq_f32(q, vld1q_f32(rows + 2 * stride + k)));
+            a3 = accumulate(a3, vsubq_f32(q, vld1q_f32(rows + 3 * stride + k)));
+        }
+        vst1q_f32(out + r, reduce4(a0, a1, a2, a3));
+    }
+    for (; r < count; r++, rows += stride) {
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        for (int k = 0; k < stride; k += 4) {
+            acc = accumulate(acc, vsubq_f32(vld1q_f32(query + k), vld1q_f32(rows + k)));
+        }
+        out[r] = reduce1(acc);
+    }
+}
+
+#if defined(__aarch64__)
+// La conversión float16 → float32 es parte de AArch64; en ARMv7 queda el escalar
+inline float32x4_t loadHalf4(const uint16_t* p) {
+    return vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(p)));
+}
+
+void squaredDistancesF16Neon(const float* query, const uint16_t* rows, int count, int stride, float* out) {
+    int r = 0;
+    for (; r + 4 <= count; r += 4, rows += 4 * stride) {
+        float32x4_t a0 = vdupq_n_f32(0.0f), a1 = a0, a2 = a0, a3 = a0;
+        for (int k = 0; k < stride; k += 4) {
+            float32x4_t q = vld1q_f32(query + k);
+            a0 = accumulate(a0, vsubq_f32(q, loadHalf4(rows + k)));
+            a1 = accumulate(a1, vsubq_f32(q, loadHalf4(rows + stride + k)));
+            a2 = accumulate(a2, vsubq_f32(q, loadHalf4(rows + 2 * stride + k)));
+            a3 = accumulate(a3, vsubq_f32(q, loadHalf4(rows + 3 * stride + k)));
+        }
+        vst1q_f32(out + r, reduce4(a0, a1, a2, a3));
+    }
+    for (; r < count; r++, rows += stride) {
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        for (int k = 0; k < stride; k += 4) {
+            acc = accumulate(acc, vsubq_f32(vld1q_f32(query + k), loadHalf4(rows + k)));
+        }
+        out[r] = reduce1(acc);
+    }
+}
+#endif  // __aarch64__
+
+/**
+ * Ocho columnas por paso: 8 bytes → dos registros de 4 floats
+ * (offset + scale · código) restados a la consulta.
+ */
+inline void accumulateInt8(float32x4_t& acc, float32x4_t qLow, float32x4_t qHigh,
+                           float32x4_t scaleLow, float32x4_t scaleHigh, const uint8_t* codes) {
+    uint16x8_t wide = vmovl_u8(vld1_u8(codes));
+    float32x4_t low = vcvtq_f32_u32(vmovl_u16(vget_low_u16(wide)));
+    float32x4_t high = vcvtq_f32_u32(vmovl_u16(vget_high_u16(wide)));
+    acc = accumulate(acc, vmlsq_f32(qLow, scaleLow, low));
+    acc = accumulate(acc, vmlsq_f32(qHigh, scaleHigh, high));
+}
+
+void squaredDistancesInt8Neon(const float* query, const uint8_t* rows, int count, int stride,
+                              const float* scale, const float* offset, float* out) {
+    int r = 0;
+    for (; r + 4 <= count; r += 4, rows += 4 * stride) {
+        float32x4_t a0 = vdupq_n_f32(0.0f), a1 = a0, a2 = a0, a3 = a0;
+        for (int k = 0; k < stride; k += 8) {
+            // query - offset una vez por columna para las cuatro filas
+            float32x4_t qLow = vsubq_f32(vld1q_f32(query + k), vld1q_f32(offset + k));
+            float32x4_t qHigh = vsubq_f32(vld1q_f32(query + k + 4), vld1q_f32(offset + k + 4));
+            float32x4_t sLow = vld1q_f32(scale + k);
+            float32x4_t sHigh = vld1q_f32(scale + k + 4);
+            accumulateInt8(a0, qLow, qHigh, sLow, sHigh, rows + k);
+            accumulateInt8(a1, qLow, qHigh, sLow, sHigh, rows + stride + k);
+            accumulateInt8(a2, qLow, qHigh, sLow, sHigh, rows + 2 * stride + k);
+            accumulateInt8(a3, qLow, qHigh, sLow, sHigh, rows + 3 * stride + k);
+        }
+        vst1q_f32(out + r, reduce4(a0, a1, a2, a3));
+    }
+    if (r < count) {
+        squaredDistancesInt8Scalar(query, rows, count - r, stride, scale, offset, out + r);
+    }
+}
+
+#endif  // __ARM_NEON
+
+SimdLevel detectSimdLevelOnce() {
+#if defined(SHAPE_HAVE_X86_KERNELS)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::Avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SimdLevel::Avx2;
+#elif defined(__ARM_NEON)
+    return SimdLevel::Neon;
+#endif
+    return SimdLevel::Scalar;
+}
+
+}  // namespace
+
+SimdLevel detectSimdLevel() {
+    static const SimdLevel level = detectSimdLevelOnce();
+    return level;
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Neon:   return "neon";
+        case SimdLevel::Avx2:   return "avx2";
+        case SimdLevel::Avx512: return "avx512";
+        default:                return "scalar";
+    }
+}
+
+SquaredDistancesFn squaredDistancesKernel(SimdLevel level) {
+    if (static_cast<int>(level) > static_cast<int>(detectSimdLevel())) {
+        return nullptr;
+    }
+
+    switch (level) {
+        case SimdLevel::Scalar:
+            return squaredDistancesScalar;
+#if defined(__ARM_NEON)
+        case SimdLevel::Neon:
+            return squaredDistancesNeon;
+#endif
+#if defined(SHAPE_HAVE_X86_KERNELS)
+        case SimdLevel::Avx2:
+            return squaredDistancesAvx2;
+        case SimdLevel::Avx512:
+            return squaredDistancesAvx512;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+/**
+ * Con AVX2 disponible se prefiere a AVX-512: en Xeon la licencia de
+ * frecuencia de 512 bits hace que el kernel AVX-512 sea más lento con
+ * corpus en caché (el caso de la app) y sólo gane ~15% con corpus de
+ * millones de filas, limitados por memoria. Ver BM_NearestNeighbor.
+ */
+SimdLevel preferredSimdLevel() {
+    SimdLevel level = detectSimdLevel();
+    return level == SimdLevel::Avx512 ? SimdLevel::Avx2 : level;
+}
+
+void squaredDistances(const float* query, const float* rows, int count, int stride, float* out) {
+    static const SquaredDistancesFn kernel = squaredDistancesKernel(preferredSimdLevel());
+    kernel(query, rows, count, stride, out);
+}
+
+DistanceTileFn distanceTileKernel(SimdLevel level) {
+    if (static_cast<int>(level) > static_cast<int>(detectSimdLevel())) {
+        return nullptr;
+    }
+
+    switch (level) {
+        case SimdLevel::Scalar:
+            return distanceTileGeneric;
+#if defined(__ARM_NEON)
+        case SimdLevel::Neon:
+            return distanceTileGeneric;
+#endif
+#if defined(SHAPE_HAVE_X86_KERNELS)
+        // Una CPU con AVX-512 también tiene AVX2; la tesela no gana con 512 bits
+        case SimdLevel::Avx2:
+        case SimdLevel::Avx512:
+            return distanceTileAvx2;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+void distanceTile(const float* const* queries, const float* queryNorms,
+                  const float* panel, const float* panelNorms, int stride, float* out) {
+    static const DistanceTileFn kernel = distanceTileKernel(preferredSimdLevel());
+    kernel(queries, queryNorms, panel, panelNorms, stride, out);
+}
+
+SquaredDistancesF16Fn squaredDistancesF16Kernel(SimdLevel level) {
+    if (static_cast<int>(level) > static_cast<int>(detectSimdLevel())) {
+        return nullptr;
+    }
+
+    switch (level) {
+        case SimdLevel::Scalar:
+            return squaredDistancesF16Scalar;
+#if defined(__ARM_NEON)
+        case SimdLevel::Neon:
+#if defined(__aarch64__)
+            return squaredDistancesF16Neon;
+#else
+            return squaredDistancesF16Scalar;
+#endif
+#endif
+#if defined(SHAPE_HAVE_X86_KERNELS)
+        // F16C: toda CPU con AVX2 + FMA lo tiene (llegó antes que FMA)
+        case SimdLevel::Avx2:
+        case SimdLevel::Avx512:
+            return squaredDistancesF16Avx2;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+SquaredDistancesInt8Fn squaredDistancesInt8Kernel(SimdLevel level) {
+    if (static_cast<int>(level) > static_cast<int>(detectSimdLevel())) {
+        return nullptr;
+    }
+
+    switch (level) {
+        case SimdLevel::Scalar:
+            return squaredDistancesInt8Scalar;
+#if defined(__ARM_NEON)
+        case SimdLevel::Neon:
+            return squaredDistancesInt8Neon;
+#endif
+#if defined(SHAPE_HAVE_X86_KERNELS)
+        case SimdLevel::Avx2:
+        case SimdLevel::Avx512:
+            return squaredDistancesInt8Avx2;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+void squaredDistancesF16(const float* query, const uint16_t* rows, int count, int stride, float* out) {
+    static const SquaredDistancesF16Fn kernel = squaredDistancesF16Kernel(preferredSimdLevel());
+    kernel(query, rows, count, stride, out);
+}
+
+void squaredDistancesInt8(const float* query, const uint8_t* rows, int count, int stride,
+                          const float* scale, const float* offset, float* out) {
+    static const SquaredDistancesInt8Fn kernel = squaredDistancesInt8Kernel(preferredSimdLevel());
+    kernel(query, rows, count, stride, scale, offset, out);
+}
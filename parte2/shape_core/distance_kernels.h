@@ -0,0 +1,89 @@
+/**
+ * Kernels SIMD de distancia al cuadrado: una consulta contra un bloque de
+ * filas contiguas del corpus (DescriptorMatrix).
+ *
+ * Requisitos comunes a todos los kernels:
+ * - `stride` es múltiplo de 8 (paddedStride) y las columnas de relleno
+ *   valen 0 tanto en las filas como en la consulta.
+ * - No hace falta alineación: se usan cargas no alineadas, así valen las
+ *   vistas sobre un corpus binario mapeado.
+ *
+ * El kernel se elige en tiempo de ejecución según la CPU (AVX2+FMA, AVX-512,
+ * NEON o escalar). Las variantes x86 se compilan en ficheros aparte con sus
+ * propios flags (ver CMakeLists.txt), el resto del binario sigue siendo
+ * compatible con cualquier CPU.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+enum class SimdLevel {
+    Scalar = 0,
+    Neon,
+    Avx2,
+    Avx512
+};
+
+// out[r] = Σ_k (query[k] - rows[r·stride + k])², r = 0..count-1
+using SquaredDistancesFn = void (*)(const float* query, const float* rows,
+                                    int count, int stride, float* out);
+
+// Mejor nivel soportado por la CPU actual (se detecta una sola vez)
+SimdLevel detectSimdLevel();
+
+const char* simdLevelName(SimdLevel level);
+
+// Kernel de un nivel concreto; nullptr si no está compilado o la CPU no lo soporta
+SquaredDistancesFn squaredDistancesKernel(SimdLevel level);
+
+// Nivel que usa squaredDistances: el soportado, salvo AVX-512 → AVX2
+SimdLevel preferredSimdLevel();
+
+// Distancias al cuadrado con el kernel de preferredSimdLevel()
+void squaredDistances(const float* query, const float* rows, int count, int stride, float* out);
+
+/**
+ * Tesela del k-NN por lotes (ver knn_batch.h): distancias² de TILE_QUERIES
+ * consultas a un panel empaquetado y traspuesto de TILE_ROWS filas del
+ * corpus, como |q|² + |c|² − 2·q·cᵀ. `panel` (panel[k·TILE_ROWS + j] =
+ * columna k de la fila j) está alineado a 32 bytes; `out` tiene
+ * TILE_QUERIES × TILE_ROWS valores.
+ */
+const int TILE_QUERIES = 4;
+const int TILE_ROWS = 16;
+
+using DistanceTileFn = void (*)(const float* const* queries, const float* queryNorms,
+                                const float* panel, const float* panelNorms,
+                                int stride, float* out);
+
+// nullptr si el nivel no está compilado o la CPU no lo soporta
+DistanceTileFn distanceTileKernel(SimdLevel level);
+
+// Tesela con el kernel de preferredSimdLevel()
+void distanceTile(const float* const* queries, const float* queryNorms,
+                  const float* panel, const float* panelNorms, int stride, float* out);
+
+/**
+ * Kernels sobre el corpus cuantizado (ver quantized_corpus.h): decuantizan
+ * cada fila al vuelo en registros y acumulan en float. Mismos requisitos
+ * de stride y relleno que squaredDistances; `query` sigue en float.
+ */
+
+// Filas en float16 (IEEE binary16): out[r] = Σ_k (query[k] - half(rows[r·stride + k]))²
+using SquaredDistancesF16Fn = void (*)(const float* query, const uint16_t* rows,
+                                       int count, int stride, float* out);
+
+// Filas en uint8 con escala por dimensión: valor = offset[k] + scale[k] · rows[r·stride + k]
+using SquaredDistancesInt8Fn = void (*)(const float* query, const uint8_t* rows,
+                                        int count, int stride,
+                                        const float* scale, const float* offset, float* out);
+
+// nullptr si el nivel no está compilado o la CPU no lo soporta
+SquaredDistancesF16Fn squaredDistancesF16Kernel(SimdLevel level);
+SquaredDistancesInt8Fn squaredDistancesInt8Kernel(SimdLevel level);
+
+// Con el kernel de preferredSimdLevel()
+void squaredDistancesF16(const float* query, const uint16_t* rows, int count, int stride, float* out);
+void squaredDistancesInt8(const float* query, const uint8_t* rows, int count, int stride,
+                          const float* scale, const float* offset, float* out);
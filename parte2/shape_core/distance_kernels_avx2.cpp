@@ -0,0 +1,198 @@
+/**
+ * Kernels AVX2 + FMA de distancias al cuadrado (consulta × filas, tesela
+ * del k-NN por lotes y corpus cuantizado). Se compila con -mavx2 -mfma
+ * -mf16c y sólo se llama si la CPU lo soporta (ver detectSimdLevel).
+ */
+
+#include <immintrin.h>
+
+#include "distance_kernels.h"
+
+namespace {
+
+// Suma horizontal de ocho acumuladores → {Σa0, ..., Σa7}
+inline __m256 reduce8(__m256 a0, __m256 a1, __m256 a2, __m256 a3,
+                      __m256 a4, __m256 a5, __m256 a6, __m256 a7) {
+    __m256 t0 = _mm256_hadd_ps(a0, a1);
+    __m256 t1 = _mm256_hadd_ps(a2, a3);
+    __m256 t2 = _mm256_hadd_ps(a4, a5);
+    __m256 t3 = _mm256_hadd_ps(a6, a7);
+    __m256 u0 = _mm256_hadd_ps(t0, t1);     // a0..a3: mitad baja | mitad alta
+    __m256 u1 = _mm256_hadd_ps(t2, t3);     // a4..a7: mitad baja | mitad alta
+    return _mm256_add_ps(_mm256_permute2f128_ps(u0, u1, 0x20),
+                         _mm256_permute2f128_ps(u0, u1, 0x31));
+}
+
+inline float reduce1(__m256 a) {
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+    s = _mm_hadd_ps(s, s);
+    s = _mm_hadd_ps(s, s);
+    return _mm_cvtss_f32(s);
+}
+
+inline __m256 accumulate(__m256 acc, __m256 q, const float* row) {
+    __m256 diff = _mm256_sub_ps(q, _mm256_loadu_ps(row));
+    return _mm256_fmadd_ps(diff, diff, acc);
+}
+
+// 8 valores float16 → 8 floats (F16C)
+inline __m256 accumulateHalf(__m256 acc, __m256 q, const uint16_t* row) {
+    __m256 value = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row)));
+    __m256 diff = _mm256_sub_ps(q, value);
+    return _mm256_fmadd_ps(diff, diff, acc);
+}
+
+// 8 códigos uint8 → 8 floats; q ya lleva restado el offset: diff = q − scale · código
+inline __m256 accumulateCodes(__m256 acc, __m256 q, __m256 scale, const uint8_t* row) {
+    __m128i codes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(row));
+    __m256 value = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(codes));
+    __m256 diff = _mm256_fnmadd_ps(scale, value, q);
+    return _mm256_fmadd_ps(diff, diff, acc);
+}
+
+}  // namespace
+
+/**
+ * Ocho filas por iteración, cada una con su acumulador; una sola reducción
+ * horizontal para las ocho y un store de 8 distancias.
+ */
+void squaredDistancesAvx2(const float* query, const float* rows, int count, int stride, float* out) {
+    int r = 0;
+    for (; r + 8 <= count; r += 8, rows += 8 * stride) {
+        __m256 a0 = _mm256_setzero_ps(), a1 = a0, a2 = a0, a3 = a0;
+        __m256 a4 = a0, a5 = a0, a6 = a0, a7 = a0;
+        for (int k = 0; k < stride; k += 8) {
+            __m256 q = _mm256_loadu_ps(query + k);
+            a0 = accumulate(a0, q, rows + k);
+            a1 = accumulate(a1, q, rows + stride + k);
+            a2 = accumulate(a2, q, rows + 2 * stride + k);
+            a3 = accumulate(a3, q, rows + 3 * stride + k);
+            a4 = accumulate(a4, q, rows + 4 * stride + k);
+            a5 = accumulate(a5, q, rows + 5 * stride + k);
+            a6 = accumulate(a6, q, rows + 6 * stride + k);
+            a7 = accumulate(a7, q, rows + 7 * stride + k);
+        }
+        _mm256_storeu_ps(out + r, reduce8(a0, a1, a2, a3, a4, a5, a6, a7));
+    }
+    for (; r < count; r++, rows += stride) {
+        __m256 acc = _mm256_setzero_ps();
+        for (int k = 0; k < stride; k += 8) {
+            acc = accumulate(acc, _mm256_loadu_ps(query + k), rows + k);
+        }
+        out[r] = reduce1(acc);
+    }
+}
+
+// Mismo esquema de ocho filas sobre un corpus float16
+void squaredDistancesF16Avx2(const float* query, const uint16_t* rows, int count, int stride, float* out) {
+    int r = 0;
+    for (; r + 8 <= count; r += 8, rows += 8 * stride) {
+        __m256 a0 = _mm256_setzero_ps(), a1 = a0, a2 = a0, a3 = a0;
+        __m256 a4 = a0, a5 = a0, a6 = a0, a7 = a0;
+        for (int k = 0; k < stride; k += 8) {
+            __m256 q = _mm256_loadu_ps(query + k);
+            a0 = accumulateHalf(a0, q, rows + k);
+            a1 = accumulateHalf(a1, q, rows + stride + k);
+            a2 = accumulateHalf(a2, q, rows + 2 * stride + k);
+            a3 = accumulateHalf(a3, q, rows + 3 * stride + k);
+            a4 = accumulateHalf(a4, q, rows + 4 * stride + k);
+            a5 = accumulateHalf(a5, q, rows + 5 * stride + k);
+            a6 = accumulateHalf(a6, q, rows + 6 * stride + k);
+            a7 = accumulateHalf(a7, q, rows + 7 * stride + k);
+        }
+        _mm256_storeu_ps(out + r, reduce8(a0, a1, a2, a3, a4, a5, a6, a7));
+    }
+    for (; r < count; r++, rows += stride) {
+        __m256 acc = _mm256_setzero_ps();
+        for (int k = 0; k < stride; k += 8) {
+            acc = accumulateHalf(acc, _mm256_loadu_ps(query + k), rows + k);
+        }
+        out[r] = reduce1(acc);
+    }
+}
+
+/**
+ * Corpus uint8 con escala por dimensión. query − offset se calcula una vez
+ * por bloque de columnas y se comparte entre las ocho filas.
+ */
+void squaredDistancesInt8Avx2(const float* query, const uint8_t* rows, int count, int stride,
+                              const float* scale, const float* offset, float* out) {
+    int r = 0;
+    for (; r + 8 <= count; r += 8, rows += 8 * stride) {
+        __m256 a0 = _mm256_setzero_ps(), a1 = a0, a2 = a0, a3 = a0;
+        __m256 a4 = a0, a5 = a0, a6 = a0, a7 = a0;
+        for (int k = 0; k < stride; k += 8) {
+            __m256 q = _mm256_sub_ps(_mm256_loadu_ps(query + k), _mm256_loadu_ps(offset + k));
+            __m256 s = _mm256_loadu_ps(scale + k);
+            a0 = accumulateCodes(a0, q, s, rows + k);
+            a1 = accumulateCodes(a1, q, s, rows + stride + k);
+            a2 = accumulateCodes(a2, q, s, rows + 2 * stride + k);
+            a3 = accumulateCodes(a3, q, s, rows + 3 * stride + k);
+            a4 = accumulateCodes(a4, q, s, rows + 4 * stride + k);
+            a5 = accumulateCodes(a5, q, s, rows + 5 * stride + k);
+            a6 = accumulateCodes(a6, q, s, rows + 6 * stride + k);
+            a7 = accumulateCodes(a7, q, s, rows + 7 * stride + k);
+        }
+        _mm256_storeu_ps(out + r, reduce8(a0, a1, a2, a3, a4, a5, a6, a7));
+    }
+    for (; r < count; r++, rows += stride) {
+        __m256 acc = _mm256_setzero_ps();
+        for (int k = 0; k < stride; k += 8) {
+            __m256 q = _mm256_sub_ps(_mm256_loadu_ps(query + k), _mm256_loadu_ps(offset + k));
+            acc = accumulateCodes(acc, q, _mm256_loadu_ps(scale + k), rows + k);
+        }
+        out[r] = reduce1(acc);
+    }
+}
+
+/**
+ * Tesela del k-NN por lotes: 4 consultas × 16 filas en 8 acumuladores
+ * (dos registros de 8 filas por consulta). Por columna k: dos cargas del
+ * panel, cuatro broadcast y ocho FMA.
+ */
+void distanceTileAvx2(const float* const* queries, const float* queryNorms,
+                      const float* panel, const float* panelNorms, int stride, float* out) {
+    static_assert(TILE_QUERIES == 4 && TILE_ROWS == 16, "tesela 4 × 16");
+
+    __m256 a00 = _mm256_setzero_ps(), a01 = a00, a10 = a00, a11 = a00;
+    __m256 a20 = a00, a21 = a00, a30 = a00, a31 = a00;
+    const float* q0 = queries[0];
+    const float* q1 = queries[1];
+    const float* q2 = queries[2];
+    const float* q3 = queries[3];
+
+    for (int k = 0; k < stride; k++, panel += TILE_ROWS) {
+        __m256 b0 = _mm256_load_ps(panel);
+        __m256 b1 = _mm256_load_ps(panel + 8);
+        __m256 q = _mm256_broadcast_ss(q0 + k);
+        a00 = _mm256_fmadd_ps(q, b0, a00);
+        a01 = _mm256_fmadd_ps(q, b1, a01);
+        q = _mm256_broadcast_ss(q1 + k);
+        a10 = _mm256_fmadd_ps(q, b0, a10);
+        a11 = _mm256_fmadd_ps(q, b1, a11);
+        q = _mm256_broadcast_ss(q2 + k);
+        a20 = _mm256_fmadd_ps(q, b0, a20);
+        a21 = _mm256_fmadd_ps(q, b1, a21);
+        q = _mm256_broadcast_ss(q3 + k);
+        a30 = _mm256_fmadd_ps(q, b0, a30);
+        a31 = _mm256_fmadd_ps(q, b1, a31);
+    }
+
+    // |q|² + |c|² − 2·q·c, con max(0, ·) por la cancelación
+    const __m256 minusTwo = _mm256_set1_ps(-2.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 c0 = _mm256_loadu_ps(panelNorms);
+    const __m256 c1 = _mm256_loadu_ps(panelNorms + 8);
+    auto finish = [&](__m256 acc, __m256 norms, float queryNorm, float* dst) {
+        __m256 base = _mm256_add_ps(norms, _mm256_set1_ps(queryNorm));
+        _mm256_storeu_ps(dst, _mm256_max_ps(_mm256_fmadd_ps(minusTwo, acc, base), zero));
+    };
+    finish(a00, c0, queryNorms[0], out);
+    finish(a01, c1, queryNorms[0], out + 8);
+    finish(a10, c0, queryNorms[1], out + 16);
+    finish(a11, c1, queryNorms[1], out + 24);
+    finish(a20, c0, queryNorms[2], out + 32);
+    finish(a21, c1, queryNorms[2], out + 40);
+    finish(a30, c0, queryNorms[3], out + 48);
+    finish(a31, c1, queryNorms[3], out + 56);
+}
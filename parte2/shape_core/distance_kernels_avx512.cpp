@@ -0,0 +1,74 @@
+/**
+ * Kernel AVX-512F de distancias al cuadrado. Se compila con -mavx512f y
+ * sólo se llama si la CPU lo soporta (ver detectSimdLevel).
+ *
+ * Con 15 armónicos el stride es 16: una fila cabe en un registro de 512
+ * bits. Para strides que no son múltiplo de 16 la última carga usa máscara.
+ */
+
+#include <immintrin.h>
+
+namespace {
+
+// Carga 16 floats desde `p`; sólo los 8 primeros si quedan 8 (máscara)
+inline __m512 load(const float* p, __mmask16 mask) {
+    return _mm512_maskz_loadu_ps(mask, p);
+}
+
+inline __m512 accumulate(__m512 acc, __m512 q, const float* row, __mmask16 mask) {
+    __m512 diff = _mm512_sub_ps(q, load(row, mask));
+    return _mm512_fmadd_ps(diff, diff, acc);
+}
+
+// 512 → 256 bits sumando las dos mitades
+inline __m256 fold(__m512 a) {
+    return _mm256_add_ps(_mm512_castps512_ps256(a),
+                         _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(a), 1)));
+}
+
+// Suma horizontal de ocho acumuladores → {Σa0, ..., Σa7}
+inline __m256 reduce8(__m512 a0, __m512 a1, __m512 a2, __m512 a3,
+                      __m512 a4, __m512 a5, __m512 a6, __m512 a7) {
+    __m256 t0 = _mm256_hadd_ps(fold(a0), fold(a1));
+    __m256 t1 = _mm256_hadd_ps(fold(a2), fold(a3));
+    __m256 t2 = _mm256_hadd_ps(fold(a4), fold(a5));
+    __m256 t3 = _mm256_hadd_ps(fold(a6), fold(a7));
+    __m256 u0 = _mm256_hadd_ps(t0, t1);
+    __m256 u1 = _mm256_hadd_ps(t2, t3);
+    return _mm256_add_ps(_mm256_permute2f128_ps(u0, u1, 0x20),
+                         _mm256_permute2f128_ps(u0, u1, 0x31));
+}
+
+}  // namespace
+
+void squaredDistancesAvx512(const float* query, const float* rows, int count, int stride, float* out) {
+    const int full = stride / 16 * 16;              // columnas en registros completos
+    const __mmask16 tail = stride % 16 ? 0x00FF : 0;  // 8 columnas restantes, si las hay
+    
+    int r = 0;
+    for (; r + 8 <= count; r += 8, rows += 8 * stride) {
+        __m512 a0 = _mm512_setzero_ps(), a1 = a0, a2 = a0, a3 = a0;
+        __m512 a4 = a0, a5 = a0, a6 = a0, a7 = a0;
+        for (int k = 0; k < stride; k += 16) {
+            __mmask16 mask = k < full ? 0xFFFF : tail;
+            __m512 q = load(query + k, mask);
+            a0 = accumulate(a0, q, rows + k, mask);
+            a1 = accumulate(a1, q, rows + stride + k, mask);
+            a2 = accumulate(a2, q, rows + 2 * stride + k, mask);
+            a3 = accumulate(a3, q, rows + 3 * stride + k, mask);
+            a4 = accumulate(a4, q, rows + 4 * stride + k, mask);
+            a5 = accumulate(a5, q, rows + 5 * stride + k, mask);
+            a6 = accumulate(a6, q, rows + 6 * stride + k, mask);
+            a7 = accumulate(a7, q, rows + 7 * stride + k, mask);
+        }
+        _mm256_storeu_ps(out + r, reduce8(a0, a1, a2, a3, a4, a5, a6, a7));
+    }
+    for (; r < count; r++, rows += stride) {
+        __m512 acc = _mm512_setzero_ps();
+        for (int k = 0; k < stride; k += 16) {
+            __mmask16 mask = k < full ? 0xFFFF : tail;
+            acc = accumulate(acc, load(query + k, mask), rows + k, mask);
+        }
+        out[r] = _mm512_reduce_add_ps(acc);
+    }
+}
@@ -0,0 +1,71 @@
+/**
+ * Conversión float32 ↔ float16 (IEEE 754 binary16) en software, para los
+ * kernels escalares y para cuantizar el corpus. Los kernels SIMD usan las
+ * instrucciones de conversión de la CPU (F16C, NEON).
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+// Redondeo al par más cercano; desbordamiento → ±inf, NaN se conserva
+inline uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t exponent = (bits >> 23) & 0xFFu;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if (exponent == 0xFF) {                             // inf / NaN
+        return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0));
+    }
+
+    int halfExponent = static_cast<int>(exponent) - 127 + 15;
+    if (halfExponent >= 0x1F) {                         // desbordamiento
+        return static_cast<uint16_t>(sign | 0x7C00u);
+    }
+
+    if (halfExponent <= 0) {                            // subnormal o cero
+        if (halfExponent < -10) return static_cast<uint16_t>(sign);
+        mantissa |= 0x800000u;
+        int shift = 14 - halfExponent;
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1u))) half++;
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = sign | (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1FFFu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) half++;    // puede subir a inf: correcto
+    return static_cast<uint16_t>(half);
+}
+
+inline float halfToFloat(uint16_t half) {
+    uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+    uint32_t exponent = (half >> 10) & 0x1Fu;
+    uint32_t mantissa = half & 0x3FFu;
+    uint32_t bits;
+
+    if (exponent == 0x1F) {                             // inf / NaN
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    } else if (exponent != 0) {                         // normal
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {                         // cero
+        bits = sign;
+    } else {                                            // subnormal: normalizar
+        int shift = 0;
+        while (!(mantissa & 0x400u)) {
+            mantissa <<= 1;
+            shift++;
+        }
+        bits = sign | (static_cast<uint32_t>(127 - 15 + 1 - shift) << 23) | ((mantissa & 0x3FFu) << 13);
+    }
+
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
@@ -0,0 +1,371 @@
+#include "hnsw_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <queue>
+#include <random>
+
+#include "distance_kernels.h"
+#include "shape_log.h"
+
+using namespace std;
+
+namespace {
+
+const uint32_t HNSW_VERSION = 1;
+
+/**
+ * Nodos visitados en una búsqueda. Se marca con un número de época en vez
+ * de limpiar un vector de millones de bytes por consulta; uno por hilo.
+ */
+class VisitedSet {
+public:
+    void reset(size_t rows) {
+        if (marks_.size() != rows || epoch_ == UINT32_MAX) {
+            marks_.assign(rows, 0);
+            epoch_ = 0;
+        }
+        epoch_++;
+    }
+
+    // true si `node` no se había visitado (y lo marca)
+    bool visit(int node) {
+        if (marks_[node] == epoch_) return false;
+        marks_[node] = epoch_;
+        return true;
+    }
+
+private:
+    vector<uint32_t> marks_;
+    uint32_t epoch_ = 0;
+};
+
+VisitedSet& visitedSet(size_t rows) {
+    thread_local VisitedSet visited;
+    visited.reset(rows);
+    return visited;
+}
+
+}  // namespace
+
+HnswIndex::HnswIndex(const DescriptorMatrix& corpus, const HnswParams& params)
+    : NearestNeighborIndex(corpus), params_(params) {
+    levels_.assign(corpus.rows(), 0);
+    baseLinks_.assign(static_cast<size_t>(corpus.rows()) * (1 + maxLinks(0)), 0);
+    upperLinks_.resize(corpus.rows());
+}
+
+int32_t* HnswIndex::links(int node, int level) {
+    if (level == 0) {
+        return baseLinks_.data() + static_cast<size_t>(node) * (1 + maxLinks(0));
+    }
+    return upperLinks_[node].data() + static_cast<size_t>(level - 1) * (1 + maxLinks(level));
+}
+
+const int32_t* HnswIndex::links(int node, int level) const {
+    return const_cast<HnswIndex*>(this)->links(node, level);
+}
+
+float HnswIndex::distance(const float* query, int node) const {
+    float squared;
+    squaredDistances(query, corpus_.row(node), 1, corpus_.stride(), &squared);
+    return squared;
+}
+
+// Descenso voraz en un nivel superior: se mueve al vecino más cercano mientras mejore
+int HnswIndex::greedySearch(const float* query, int entry, int level) const {
+    int current = entry;
+    float currentDistance = distance(query, current);
+
+    bool improved = true;
+    while (improved) {
+        improved = false;
+        const int32_t* list = links(current, level);
+        for (int i = 1; i <= list[0]; i++) {
+            float d = distance(query, list[i]);
+            if (d < currentDistance) {
+                currentDistance = d;
+                current = list[i];
+                improved = true;
+            }
+        }
+    }
+    return current;
+}
+
+/**
+ * Búsqueda en un nivel con `ef` candidatos (algoritmo 2 del artículo).
+ * Devuelve los ef más cercanos encontrados, ordenados de menor a mayor.
+ */
+vector<HnswIndex::Candidate> HnswIndex::searchLayer(const float* query, int entry,
+                                                    int ef, int level) const {
+    VisitedSet& visited = visitedSet(corpus_.rows());
+
+    // candidatos por explorar (el más cercano arriba) y resultados (el más lejano arriba)
+    priority_queue<Candidate, vector<Candidate>, greater<Candidate>> candidates;
+    priority_queue<Candidate> results;
+
+    float d = distance(query, entry);
+    visited.visit(entry);
+    candidates.push({d, entry});
+    results.push({d, entry});
+
+    while (!candidates.empty()) {
+        Candidate nearest = candidates.top();
+        if (nearest.first > results.top().first && static_cast<int>(results.size()) >= ef) {
+            break;
+        }
+        candidates.pop();
+
+        const int32_t* list = links(nearest.second, level);
+        for (int i = 1; i <= list[0]; i++) {
+            int neighbor = list[i];
+            if (!visited.visit(neighbor)) continue;
+
+            float nd = distance(query, neighbor);
+            if (static_cast<int>(results.size()) < ef || nd < results.top().first) {
+                candidates.push({nd, neighbor});
+                results.push({nd, neighbor});
+                if (static_cast<int>(results.size()) > ef) results.pop();
+            }
+        }
+    }
+
+    vector<Candidate> sorted(results.size());
+    for (size_t i = sorted.size(); i-- > 0; results.pop()) {
+        sorted[i] = results.top();
+    }
+    return sorted;
+}
+
+/**
+ * Heurística de vecinos (algoritmo 4): un candidato entra sólo si está más
+ * cerca del nodo que de todos los ya elegidos. Así los enlaces apuntan en
+ * direcciones distintas y el grafo sigue conectado entre grupos densos.
+ * `candidates` debe venir ordenado de menor a mayor distancia.
+ */
+vector<int> HnswIndex::selectNeighbors(vector<Candidate>& candidates, int maxCount) const {
+    vector<int> selected;
+    selected.reserve(maxCount);
+
+    for (const Candidate& candidate : candidates) {
+        if (static_cast<int>(selected.size()) >= maxCount) break;
+
+        bool diverse = true;
+        for (int other : selected) {
+            if (distance(candidate.second, other) < candidate.first) {
+                diverse = false;
+                break;
+            }
+        }
+        if (diverse) selected.push_back(candidate.second);
+    }
+    return selected;
+}
+
+// Añade `node` a la lista de `neighbor`; si se llena, se vuelve a podar con la heurística
+void HnswIndex::connect(int neighbor, int node, int level) {
+    int32_t* list = links(neighbor, level);
+    int capacity = maxLinks(level);
+
+    if (list[0] < capacity) {
+        list[++list[0]] = node;
+        return;
+    }
+
+    vector<Candidate> candidates;
+    candidates.reserve(capacity + 1);
+    candidates.push_back({distance(neighbor, node), node});
+    for (int i = 1; i <= list[0]; i++) {
+        candidates.push_back({distance(neighbor, list[i]), list[i]});
+    }
+    sort(candidates.begin(), candidates.end());
+
+    vector<int> kept = selectNeighbors(candidates, capacity);
+    list[0] = kept.size();
+    copy(kept.begin(), kept.end(), list + 1);
+}
+
+void HnswIndex::insert(int node, int level) {
+    levels_[node] = level;
+    if (level > 0) {
+        upperLinks_[node].assign(static_cast<size_t>(level) * (1 + params_.M), 0);
+    }
+
+    if (entryPoint_ < 0) {
+        entryPoint_ = node;
+        maxLevel_ = level;
+        return;
+    }
+
+    const float* query = corpus_.row(node);
+    int entry = entryPoint_;
+    for (int l = maxLevel_; l > level; l--) {
+        entry = greedySearch(query, entry, l);
+    }
+
+    for (int l = min(level, maxLevel_); l >= 0; l--) {
+        vector<Candidate> candidates = searchLayer(query, entry, params_.efConstruction, l);
+        vector<int> neighbors = selectNeighbors(candidates, params_.M);
+
+        int32_t* list = links(node, l);
+        list[0] = neighbors.size();
+        copy(neighbors.begin(), neighbors.end(), list + 1);
+
+        for (int neighbor : neighbors) {
+            connect(neighbor, node, l);
+        }
+        entry = candidates.front().second;
+    }
+
+    if (level > maxLevel_) {
+        entryPoint_ = node;
+        maxLevel_ = level;
+    }
+}
+
+unique_ptr<HnswIndex> HnswIndex::build(const DescriptorMatrix& corpus, const HnswParams& params) {
+    unique_ptr<HnswIndex> index(new HnswIndex(corpus, params));
+
+    // Nivel ~ floor(-ln(U) / ln(M)): cada nivel tiene ~1/M nodos del anterior
+    mt19937_64 rng(params.seed);
+    uniform_real_distribution<double> uniform(numeric_limits<double>::min(), 1.0);
+    double levelScale = 1.0 / log(max(2, params.M));
+
+    for (int node = 0; node < corpus.rows(); node++) {
+        int level = static_cast<int>(-log(uniform(rng)) * levelScale);
+        index->insert(node, level);
+    }
+
+    SHAPE_LOGI("Índice HNSW construido: %d nodos, %d niveles", corpus.rows(), index->maxLevel_ + 1);
+    return index;
+}
+
+int HnswIndex::search(const float* query, float* distance) const {
+    if (entryPoint_ < 0) return -1;
+
+    PaddedQuery q(query, corpus_);
+
+    int entry = entryPoint_;
+    for (int l = maxLevel_; l > 0; l--) {
+        entry = greedySearch(q.data(), entry, l);
+    }
+
+    vector<Candidate> nearest = searchLayer(q.data(), entry, max(1, params_.efSearch), 0);
+    if (distance) *distance = sqrt(nearest.front().first);
+    return nearest.front().second;
+}
+
+bool HnswIndex::save(const string& filename) const {
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) {
+        SHAPE_LOGE("No se pudo crear el índice: %s", filename.c_str());
+        return false;
+    }
+
+    HnswFileHeader header = {};
+    memcpy(header.magic, "SHPH", 4);
+    header.version = HNSW_VERSION;
+    header.rows = corpus_.rows();
+    header.dim = corpus_.dim();
+    header.M = params_.M;
+    header.efSearch = params_.efSearch;
+    header.entryPoint = entryPoint_;
+    header.maxLevel = maxLevel_;
+    header.fingerprint = corpusFingerprint(corpus_);
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(levels_.data()), sizeof(int32_t) * levels_.size());
+
+    for (int node = 0; node < corpus_.rows(); node++) {
+        for (int l = 0; l <= levels_[node]; l++) {
+            const int32_t* list = links(node, l);
+            file.write(reinterpret_cast<const char*>(list), sizeof(int32_t) * (1 + list[0]));
+        }
+    }
+
+    if (!file) {
+        SHAPE_LOGE("Error escribiendo el índice: %s", filename.c_str());
+        return false;
+    }
+
+    SHAPE_LOGI("Índice HNSW guardado: %s", filename.c_str());
+    return true;
+}
+
+unique_ptr<HnswIndex> HnswIndex::fromBuffer(const DescriptorMatrix& corpus, const char* data, size_t size) {
+    HnswFileHeader header;
+    if (size < sizeof(header)) return nullptr;
+    memcpy(&header, data, sizeof(header));
+
+    if (memcmp(header.magic, "SHPH", 4) != 0 || header.version != HNSW_VERSION) {
+        SHAPE_LOGE("Índice HNSW no válido");
+        return nullptr;
+    }
+    if (header.rows != static_cast<uint32_t>(corpus.rows()) ||
+        header.dim != static_cast<uint32_t>(corpus.dim()) ||
+        header.fingerprint != corpusFingerprint(corpus)) {
+        SHAPE_LOGI("El índice HNSW es de otro corpus, se ignora");
+        return nullptr;
+    }
+    if (header.M < 2 || header.rows == 0 ||
+        header.entryPoint < 0 || header.entryPoint >= static_cast<int32_t>(header.rows)) {
+        SHAPE_LOGE("Índice HNSW no válido");
+        return nullptr;
+    }
+
+    HnswParams params;
+    params.M = header.M;
+    params.efSearch = header.efSearch;
+    unique_ptr<HnswIndex> index(new HnswIndex(corpus, params));
+    index->entryPoint_ = header.entryPoint;
+    index->maxLevel_ = header.maxLevel;
+
+    // Lectura con comprobación de límites: un fichero truncado o corrupto
+    // no puede dejar ids fuera del corpus
+    size_t offset = sizeof(header);
+    auto read = [&](int32_t* out, size_t count) {
+        if (size - offset < sizeof(int32_t) * count) return false;
+        memcpy(out, data + offset, sizeof(int32_t) * count);
+        offset += sizeof(int32_t) * count;
+        return true;
+    };
+
+    if (!read(index->levels_.data(), header.rows)) return nullptr;
+
+    for (uint32_t node = 0; node < header.rows; node++) {
+        int level = index->levels_[node];
+        if (level < 0 || level > header.maxLevel) return nullptr;
+        if (level > 0) {
+            index->upperLinks_[node].assign(static_cast<size_t>(level) * (1 + params.M), 0);
+        }
+
+        for (int l = 0; l <= level; l++) {
+            int32_t* list = index->links(node, l);
+            if (!read(list, 1) || list[0] < 0 || list[0] > index->maxLinks(l)) return nullptr;
+            if (!read(list + 1, list[0])) return nullptr;
+            for (int i = 1; i <= list[0]; i++) {
+                if (list[i] < 0 || list[i] >= static_cast<int32_t>(header.rows)) return nullptr;
+            }
+        }
+    }
+
+    if (index->levels_[header.entryPoint] != header.maxLevel) return nullptr;
+    return index;
+}
+
+unique_ptr<HnswIndex> HnswIndex::load(const DescriptorMatrix& corpus, const string& filename) {
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) return nullptr;
+
+    vector<char> buffer((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    unique_ptr<HnswIndex> index = fromBuffer(corpus, buffer.data(), buffer.size());
+    if (index) {
+        SHAPE_LOGI("Índice HNSW cargado: %s", filename.c_str());
+    }
+    return index;
+}
@@ -0,0 +1,92 @@
+/**
+ * HNSW (Hierarchical Navigable Small World, Malkov & Yashunin 2016) sobre
+ * un DescriptorMatrix.
+ *
+ * - Cada fila es un nodo con un nivel aleatorio (distribución geométrica);
+ *   en cada nivel se enlaza con hasta M vecinos (2M en el nivel 0),
+ *   elegidos con la heurística de diversidad del artículo.
+ * - La búsqueda baja de forma voraz por los niveles superiores y explora
+ *   el nivel 0 con una lista de efSearch candidatos.
+ * - Las distancias usan el mismo kernel SIMD que la fuerza bruta.
+ *
+ * Formato del fichero (little-endian):
+ *   HnswFileHeader
+ *   int32  levels[rows]
+ *   por nodo y por nivel 0..level: uint32 count + int32 ids[count]
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "nn_index.h"
+
+struct HnswParams {
+    int M = 16;                 // vecinos por nodo en niveles > 0 (2M en el nivel 0)
+    int efConstruction = 100;   // candidatos al insertar
+    int efSearch = 64;          // candidatos al buscar (más = mejor recall, más lento)
+    uint64_t seed = 42;         // niveles aleatorios reproducibles
+};
+
+#pragma pack(push, 1)
+struct HnswFileHeader {
+    char magic[4];              // "SHPH"
+    uint32_t version;
+    uint32_t rows;
+    uint32_t dim;
+    uint32_t M;
+    uint32_t efSearch;
+    int32_t entryPoint;
+    int32_t maxLevel;
+    uint64_t fingerprint;       // corpusFingerprint del corpus indexado
+};
+#pragma pack(pop)
+
+class HnswIndex : public NearestNeighborIndex {
+public:
+    static std::unique_ptr<HnswIndex> build(const DescriptorMatrix& corpus,
+                                            const HnswParams& params = HnswParams());
+
+    // nullptr si el buffer no es un índice válido para `corpus`
+    static std::unique_ptr<HnswIndex> fromBuffer(const DescriptorMatrix& corpus,
+                                                 const char* data, size_t size);
+    static std::unique_ptr<HnswIndex> load(const DescriptorMatrix& corpus, const std::string& filename);
+
+    IndexKind kind() const override { return IndexKind::Hnsw; }
+    int search(const float* query, float* distance) const override;
+    bool save(const std::string& filename) const override;
+
+    void setEfSearch(int efSearch) { params_.efSearch = efSearch; }
+
+private:
+    using Candidate = std::pair<float, int>;    // {distancia², nodo}
+
+    HnswIndex(const DescriptorMatrix& corpus, const HnswParams& params);
+
+    int maxLinks(int level) const { return level == 0 ? 2 * params_.M : params_.M; }
+
+    // Lista de vecinos de `node` en `level`: [count, id0, id1, ...]
+    int32_t* links(int node, int level);
+    const int32_t* links(int node, int level) const;
+
+    float distance(const float* query, int node) const;
+    float distance(int a, int b) const { return distance(corpus_.row(a), b); }
+
+    int greedySearch(const float* query, int entry, int level) const;
+    std::vector<Candidate> searchLayer(const float* query, int entry, int ef, int level) const;
+    std::vector<int> selectNeighbors(std::vector<Candidate>& candidates, int maxCount) const;
+
+    void insert(int node, int level);
+    void connect(int neighbor, int node, int level);
+
+    HnswParams params_;
+    int entryPoint_ = -1;
+    int maxLevel_ = -1;
+    std::vector<int32_t> levels_;               // nivel de cada nodo
+    std::vector<int32_t> baseLinks_;            // nivel 0: rows × (1 + 2M)
+    std::vector<std::vector<int32_t>> upperLinks_;   // niveles 1..level: level × (1 + M)
+};
@@ -0,0 +1,159 @@
+#include "hu_descriptor.h"
+
+#include <cmath>
+#include <cstdint>
+
+#include "shape_log.h"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+/**
+ * Σ w, Σ w·i, Σ w·i², Σ w·i³ de un bloque (i = 0..MOMENT_BLOCK-1 desde el
+ * inicio del bloque). Exactas en int32: 255 · Σ i³ = 255 · 246016 < 2^31.
+ */
+inline void blockSums(const uint8_t* __restrict pixels, int32_t& s0, int32_t& s1,
+                      int32_t& s2, int32_t& s3) {
+    int32_t a0 = 0, a1 = 0, a2 = 0, a3 = 0;
+    for (int i = 0; i < MOMENT_BLOCK; i++) {
+        int32_t w = pixels[i];
+        int32_t wi = w * i;
+        a0 += w;
+        a1 += wi;
+        a2 += wi * i;
+        a3 += wi * i * i;
+    }
+    s0 = a0;
+    s1 = a1;
+    s2 = a2;
+    s3 = a3;
+}
+
+}  // namespace
+
+// PASO 1: PREPROCESADO (como extract_hu_moments del notebook)
+
+void binarizeOtsu(const Mat& image, Mat& binary, Mat& gray) {
+    const Mat* source = &image;
+    if (image.channels() == 3 || image.channels() == 4) {
+        cvtColor(image, gray, image.channels() == 4 ? COLOR_BGRA2GRAY : COLOR_BGR2GRAY);
+        source = &gray;
+    }
+    
+    // Limpiar ruido con la mediana antes de binarizar
+    medianBlur(*source, binary, 5);
+    threshold(binary, binary, 0, 255, THRESH_BINARY_INV | THRESH_OTSU);
+}
+
+// PASO 2: MOMENTOS EN UNA PASADA
+
+/**
+ * Por fila: sumas de los bloques de MOMENT_BLOCK píxeles desplazadas a la
+ * columna X0 del bloque con el binomio (x = X0 + i), en int64 (exactas
+ * hasta filas de miles de píxeles); los píxeles sobrantes, uno a uno.
+ * Por imagen: m_pq = Σ_y y^q · R_p(y) en double, como cv::moments.
+ */
+Moments binaryMoments(const Mat& binary) {
+    CV_Assert(binary.type() == CV_8UC1);
+    
+    double m00 = 0, m10 = 0, m01 = 0, m20 = 0, m11 = 0, m02 = 0;
+    double m30 = 0, m21 = 0, m12 = 0, m03 = 0;
+    const int width = binary.cols;
+    const int blocks = width / MOMENT_BLOCK;
+    
+    for (int y = 0; y < binary.rows; y++) {
+        const uint8_t* row = binary.ptr<uint8_t>(y);
+        int64_t r0 = 0, r1 = 0, r2 = 0, r3 = 0;
+        
+        for (int b = 0; b < blocks; b++) {
+            int32_t s0, s1, s2, s3;
+            blockSums(row + b * MOMENT_BLOCK, s0, s1, s2, s3);
+            if (s0 == 0) continue;
+            
+            int64_t x0 = static_cast<int64_t>(b) * MOMENT_BLOCK;
+            r0 += s0;
+            r1 += s1 + x0 * s0;
+            r2 += s2 + 2 * x0 * s1 + x0 * x0 * s0;
+            r3 += s3 + 3 * x0 * s2 + 3 * x0 * x0 * s1 + x0 * x0 * x0 * s0;
+        }
+        for (int x = blocks * MOMENT_BLOCK; x < width; x++) {
+            int64_t w = row[x];
+            r0 += w;
+            r1 += w * x;
+            r2 += w * x * x;
+            r3 += w * x * x * x;
+        }
+        if (r0 == 0) continue;
+        
+        double fy = y;
+        double rows[4] = {static_cast<double>(r0), static_cast<double>(r1),
+                          static_cast<double>(r2), static_cast<double>(r3)};
+        m00 += rows[0];
+        m10 += rows[1];
+        m20 += rows[2];
+        m30 += rows[3];
+        m01 += fy * rows[0];
+        m11 += fy * rows[1];
+        m21 += fy * rows[2];
+        m02 += fy * fy * rows[0];
+        m12 += fy * fy * rows[1];
+        m03 += fy * fy * fy * rows[0];
+    }
+    
+    // El constructor calcula los momentos centrales y normalizados
+    return Moments(m00, m10, m01, m20, m11, m02, m30, m21, m12, m03);
+}
+
+// PASO 3: INVARIANTES DE HU + LOG
+
+void huFeatures(const Moments& moments, float* features) {
+    double hu[NUM_HU_MOMENTS];
+    HuMoments(moments, hu);
+    
+    // -sign(h)·log10|h|: los invariantes van de ~1e-1 a ~1e-20
+    for (int i = 0; i < NUM_HU_MOMENTS; i++) {
+        features[i] = (hu[i] == 0.0) ? 0.0f
+            : static_cast<float>(-copysign(1.0, hu[i]) * log10(fabs(hu[i])));
+    }
+}
+
+// F. PRINCIPAL: DESCRIPTOR DE HU
+
+/**
+ * Pipeline de Hu sobre los búferes de `context` (gray y binary); el
+ * descriptor (NUM_HU_MOMENTS valores) queda en context.features. En el
+ * resumen, contourArea = píxeles de la forma y contourPoints = 0 (no hay
+ * contorno).
+ */
+bool extractHuFeatures(const Mat& image, ExtractionContext& context, ExtractionSummary* summary) {
+    int64 start = getTickCount();
+    ExtractionSummary localSummary;
+    ExtractionSummary& info = summary ? *summary : localSummary;
+    info = ExtractionSummary();
+    
+    // PASO 1: Binarizar
+    binarizeOtsu(image, context.binary, context.gray);
+    
+    // PASO 2: Momentos
+    Moments moments = binaryMoments(context.binary);
+    info.contourArea = moments.m00 / 255.0;
+    if (moments.m00 <= 0) {
+        SHAPE_LOGE("Imagen sin forma tras la binarización");
+        info.failedStage = "momentos";
+        context.features.clear();
+        return false;
+    }
+    
+    // PASO 3: Invariantes de Hu
+    context.features.resize(NUM_HU_MOMENTS);
+    huFeatures(moments, context.features.data());
+    
+    info.ok = true;
+    info.elapsedMs = 1000.0 * (getTickCount() - start) / getTickFrequency();
+    
+    SHAPE_LOGD("Descriptor de Hu extraído (m00 = %g)", moments.m00);
+    
+    return true;
+}
@@ -0,0 +1,39 @@
+/**
+ * Descriptor de momentos de Hu (el de la parte 1, en C++).
+ *
+ * Mismo preprocesado que extract_hu_moments del notebook: gris, mediana de
+ * 5×5, umbral de Otsu invertido (forma en blanco), momentos de la imagen
+ * binaria (ponderados por el valor 0/255, como cv2.moments), los 7
+ * invariantes de Hu y la transformación logarítmica -sign(h)·log10|h|.
+ *
+ * Los momentos geométricos m00..m03 salen de una sola pasada por la imagen
+ * (binaryMoments): bloques de MOMENT_BLOCK píxeles con sumas enteras
+ * exactas de w, w·i, w·i², w·i³ (bucle de longitud fija, vectorizado) que
+ * después se desplazan a la columna del bloque. Los momentos centrales y
+ * normalizados los calcula cv::Moments a partir de ellos, igual que
+ * cv::moments.
+ */
+
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <string>
+
+#include "shape_pipeline.h"
+
+const int NUM_HU_MOMENTS = 7;       // invariantes de Hu por descriptor
+const int MOMENT_BLOCK = 32;        // píxeles por bloque de binaryMoments
+
+// PASO 1: gris + mediana 5×5 + Otsu invertido; `gray` se reutiliza entre llamadas
+void binarizeOtsu(const cv::Mat& image, cv::Mat& binary, cv::Mat& gray);
+
+// PASO 2: momentos de una imagen CV_8UC1 (ponderados por el valor del píxel) en una pasada
+cv::Moments binaryMoments(const cv::Mat& binary);
+
+// PASO 3: los 7 invariantes de Hu con -sign(h)·log10|h| (0 si h = 0)
+void huFeatures(const cv::Moments& moments, float* features);
+
+// Pipeline completo con los búferes de `context`; descriptor en context.features
+bool extractHuFeatures(const cv::Mat& image, ExtractionContext& context,
+                       ExtractionSummary* summary = nullptr);
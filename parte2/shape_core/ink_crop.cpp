@@ -0,0 +1,123 @@
+#include "ink_crop.h"
+
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cstdint>
+
+#include "shape_log.h"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+// Bytes por bloque: longitud fija para que el mínimo se vectorice también con -O2
+const int BLOCK = 64;
+
+inline uint8_t blockMinimum(const uint8_t* __restrict bytes) {
+    uint8_t minimum = 255;
+    for (int i = 0; i < BLOCK; i++) {
+        minimum = bytes[i] < minimum ? bytes[i] : minimum;
+    }
+    return minimum;
+}
+
+// ¿Algún byte < threshold en row[begin, end)?
+bool hasInk(const uint8_t* row, int begin, int end, uint8_t threshold) {
+    int i = begin;
+    for (; i + BLOCK <= end; i += BLOCK) {
+        if (blockMinimum(row + i) < threshold) return true;
+    }
+    for (; i < end; i++) {
+        if (row[i] < threshold) return true;
+    }
+    return false;
+}
+
+// Primer byte < threshold en row[begin, end); end si no hay
+int firstInk(const uint8_t* row, int begin, int end, uint8_t threshold) {
+    int i = begin;
+    while (i + BLOCK <= end && blockMinimum(row + i) >= threshold) i += BLOCK;
+    for (; i < end; i++) {
+        if (row[i] < threshold) return i;
+    }
+    return end;
+}
+
+// Último byte < threshold en row[begin, end); begin - 1 si no hay
+int lastInk(const uint8_t* row, int begin, int end, uint8_t threshold) {
+    int i = end;
+    while (i - BLOCK >= begin && blockMinimum(row + i - BLOCK) >= threshold) i -= BLOCK;
+    for (; i > begin; i--) {
+        if (row[i - 1] < threshold) return i - 1;
+    }
+    return begin - 1;
+}
+
+}  // namespace
+
+/**
+ * Recorre la imagen como bytes: con fondo blanco opaco basta con que algún
+ * byte de un píxel (incluido el alfa, que vale 255) esté por debajo del
+ * umbral. Coste: las filas hasta la primera y desde la última con tinta, y
+ * en medio sólo lo que queda fuera de [left, right].
+ */
+Rect findInkBounds(const Mat& image, int threshold) {
+    CV_Assert(image.depth() == CV_8U);
+    
+    const int channels = image.channels();
+    const int rowBytes = image.cols * channels;
+    const uint8_t limit = static_cast<uint8_t>(std::clamp(threshold, 0, 255));
+    
+    // PASO 1: primera y última fila con tinta
+    int top = 0;
+    while (top < image.rows && !hasInk(image.ptr<uint8_t>(top), 0, rowBytes, limit)) top++;
+    if (top == image.rows) return Rect();
+    
+    int bottom = image.rows - 1;
+    while (!hasInk(image.ptr<uint8_t>(bottom), 0, rowBytes, limit)) bottom--;
+    
+    // PASO 2: columnas, buscando sólo fuera de la caja ya conocida (en bytes)
+    int left = rowBytes, right = -1;
+    for (int y = top; y <= bottom; y++) {
+        const uint8_t* row = image.ptr<uint8_t>(y);
+        if (left > 0) left = firstInk(row, 0, left, limit);
+        if (right < rowBytes - 1) right = lastInk(row, right + 1, rowBytes, limit);
+    }
+    
+    int x0 = left / channels;
+    int x1 = right / channels;
+    return Rect(x0, top, x1 - x0 + 1, bottom - top + 1);
+}
+
+Rect inkRegion(const Mat& image, int margin, int threshold) {
+    Rect full(0, 0, image.cols, image.rows);
+    Rect bounds = findInkBounds(image, threshold);
+    if (bounds.empty()) {
+        SHAPE_LOGD("Sin tinta: se usa la imagen completa");
+        return full;
+    }
+    
+    Rect region(bounds.x - margin, bounds.y - margin,
+                bounds.width + 2 * margin, bounds.height + 2 * margin);
+    region &= full;
+    
+    SHAPE_LOGD("Región con tinta: %dx%d de %dx%d", region.width, region.height, image.cols, image.rows);
+    
+    return region;
+}
+
+void downscaleToFit(const Mat& image, Mat& scaled, int maxSide) {
+    if (maxSide <= 0 || max(image.cols, image.rows) <= maxSide) {
+        scaled = image;
+        return;
+    }
+    
+    // La primera reducción lee `image`; las siguientes, el resultado anterior
+    pyrDown(image, scaled);
+    while (max(scaled.cols, scaled.rows) > maxSide) {
+        pyrDown(scaled, scaled);
+    }
+    
+    SHAPE_LOGD("Imagen reducida: %dx%d → %dx%d", image.cols, image.rows, scaled.cols, scaled.rows);
+}
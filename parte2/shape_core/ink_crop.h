@@ -0,0 +1,36 @@
+/**
+ * Pre-etapa del pipeline para dibujos sobre un lienzo grande (el bitmap a
+ * pantalla completa de DrawingView): casi todo es fondo blanco y
+ * adaptiveThreshold + morphologyEx cuestan lo mismo por píxel haya trazo o no.
+ *
+ * - findInkBounds: caja de los píxeles con tinta (algún canal < umbral),
+ *   recorriendo las filas en bloques de bytes de longitud fija
+ *   (mínimo vectorizado) y, entre la primera y la última fila con tinta,
+ *   sólo los bytes fuera de la caja ya encontrada.
+ * - inkRegion: esa caja con margen, para recortar con un ROI sin copia.
+ * - downscaleToFit: pyrDown hasta que el lado mayor quepa en maxSide.
+ *
+ * El margen por defecto cubre el radio del filtro de adaptiveThreshold (5)
+ * y de las dos morfologías, así la binarización del recorte coincide con
+ * la de la imagen completa alrededor del trazo.
+ */
+
+#pragma once
+
+#include <opencv2/core.hpp>
+
+const int INK_THRESHOLD = 128;      // canal por debajo → tinta (fondo blanco)
+const int INK_MARGIN = 16;          // píxeles de margen alrededor de la tinta
+
+// Caja de los píxeles con algún canal < threshold (imagen CV_8U de 1-4 canales); vacía si no hay tinta
+cv::Rect findInkBounds(const cv::Mat& image, int threshold = INK_THRESHOLD);
+
+// Caja de tinta ampliada con `margin` y limitada a la imagen; la imagen entera si no hay tinta
+cv::Rect inkRegion(const cv::Mat& image, int margin = INK_MARGIN, int threshold = INK_THRESHOLD);
+
+/**
+ * `scaled` = `image` reducida con pyrDown (mitad por paso) hasta que su
+ * lado mayor sea <= maxSide. Si ya cabe (o maxSide <= 0) `scaled`
+ * comparte los datos de `image`, sin copia.
+ */
+void downscaleToFit(const cv::Mat& image, cv::Mat& scaled, int maxSide);
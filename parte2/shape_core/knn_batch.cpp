@@ -0,0 +1,201 @@
+#include "knn_batch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "aligned_allocator.h"
+#include "distance_kernels.h"
+#include "shape_log.h"
+
+using namespace std;
+
+namespace {
+
+const int MR = TILE_QUERIES;     // consultas por tesela (acumuladores en registros)
+const int NR = TILE_ROWS;       // filas del corpus por tesela
+const int BLOCK_ROWS = 256;     // filas por bloque empaquetado: 256 × 16 floats = 16 KB (L1)
+
+/**
+ * Empaqueta las filas [start, start + count) del corpus en paneles de NR
+ * filas traspuestos: panel[p][k][j] = fila (p·NR + j), columna k. Así la
+ * tesela (distanceTile) lee NR valores contiguos por columna. Las filas que faltan
+ * para completar el último panel valen 0 con norma infinita: su distancia
+ * es infinita y nunca entran en el top-k.
+ */
+void packBlock(const DescriptorMatrix& corpus, int start, int count, float* panel, float* norms) {
+    const int stride = corpus.stride();
+    const int panels = (count + NR - 1) / NR;
+
+    for (int p = 0; p < panels; p++) {
+        float* dst = panel + static_cast<size_t>(p) * stride * NR;
+        for (int j = 0; j < NR; j++) {
+            int r = p * NR + j;
+            if (r >= count) {
+                for (int k = 0; k < stride; k++) dst[k * NR + j] = 0.0f;
+                norms[r] = numeric_limits<float>::infinity();
+                continue;
+            }
+
+            const float* row = corpus.row(start + r);
+            float norm = 0.0f;
+            for (int k = 0; k < stride; k++) {
+                dst[k * NR + j] = row[k];
+                norm += row[k] * row[k];
+            }
+            norms[r] = norm;
+        }
+    }
+}
+
+// Mínimo de una fila de la tesela (vectorizable, sin cadena de dependencias)
+inline float tileRowMinimum(const float* row) {
+    float lanes[NR / 2];
+    for (int j = 0; j < NR / 2; j++) {
+        lanes[j] = row[j] < row[j + NR / 2] ? row[j] : row[j + NR / 2];
+    }
+    return *min_element(lanes, lanes + NR / 2);
+}
+
+// Los k candidatos más cercanos de una consulta (montículo de máximos por distancia²)
+class TopK {
+public:
+    explicit TopK(int k) : k_(k) { heap_.reserve(k); }
+
+    // Distancia² que hay que mejorar para entrar
+    float threshold() const {
+        return static_cast<int>(heap_.size()) < k_ ? numeric_limits<float>::infinity() : heap_.front().first;
+    }
+
+    void push(float squared, int row) {
+        if (static_cast<int>(heap_.size()) < k_) {
+            heap_.push_back({squared, row});
+            push_heap(heap_.begin(), heap_.end());
+        } else if (squared < heap_.front().first) {
+            pop_heap(heap_.begin(), heap_.end());
+            heap_.back() = {squared, row};
+            push_heap(heap_.begin(), heap_.end());
+        }
+    }
+
+    const vector<pair<float, int>>& candidates() const { return heap_; }
+
+private:
+    int k_;
+    vector<pair<float, int>> heap_;
+};
+
+float exactDistance(const float* a, const float* b, int dim) {
+    float sum = 0.0f;
+    for (int k = 0; k < dim; k++) {
+        float diff = a[k] - b[k];
+        sum += diff * diff;
+    }
+    return sqrt(sum);
+}
+
+// Vecinos ordenados por distancia exacta + votación por mayoría
+KnnPrediction vote(const TopK& top, const float* query, const DescriptorMatrix& corpus) {
+    KnnPrediction prediction;
+
+    vector<pair<float, int>> neighbors;
+    for (const auto& [squared, row] : top.candidates()) {
+        neighbors.push_back({exactDistance(query, corpus.row(row), corpus.dim()), row});
+    }
+    sort(neighbors.begin(), neighbors.end());
+
+    for (const auto& [distance, row] : neighbors) {
+        prediction.rows.push_back(row);
+        prediction.distances.push_back(distance);
+    }
+
+    // Recorrido en orden de distancia: ante empate gana la primera clase vista
+    vector<int> votes(corpus.classNames().size(), 0);
+    int bestLabel = -1;
+    for (const auto& [distance, row] : neighbors) {
+        votes[corpus.labelId(row)]++;
+    }
+    for (const auto& [distance, row] : neighbors) {
+        int label = corpus.labelId(row);
+        if (bestLabel < 0 || votes[label] > votes[bestLabel]) {
+            bestLabel = label;
+            prediction.label = corpus.classNames()[label];
+            prediction.distance = distance;
+        }
+    }
+    return prediction;
+}
+
+}  // namespace
+
+vector<KnnPrediction> classifyBatch(const DescriptorMatrix& queries, const DescriptorMatrix& corpus, int k) {
+    if (corpus.empty() || queries.empty()) {
+        SHAPE_LOGE("Corpus o consultas vacíos");
+        return {};
+    }
+    if (queries.dim() != corpus.dim()) {
+        SHAPE_LOGE("Descriptores de diferente tamaño");
+        return {};
+    }
+
+    const int stride = corpus.stride();
+    const int numQueries = queries.rows();
+    k = max(1, min(k, corpus.rows()));
+
+    vector<float> queryNorms(numQueries);
+    for (int i = 0; i < numQueries; i++) {
+        const float* q = queries.row(i);
+        float norm = 0.0f;
+        for (int c = 0; c < stride; c++) norm += q[c] * q[c];
+        queryNorms[i] = norm;
+    }
+
+    vector<TopK> tops(numQueries, TopK(k));
+    AlignedVector<float> panel(static_cast<size_t>(BLOCK_ROWS) * stride);
+    float norms[BLOCK_ROWS];
+    vector<float> zeroQuery(stride, 0.0f);
+    float tile[MR][NR];
+
+    // Bloque de corpus (en L1) × todas las consultas (en L2) → actualizar top-k
+    for (int start = 0; start < corpus.rows(); start += BLOCK_ROWS) {
+        int count = min(BLOCK_ROWS, corpus.rows() - start);
+        packBlock(corpus, start, count, panel.data(), norms);
+        int panels = (count + NR - 1) / NR;
+
+        for (int q0 = 0; q0 < numQueries; q0 += MR) {
+            int valid = min(MR, numQueries - q0);
+            const float* q[MR];
+            float qNorms[MR] = {};
+            for (int i = 0; i < MR; i++) {
+                q[i] = i < valid ? queries.row(q0 + i) : zeroQuery.data();
+                if (i < valid) qNorms[i] = queryNorms[q0 + i];
+            }
+
+            for (int p = 0; p < panels; p++) {
+                distanceTile(q, qNorms, panel.data() + static_cast<size_t>(p) * stride * NR,
+                             norms + p * NR, stride, &tile[0][0]);
+
+                // Casi siempre ninguna fila de la tesela mejora el top-k:
+                // se comprueba el mínimo y sólo entonces se recorre
+                for (int i = 0; i < valid; i++) {
+                    TopK& top = tops[q0 + i];
+                    if (tileRowMinimum(tile[i]) >= top.threshold()) continue;
+
+                    for (int j = 0; j < NR; j++) {
+                        if (tile[i][j] < top.threshold()) {
+                            top.push(tile[i][j], start + p * NR + j);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    vector<KnnPrediction> predictions;
+    predictions.reserve(numQueries);
+    for (int i = 0; i < numQueries; i++) {
+        predictions.push_back(vote(tops[i], queries.row(i), corpus));
+    }
+    return predictions;
+}
@@ -0,0 +1,36 @@
+/**
+ * Clasificación k-NN por lotes.
+ *
+ * Las distancias de todas las consultas a todo el corpus se calculan por
+ * bloques como |q|² + |c|² − 2·q·cᵀ: el término q·cᵀ es un producto de
+ * matrices (SGEMM) con bloques de corpus empaquetados que caben en L1 y
+ * teselas de consultas en registros. Cada consulta mantiene un montículo
+ * con sus k mejores filas y al final se vota por mayoría.
+ *
+ * Las distancias que se devuelven se recalculan de forma exacta para los k
+ * vecinos (la forma expandida pierde precisión por cancelación cuando q y c
+ * están muy cerca).
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "descriptor_matrix.h"
+
+struct KnnPrediction {
+    std::string label;              // clase más votada entre los k vecinos
+    float distance = 0;             // distancia al vecino más cercano de esa clase
+    std::vector<int> rows;          // filas del corpus de los k vecinos, de menor a mayor distancia
+    std::vector<float> distances;   // distancias euclídeas de esos vecinos
+};
+
+/**
+ * Clasifica todas las filas de `queries` (misma dimensión que `corpus`)
+ * con sus k vecinos más cercanos. Empates en la votación: gana la clase
+ * cuyo vecino aparece antes (el más cercano). Devuelve una predicción por
+ * consulta; vacío si el corpus está vacío o las dimensiones no coinciden.
+ */
+std::vector<KnnPrediction> classifyBatch(const DescriptorMatrix& queries,
+                                         const DescriptorMatrix& corpus, int k = 1);
@@ -0,0 +1,148 @@
+/**
+ * Hilo de trabajo con buzón de una sola plaza: "gana el último".
+ *
+ * Pensado para clasificar mientras se dibuja: cada ACTION_MOVE envía el
+ * trazo actual y sólo interesa el resultado del más reciente. submit()
+ * nunca bloquea; si el hilo está ocupado, el trabajo nuevo sustituye al
+ * que esperaba en el buzón (que se descarta sin procesar). Así no se
+ * acumulan trabajos viejos y la latencia queda acotada a un trabajo en
+ * curso + el último enviado.
+ *
+ * El manejador recibe el trabajo y su número de secuencia (creciente por
+ * envío) y entrega el resultado por su cuenta (callback); los resultados
+ * salen en orden de secuencia.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+template <typename Job>
+class LatestWorker {
+public:
+    using Handler = std::function<void(Job& job, uint64_t sequence)>;
+
+    struct Stats {
+        uint64_t submitted = 0;     // llamadas a submit
+        uint64_t processed = 0;     // trabajos entregados al manejador
+        uint64_t replaced = 0;      // sustituidos en el buzón o descartados por stop
+    };
+
+    explicit LatestWorker(Handler handler)
+        : handler_(std::move(handler)), thread_([this] { workerLoop(); }) {}
+
+    // Termina el trabajo en curso y descarta el que quede en el buzón
+    ~LatestWorker() {
+        stop();
+        thread_.join();
+    }
+
+    LatestWorker(const LatestWorker&) = delete;
+    LatestWorker& operator=(const LatestWorker&) = delete;
+
+    // Deja `job` en el buzón (sustituye al pendiente) y devuelve su número de secuencia
+    uint64_t submit(Job job) {
+        uint64_t sequence;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sequence = ++stats_.submitted;
+            if (stopping_) {
+                stats_.replaced++;          // parado: nadie vaciaría el buzón
+                return sequence;
+            }
+            if (pending_) stats_.replaced++;
+            pending_ = std::move(job);
+            pendingSequence_ = sequence;
+        }
+        wakeCv_.notify_one();
+        return sequence;
+    }
+
+    /**
+     * Bloquea hasta que el buzón está vacío y el hilo parado. Si el
+     * manejador lanzó una excepción, se relanza aquí la primera.
+     */
+    void drain() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idleCv_.wait(lock, [this] { return !pending_ && !busy_; });
+
+        if (firstError_) {
+            std::exception_ptr error = firstError_;
+            firstError_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    /**
+     * Pide al hilo que pare sin esperarlo: el trabajo en curso termina y el
+     * del buzón (o los que se envíen después) se descarta sin procesar.
+     * drain() sigue funcionando: espera sólo al trabajo en curso.
+     */
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            if (pending_) {
+                pending_.reset();
+                stats_.replaced++;
+            }
+        }
+        wakeCv_.notify_one();
+        idleCv_.notify_all();
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+private:
+    void workerLoop() {
+        while (true) {
+            Job job;
+            uint64_t sequence;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                busy_ = false;
+                if (!pending_) idleCv_.notify_all();
+                wakeCv_.wait(lock, [this] { return stopping_ || pending_; });
+                if (stopping_) return;
+
+                job = std::move(*pending_);
+                pending_.reset();
+                sequence = pendingSequence_;
+                busy_ = true;
+                stats_.processed++;
+            }
+
+            // Fuera del cerrojo: submit() sigue sin bloquear mientras se procesa
+            try {
+                handler_(job, sequence);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!firstError_) firstError_ = std::current_exception();
+            }
+        }
+    }
+
+    Handler handler_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wakeCv_;
+    std::condition_variable idleCv_;
+    std::optional<Job> pending_;            // buzón (protegido por mutex_)
+    uint64_t pendingSequence_ = 0;
+    bool busy_ = false;
+    bool stopping_ = false;
+    Stats stats_;
+    std::exception_ptr firstError_;
+
+    std::thread thread_;                    // último miembro: arranca con todo inicializado
+};
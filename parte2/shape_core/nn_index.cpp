@@ -0,0 +1,283 @@
+#include "nn_index.h"
+
+#include <opencv2/flann.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+#include "hnsw_index.h"
+#include "shape_log.h"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+// Recorrido completo con el kernel SIMD; exacto
+class BruteForceIndex : public NearestNeighborIndex {
+public:
+    explicit BruteForceIndex(const DescriptorMatrix& corpus) : NearestNeighborIndex(corpus) {}
+
+    IndexKind kind() const override { return IndexKind::BruteForce; }
+
+    int search(const float* query, float* distance) const override {
+        return nearestNeighbor(query, corpus_, distance);
+    }
+
+    bool save(const string&) const override { return true; }
+};
+
+// Fichero junto al índice de FLANN con la huella del corpus indexado
+#pragma pack(push, 1)
+struct KdTreeFingerprint {
+    char magic[4];              // "SHPK"
+    uint32_t rows;
+    uint32_t dim;
+    uint64_t fingerprint;       // corpusFingerprint del corpus indexado
+};
+#pragma pack(pop)
+
+string fingerprintFilename(const string& filename) {
+    return filename + ".fingerprint";
+}
+
+/**
+ * Bosque de KD-trees aleatorizados de FLANN. La matriz de FLANN es una
+ * vista sin copia sobre el corpus con `stride` columnas: las columnas de
+ * relleno valen 0 en todas las filas, no cambian la distancia y FLANN
+ * nunca las elige para dividir (varianza 0).
+ *
+ * cv::flann sólo comprueba filas y columnas al cargar, así que save()
+ * escribe además la huella del corpus (<fichero>.fingerprint) y load()
+ * descarta el índice si no coincide. knnSearch no es const ni está
+ * documentado como reentrante: las consultas se serializan con un mutex.
+ */
+class KdTreeIndex : public NearestNeighborIndex {
+public:
+    static const int TREES = 4;     // árboles aleatorizados
+    static const int CHECKS = 64;   // hojas visitadas por consulta
+
+    explicit KdTreeIndex(const DescriptorMatrix& corpus)
+        : NearestNeighborIndex(corpus),
+          features_(corpus.rows(), corpus.stride(), CV_32F, const_cast<float*>(corpus.data())) {}
+
+    void build() {
+        index_.build(features_, flann::KDTreeIndexParams(TREES));
+    }
+
+    bool load(const string& filename) {
+        ifstream probe(filename);
+        if (!probe.good()) return false;
+
+        KdTreeFingerprint stored = {};
+        ifstream sidecar(fingerprintFilename(filename), ios::binary);
+        if (!sidecar.read(reinterpret_cast<char*>(&stored), sizeof(stored)) ||
+            memcmp(stored.magic, "SHPK", 4) != 0 ||
+            stored.rows != static_cast<uint32_t>(corpus_.rows()) ||
+            stored.dim != static_cast<uint32_t>(corpus_.dim()) ||
+            stored.fingerprint != corpusFingerprint(corpus_)) {
+            SHAPE_LOGI("El índice KD-tree es de otro corpus, se ignora");
+            return false;
+        }
+        return index_.load(features_, filename);
+    }
+
+    IndexKind kind() const override { return IndexKind::KdTree; }
+
+    int search(const float* query, float* distance) const override {
+        if (corpus_.empty()) return -1;
+
+        PaddedQuery padded(query, corpus_);
+        Mat q(1, corpus_.stride(), CV_32F, const_cast<float*>(padded.data()));
+        int row = -1;
+        float squared = 0;
+        Mat indices(1, 1, CV_32S, &row);
+        Mat dists(1, 1, CV_32F, &squared);
+
+        // FLANN_DIST_L2 devuelve distancias al cuadrado
+        {
+            lock_guard<mutex> lock(searchMutex_);
+            index_.knnSearch(q, indices, dists, 1, flann::SearchParams(CHECKS));
+        }
+        if (distance) *distance = sqrt(squared);
+        return row;
+    }
+
+    bool save(const string& filename) const override {
+        index_.save(filename);
+
+        KdTreeFingerprint stored = {};
+        memcpy(stored.magic, "SHPK", 4);
+        stored.rows = corpus_.rows();
+        stored.dim = corpus_.dim();
+        stored.fingerprint = corpusFingerprint(corpus_);
+        ofstream sidecar(fingerprintFilename(filename), ios::binary);
+        sidecar.write(reinterpret_cast<const char*>(&stored), sizeof(stored));
+        if (!sidecar) {
+            SHAPE_LOGE("Error escribiendo el índice: %s", filename.c_str());
+            return false;
+        }
+
+        SHAPE_LOGI("Índice KD-tree guardado: %s", filename.c_str());
+        return true;
+    }
+
+private:
+    Mat features_;
+    // knnSearch no es const en cv::flann; protegido por searchMutex_
+    mutable flann::Index index_;
+    mutable mutex searchMutex_;
+};
+
+}  // namespace
+
+const char* indexKindName(IndexKind kind) {
+    switch (kind) {
+        case IndexKind::KdTree: return "kdtree";
+        case IndexKind::Hnsw:   return "hnsw";
+        default:                return "brute";
+    }
+}
+
+bool parseIndexKind(const string& name, IndexKind& kind) {
+    for (IndexKind candidate : {IndexKind::BruteForce, IndexKind::KdTree, IndexKind::Hnsw}) {
+        if (name == indexKindName(candidate)) {
+            kind = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+unique_ptr<NearestNeighborIndex> buildIndex(IndexKind kind, const DescriptorMatrix& corpus) {
+    switch (kind) {
+        case IndexKind::KdTree: {
+            auto index = make_unique<KdTreeIndex>(corpus);
+            if (!corpus.empty()) index->build();
+            return index;
+        }
+        case IndexKind::Hnsw:
+            return HnswIndex::build(corpus);
+        default:
+            return make_unique<BruteForceIndex>(corpus);
+    }
+}
+
+unique_ptr<NearestNeighborIndex> loadIndex(IndexKind kind, const DescriptorMatrix& corpus,
+                                           const string& filename) {
+    switch (kind) {
+        case IndexKind::KdTree: {
+            auto index = make_unique<KdTreeIndex>(corpus);
+            if (corpus.empty() || !index->load(filename)) return nullptr;
+            SHAPE_LOGI("Índice KD-tree cargado: %s", filename.c_str());
+            return index;
+        }
+        case IndexKind::Hnsw:
+            return HnswIndex::load(corpus, filename);
+        default:
+            return make_unique<BruteForceIndex>(corpus);
+    }
+}
+
+string indexFilename(const string& corpusFile, IndexKind kind) {
+    return corpusFile + "." + indexKindName(kind);
+}
+
+unique_ptr<NearestNeighborIndex> loadOrBuildIndex(IndexKind kind, const DescriptorMatrix& corpus,
+                                                  const string& corpusFile) {
+    if (kind == IndexKind::BruteForce) {
+        return buildIndex(kind, corpus);
+    }
+
+    string filename = indexFilename(corpusFile, kind);
+    unique_ptr<NearestNeighborIndex> index = loadIndex(kind, corpus, filename);
+    if (index) return index;
+
+    auto start = chrono::steady_clock::now();
+    index = buildIndex(kind, corpus);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    SHAPE_LOGI("Índice %s construido en %.2f s", indexKindName(kind), seconds);
+
+    index->save(filename);
+    return index;
+}
+
+// FNV-1a de 64 bits
+uint64_t corpusFingerprint(const DescriptorMatrix& corpus) {
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+    };
+
+    int rows = corpus.rows();
+    int dim = corpus.dim();
+    mix(&rows, sizeof(rows));
+    mix(&dim, sizeof(dim));
+
+    const int SAMPLES = 1024;
+    int step = max(1, rows / SAMPLES);
+    for (int r = 0; r < rows; r += step) {
+        mix(corpus.row(r), sizeof(float) * dim);
+        mix(corpus.label(r).data(), corpus.label(r).size());
+    }
+    return hash;
+}
+
+pair<string, float> classify(const ShapeDescriptor& testDescriptor, const NearestNeighborIndex& index) {
+    const DescriptorMatrix& corpus = index.corpus();
+    if (corpus.empty()) {
+        SHAPE_LOGE("Corpus de entrenamiento vacío");
+        return {"unknown", 1e9};
+    }
+
+    if (static_cast<int>(testDescriptor.features.size()) != corpus.dim()) {
+        SHAPE_LOGE("Descriptores de diferente tamaño");
+        return {"unknown", 1e9};
+    }
+
+    float minDistance = 0;
+    int bestRow = index.search(testDescriptor.features.data(), &minDistance);
+    if (bestRow < 0) return {"unknown", 1e9};
+
+    SHAPE_LOGD("Clasificación: %s (distancia: %.4f)", corpus.label(bestRow).c_str(), minDistance);
+    return {corpus.label(bestRow), minDistance};
+}
+
+/**
+ * Recall@1: una consulta acierta si el índice devuelve la misma fila que la
+ * fuerza bruta o una a la misma distancia (empates).
+ */
+IndexQuality measureIndexQuality(const NearestNeighborIndex& index, const DescriptorMatrix& queries) {
+    IndexQuality quality;
+    if (queries.empty() || index.corpus().empty()) return quality;
+
+    int n = queries.rows();
+    vector<int> expected(n);
+    vector<float> expectedDistance(n);
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        expected[i] = nearestNeighbor(queries.row(i), index.corpus(), &expectedDistance[i]);
+    }
+    double bruteSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    int hits = 0;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        float distance = 0;
+        int row = index.search(queries.row(i), &distance);
+        if (row == expected[i] || distance <= expectedDistance[i] * (1 + 1e-6f)) hits++;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    quality.recall = static_cast<double>(hits) / n;
+    quality.queriesPerSecond = seconds > 0 ? n / seconds : 0;
+    quality.bruteQueriesPerSecond = bruteSeconds > 0 ? n / bruteSeconds : 0;
+    return quality;
+}
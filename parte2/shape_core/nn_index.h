@@ -0,0 +1,96 @@
+/**
+ * Índices de vecino más cercano intercambiables detrás de classify.
+ *
+ * - brute:  recorrido completo con el kernel SIMD (exacto). Es el que usa
+ *           el corpus de 80 filas de la app; no necesita fichero.
+ * - kdtree: bosque de KD-trees aleatorizados de FLANN (cv::flann), aproximado.
+ * - hnsw:   grafo jerárquico de mundo pequeño (ver hnsw_index.h), aproximado.
+ *
+ * Los índices aproximados se guardan junto al corpus (<corpus>.kdtree,
+ * <corpus>.hnsw) con la huella del corpus (corpusFingerprint) y se cargan
+ * sin reconstruir mientras el corpus no cambie.
+ * Un índice guarda una copia de la matriz (comparte su memoria), así el
+ * corpus vive al menos tanto como el índice.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "descriptor_matrix.h"
+
+enum class IndexKind {
+    BruteForce = 0,
+    KdTree,
+    Hnsw
+};
+
+const char* indexKindName(IndexKind kind);
+
+// "brute" | "kdtree" | "hnsw"; false si no se reconoce
+bool parseIndexKind(const std::string& name, IndexKind& kind);
+
+class NearestNeighborIndex {
+public:
+    virtual ~NearestNeighborIndex() = default;
+
+    virtual IndexKind kind() const = 0;
+
+    /**
+     * Fila del corpus más cercana a `query` (dim() valores) y su distancia
+     * euclídea. -1 si el corpus está vacío. Se puede llamar desde varios
+     * hilos a la vez con cualquier índice (el KD-tree serializa sus
+     * consultas internamente, así que no escala con los hilos).
+     */
+    virtual int search(const float* query, float* distance) const = 0;
+
+    // Persiste el índice en `filename`; la fuerza bruta no escribe nada
+    virtual bool save(const std::string& filename) const = 0;
+
+    const DescriptorMatrix& corpus() const { return corpus_; }
+
+protected:
+    explicit NearestNeighborIndex(DescriptorMatrix corpus) : corpus_(std::move(corpus)) {}
+
+    DescriptorMatrix corpus_;
+};
+
+std::unique_ptr<NearestNeighborIndex> buildIndex(IndexKind kind, const DescriptorMatrix& corpus);
+
+// nullptr si el fichero no existe o no corresponde a `corpus`
+std::unique_ptr<NearestNeighborIndex> loadIndex(IndexKind kind, const DescriptorMatrix& corpus,
+                                                const std::string& filename);
+
+// Fichero del índice junto al corpus: data/corpus.bin → data/corpus.bin.hnsw
+std::string indexFilename(const std::string& corpusFile, IndexKind kind);
+
+/**
+ * Carga el índice guardado junto a `corpusFile`; si no existe (o es de otro
+ * corpus) lo construye y lo guarda para la próxima vez.
+ */
+std::unique_ptr<NearestNeighborIndex> loadOrBuildIndex(IndexKind kind, const DescriptorMatrix& corpus,
+                                                       const std::string& corpusFile);
+
+/**
+ * Huella del corpus (filas, dimensión y hasta 1024 filas muestreadas con
+ * sus etiquetas) para detectar un índice guardado de otro corpus sin leer
+ * millones de filas.
+ */
+uint64_t corpusFingerprint(const DescriptorMatrix& corpus);
+
+// Vecino más cercano con un índice: {etiqueta, distancia}
+std::pair<std::string, float> classify(const ShapeDescriptor& testDescriptor,
+                                       const NearestNeighborIndex& index);
+
+// Calidad de un índice aproximado frente a la fuerza bruta
+struct IndexQuality {
+    double recall = 0;                  // fracción de consultas con el mismo vecino (recall@1)
+    double queriesPerSecond = 0;        // índice evaluado
+    double bruteQueriesPerSecond = 0;   // fuerza bruta, como referencia
+};
+
+// `queries` son filas con la misma dimensión que el corpus del índice
+IndexQuality measureIndexQuality(const NearestNeighborIndex& index, const DescriptorMatrix& queries);
@@ -0,0 +1,156 @@
+#include "quantized_corpus.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "distance_kernels.h"
+#include "half_float.h"
+
+using namespace std;
+
+namespace {
+
+const int BLOCK_ROWS = 256;     // distancias aproximadas por bloque (en L1)
+
+// Distancia² exacta sobre el stride completo (consulta y fila con relleno a 0)
+float exactSquared(const float* query, const float* row, int stride) {
+    float sum = 0.0f;
+    for (int k = 0; k < stride; k++) {
+        float diff = query[k] - row[k];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+}  // namespace
+
+const char* quantizationName(Quantization quantization) {
+    return quantization == Quantization::Int8 ? "int8" : "f16";
+}
+
+bool parseQuantization(const string& name, Quantization& quantization) {
+    for (Quantization candidate : {Quantization::Float16, Quantization::Int8}) {
+        if (name == quantizationName(candidate)) {
+            quantization = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+QuantizedCorpus QuantizedCorpus::build(const DescriptorMatrix& corpus, Quantization quantization) {
+    QuantizedCorpus quantized;
+    quantized.quantization_ = quantization;
+    quantized.corpus_ = corpus;
+    if (corpus.empty()) return quantized;
+
+    const int rows = corpus.rows();
+    const int dim = corpus.dim();
+    const int stride = corpus.stride();
+    const size_t cells = static_cast<size_t>(rows) * stride;
+
+    if (quantization == Quantization::Float16) {
+        // El relleno (0.0f) se convierte en 0 de float16: sigue sin aportar distancia
+        quantized.halves_.resize(cells);
+        const float* src = corpus.data();
+        for (size_t i = 0; i < cells; i++) {
+            quantized.halves_[i] = floatToHalf(src[i]);
+        }
+        return quantized;
+    }
+
+    // int8: rango [mín, máx] de cada dimensión en 256 niveles
+    vector<float> low(dim, numeric_limits<float>::max());
+    vector<float> high(dim, numeric_limits<float>::lowest());
+    for (int r = 0; r < rows; r++) {
+        const float* row = corpus.row(r);
+        for (int k = 0; k < dim; k++) {
+            low[k] = min(low[k], row[k]);
+            high[k] = max(high[k], row[k]);
+        }
+    }
+
+    // Relleno: scale = offset = 0 → valor decuantizado 0, como la consulta
+    quantized.scale_.assign(stride, 0.0f);
+    quantized.offset_.assign(stride, 0.0f);
+    for (int k = 0; k < dim; k++) {
+        quantized.offset_[k] = low[k];
+        quantized.scale_[k] = (high[k] - low[k]) / 255.0f;
+    }
+
+    quantized.codes_.assign(cells, 0);
+    for (int r = 0; r < rows; r++) {
+        const float* row = corpus.row(r);
+        uint8_t* codes = quantized.codes_.data() + static_cast<size_t>(r) * stride;
+        for (int k = 0; k < dim; k++) {
+            float scale = quantized.scale_[k];
+            if (scale <= 0.0f) continue;    // dimensión constante: código 0 = offset
+            float level = round((row[k] - low[k]) / scale);
+            codes[k] = static_cast<uint8_t>(min(255.0f, max(0.0f, level)));
+        }
+    }
+    return quantized;
+}
+
+size_t QuantizedCorpus::memoryBytes() const {
+    size_t bytes = static_cast<size_t>(rows()) * sizeof(int32_t);
+    bytes += halves_.size() * sizeof(uint16_t);
+    bytes += codes_.size() * sizeof(uint8_t);
+    bytes += (scale_.size() + offset_.size()) * sizeof(float);
+    return bytes;
+}
+
+int QuantizedCorpus::search(const float* query, float* distance, int rerank) const {
+    if (corpus_.empty()) return -1;
+
+    const int stride = corpus_.stride();
+    PaddedQuery q(query, corpus_);
+    rerank = max(1, min(rerank, rows()));
+
+    // PASO 1: los `rerank` candidatos con menor distancia aproximada
+    // (montículo de máximos: la raíz es el umbral para entrar)
+    vector<pair<float, int>> candidates;
+    candidates.reserve(rerank);
+    float threshold = numeric_limits<float>::infinity();
+    alignas(64) float block[BLOCK_ROWS];
+
+    for (int start = 0; start < rows(); start += BLOCK_ROWS) {
+        int count = min(BLOCK_ROWS, rows() - start);
+        size_t offset = static_cast<size_t>(start) * stride;
+        if (quantization_ == Quantization::Float16) {
+            squaredDistancesF16(q.data(), halves_.data() + offset, count, stride, block);
+        } else {
+            squaredDistancesInt8(q.data(), codes_.data() + offset, count, stride,
+                                 scale_.data(), offset_.data(), block);
+        }
+
+        // Con el montículo lleno casi ningún bloque tiene candidatos
+        if (blockMinimum(block, count) >= threshold) continue;
+        for (int j = 0; j < count; j++) {
+            if (block[j] >= threshold) continue;
+            if (static_cast<int>(candidates.size()) == rerank) {
+                pop_heap(candidates.begin(), candidates.end());
+                candidates.pop_back();
+            }
+            candidates.push_back({block[j], start + j});
+            push_heap(candidates.begin(), candidates.end());
+            if (static_cast<int>(candidates.size()) == rerank) threshold = candidates.front().first;
+        }
+    }
+
+    // PASO 2: reordenar con la distancia exacta sobre el corpus float
+    int bestRow = -1;
+    float bestSquared = numeric_limits<float>::infinity();
+    for (const auto& [approximate, row] : candidates) {
+        float squared = exactSquared(q.data(), corpus_.row(row), stride);
+        if (squared < bestSquared || (squared == bestSquared && row < bestRow)) {
+            bestSquared = squared;
+            bestRow = row;
+        }
+    }
+
+    if (distance) *distance = sqrt(bestSquared);
+    return bestRow;
+}
@@ -0,0 +1,69 @@
+/**
+ * Corpus cuantizado para índices residentes en memoria de decenas de
+ * millones de formas.
+ *
+ * - float16: cada característica en IEEE binary16 (2 bytes, ~3 dígitos).
+ * - int8: un byte por característica con escala por dimensión,
+ *   valor = offset[k] + scale[k] · código, donde offset/scale cubren el
+ *   rango [mín, máx] de la dimensión k en el corpus.
+ *
+ * Con 15 armónicos (stride 16) una fila pasa de 64 bytes a 32 (float16)
+ * o 16 (int8). La búsqueda recorre los códigos con los kernels SIMD que
+ * decuantizan al vuelo, guarda los `rerank` mejores candidatos y los
+ * reordena con la distancia exacta sobre el corpus float. Ese corpus sólo
+ * se lee para esas pocas filas por consulta: puede ser la vista mapeada de
+ * un corpus binario (corpus_binary.h) sin ocupar RAM residente.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "aligned_allocator.h"
+#include "descriptor_matrix.h"
+
+enum class Quantization {
+    Float16,
+    Int8
+};
+
+const char* quantizationName(Quantization quantization);   // "f16" | "int8"
+
+// false si el nombre no es válido
+bool parseQuantization(const std::string& name, Quantization& quantization);
+
+class QuantizedCorpus {
+public:
+    static const int DEFAULT_RERANK = 16;   // candidatos reordenados en float
+
+    QuantizedCorpus() = default;
+
+    static QuantizedCorpus build(const DescriptorMatrix& corpus, Quantization quantization);
+
+    Quantization quantization() const { return quantization_; }
+    int rows() const { return corpus_.rows(); }
+    bool empty() const { return corpus_.empty(); }
+
+    // Corpus float de referencia (para reordenar y para las etiquetas)
+    const DescriptorMatrix& corpus() const { return corpus_; }
+
+    // Bytes de códigos + etiquetas + tablas de escala (comparable con DescriptorMatrix::memoryBytes)
+    size_t memoryBytes() const;
+
+    /**
+     * Vecino más cercano: top `rerank` por distancia aproximada sobre los
+     * códigos y, entre ellos, el mejor por distancia exacta (que es la que
+     * se devuelve). `query` tiene dim() valores. -1 si el corpus está vacío.
+     */
+    int search(const float* query, float* distance, int rerank = DEFAULT_RERANK) const;
+
+private:
+    Quantization quantization_ = Quantization::Float16;
+    DescriptorMatrix corpus_;
+    AlignedVector<uint16_t> halves_;    // float16: rows × stride
+    AlignedVector<uint8_t> codes_;      // int8: rows × stride
+    std::vector<float> scale_;          // int8: stride valores (0 en el relleno)
+    std::vector<float> offset_;
+};
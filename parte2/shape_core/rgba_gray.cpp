@@ -0,0 +1,61 @@
+#include "rgba_gray.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "rgba_gray.cpp supone little-endian (R en el byte bajo de cada píxel)"
+#endif
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+// Pesos de cvtColor para 8 bits (yuv_shift = 14)
+const uint32_t R_WEIGHT = 4899;
+const uint32_t G_WEIGHT = 9617;
+const uint32_t B_WEIGHT = 1868;
+const int SHIFT = 14;
+
+// Píxeles por bloque: longitud fija para que el bucle se vectorice también con -O2
+const int BLOCK = 32;
+
+/**
+ * COUNT píxeles: cada píxel se lee como un uint32 (little-endian: R en el
+ * byte bajo), así las cargas son contiguas y los canales salen con
+ * desplazamientos y máscaras en lugar de lecturas con salto de 4 bytes.
+ */
+template <int COUNT>
+inline void grayPixels(const uint8_t* __restrict rgba, uint8_t* __restrict gray) {
+    uint32_t pixels[COUNT];
+    memcpy(pixels, rgba, sizeof(pixels));
+    for (int x = 0; x < COUNT; x++) {
+        uint32_t p = pixels[x];
+        uint32_t y = (p & 0xFF) * R_WEIGHT + ((p >> 8) & 0xFF) * G_WEIGHT +
+                     ((p >> 16) & 0xFF) * B_WEIGHT + (1u << (SHIFT - 1));
+        gray[x] = static_cast<uint8_t>(y >> SHIFT);
+    }
+}
+
+}  // namespace
+
+void rgbaToGray(const Mat& rgba, Mat& gray) {
+    CV_Assert(rgba.type() == CV_8UC4);
+    
+    gray.create(rgba.rows, rgba.cols, CV_8UC1);
+    const int width = rgba.cols;
+    
+    for (int y = 0; y < rgba.rows; y++) {
+        const uint8_t* src = rgba.ptr<uint8_t>(y);
+        uint8_t* dst = gray.ptr<uint8_t>(y);
+        
+        int x = 0;
+        for (; x + BLOCK <= width; x += BLOCK) {
+            grayPixels<BLOCK>(src + 4 * x, dst + x);
+        }
+        for (; x < width; x++) {
+            grayPixels<1>(src + 4 * x, dst + x);
+        }
+    }
+}
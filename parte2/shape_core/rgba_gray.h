@@ -0,0 +1,16 @@
+/**
+ * Conversión RGBA (Android ARGB_8888, bytes R, G, B, A) → gris de 8 bits
+ * en una sola pasada, para leer el bitmap bloqueado directamente sin la
+ * copia RGBA intermedia ni el cvtColor posterior.
+ *
+ * Mismos pesos en punto fijo que cvtColor(COLOR_RGBA2GRAY) con 8 bits:
+ *   Y = (4899·R + 9617·G + 1868·B + 2^13) >> 14
+ * El alfa se ignora (el lienzo de DrawingView es opaco).
+ */
+
+#pragma once
+
+#include <opencv2/core.hpp>
+
+// `rgba` CV_8UC4 (puede ser un ROI con stride); `gray` CV_8UC1 del mismo tamaño (se reutiliza si ya lo es)
+void rgbaToGray(const cv::Mat& rgba, cv::Mat& gray);
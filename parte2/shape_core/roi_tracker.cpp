@@ -0,0 +1,163 @@
+#include "roi_tracker.h"
+
+#include <opencv2/imgproc.hpp>
+#include <limits>
+
+#include "contour_resample.h"
+#include "shape_log.h"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+// Solapamiento entre cajas: área de la intersección / área de la unión
+double intersectionOverUnion(const Rect& a, const Rect& b) {
+    double intersection = (a & b).area();
+    double unionArea = a.area() + b.area() - intersection;
+    return unionArea > 0 ? intersection / unionArea : 0.0;
+}
+
+Point2f boxCenter(const Rect& box) {
+    return Point2f(box.x + box.width * 0.5f, box.y + box.height * 0.5f);
+}
+
+}  // namespace
+
+RoiTracker::RoiTracker(int margin, int rescanInterval, double minArea)
+    : margin_(margin), rescanInterval_(max(1, rescanInterval)), minArea_(minArea) {}
+
+void RoiTracker::reset() {
+    objects_.clear();
+    framesSinceScan_ = 0;
+}
+
+/**
+ * PASO 1 del seguimiento:
+ * - con objetos seguidos y sin tocar barrido, cada objeto se busca sólo en
+ *   su ROI (trackObject); los que no aparecen se descartan
+ * - si toca barrido (o no queda ninguno), extractShapeObjects sobre todo el
+ *   fotograma
+ * Dos objetos que acaban en el mismo contorno se quedan en uno (el de id menor).
+ */
+const vector<TrackedObject>& RoiTracker::update(const Mat& frame, TrackingStats* stats) {
+    TrackingStats localStats;
+    TrackingStats& info = stats ? *stats : localStats;
+    info = TrackingStats();
+    
+    if (objects_.empty() || framesSinceScan_ + 1 >= rescanInterval_) {
+        fullScan(frame);
+        info.fullScan = true;
+        info.pixels = frame.total();
+        return objects_;
+    }
+    framesSinceScan_++;
+    
+    size_t kept = 0;
+    for (size_t i = 0; i < objects_.size(); i++) {
+        TrackedObject& object = objects_[i];
+        if (!trackObject(frame, object, info.pixels)) {
+            info.lost++;
+            continue;
+        }
+        
+        bool duplicate = false;
+        for (size_t j = 0; j < kept && !duplicate; j++) {
+            duplicate = intersectionOverUnion(objects_[j].box, object.box) > 0.9;
+        }
+        if (duplicate) continue;
+        
+        if (kept != i) objects_[kept] = move(object);
+        kept++;
+    }
+    objects_.resize(kept);
+    
+    SHAPE_LOGD("Seguimiento: %zu objetos, %zu px binarizados, %zu perdidos",
+               objects_.size(), info.pixels, info.lost);
+    
+    return objects_;
+}
+
+/**
+ * Barrido completo: todos los objetos del fotograma. Cada uno hereda el id
+ * del objeto anterior con el que más se solapa (si lo hay y nadie lo ha
+ * tomado ya); el resto recibe un id nuevo.
+ */
+void RoiTracker::fullScan(const Mat& frame) {
+    vector<ShapeObject> found = extractShapeObjects(frame, minArea_);
+    vector<bool> taken(objects_.size(), false);
+    
+    vector<TrackedObject> objects(found.size());
+    for (size_t i = 0; i < found.size(); i++) {
+        int bestPrevious = -1;
+        double bestOverlap = 0;
+        for (size_t j = 0; j < objects_.size(); j++) {
+            double overlap = intersectionOverUnion(found[i].box, objects_[j].box);
+            if (!taken[j] && overlap > bestOverlap) {
+                bestOverlap = overlap;
+                bestPrevious = static_cast<int>(j);
+            }
+        }
+        
+        if (bestPrevious >= 0) {
+            taken[bestPrevious] = true;
+            objects[i].id = objects_[bestPrevious].id;
+        } else {
+            objects[i].id = nextId_++;
+        }
+        objects[i].box = found[i].box;
+        objects[i].area = found[i].area;
+        objects[i].features = move(found[i].features);
+    }
+    
+    objects_ = move(objects);
+    framesSinceScan_ = 0;
+    
+    SHAPE_LOGD("Barrido completo: %zu objetos", objects_.size());
+}
+
+/**
+ * Busca el objeto en su caja anterior ampliada con margin_ px: binarización
+ * y contornos sólo en esa ROI (vista del fotograma, sin copia) y, de los
+ * contornos con área suficiente, el de centro más cercano al de la caja
+ * anterior. Actualiza caja, área y descriptor (pasos 2-6 con los búferes
+ * del tracker). `pixels` acumula el área de la ROI.
+ */
+bool RoiTracker::trackObject(const Mat& frame, TrackedObject& object, size_t& pixels) {
+    Rect roi(object.box.x - margin_, object.box.y - margin_,
+             object.box.width + 2 * margin_, object.box.height + 2 * margin_);
+    roi &= Rect(0, 0, frame.cols, frame.rows);
+    if (roi.empty()) return false;
+    pixels += roi.area();
+    
+    // PASO 1: Binarizar y buscar contornos sólo en la ROI
+    binarizeImage(frame(roi), context_.binary, context_.gray);
+    findContoursAbove(context_.binary, minArea_, context_.contours);
+    
+    Point2f previous = boxCenter(object.box) - Point2f(roi.tl());
+    int best = -1;
+    double bestDistance = numeric_limits<double>::max();
+    for (size_t i = 0; i < context_.contours.size(); i++) {
+        Point2f offset = boxCenter(boundingRect(context_.contours[i])) - previous;
+        double distance = offset.dot(offset);
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            best = static_cast<int>(i);
+        }
+    }
+    if (best < 0) return false;
+    
+    const vector<Point>& contour = context_.contours[best];
+    object.box = boundingRect(contour) + roi.tl();
+    object.area = contourArea(contour);
+    
+    // PASOS 2-6: el descriptor no depende de la posición (señal centrada)
+    if (!resampleContour(contour, NUM_POINTS, context_.resampled, context_.cumulativeLength)) {
+        object.features.clear();
+        return true;
+    }
+    computeDescriptor(context_.resampled, context_.magnitudes, object.features);
+    if (context_.magnitudes.size() < 2 || context_.magnitudes[1] < 1e-5) object.features.clear();
+    
+    return true;
+}
@@ -0,0 +1,66 @@
+/**
+ * Seguimiento de objetos entre fotogramas por regiones de interés (ROI).
+ *
+ * En un vídeo las formas apenas se mueven de un fotograma al siguiente,
+ * pero extractShapeObjects binariza y recorre el fotograma entero cada vez.
+ * RoiTracker guarda la caja de cada objeto y, en el fotograma siguiente,
+ * sólo binariza y busca contornos en esa caja ampliada con `margin` px
+ * (el desplazamiento máximo que se sigue). Cada `rescanInterval`
+ * fotogramas, o si no queda ningún objeto, hace un barrido completo para
+ * encontrar objetos nuevos; los identificadores se conservan emparejando
+ * cajas por solapamiento (IoU).
+ *
+ * Un objeto que no aparece en su ROI se descarta hasta el siguiente
+ * barrido completo. Un tracker por flujo: no es seguro entre hilos.
+ */
+
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <vector>
+
+#include "shape_pipeline.h"
+
+const int TRACK_MARGIN = 32;                // px alrededor de la caja anterior
+const int TRACK_RESCAN_INTERVAL = 30;       // fotogramas entre barridos completos
+
+struct TrackedObject {
+    int id = -1;                    // estable mientras se siga el objeto
+    cv::Rect box;                   // caja envolvente en el fotograma
+    double area = 0;                // px²
+    std::vector<float> features;    // descriptor normalizado (vacío si |F[1]| ≈ 0)
+};
+
+// Trabajo de un fotograma, para comparar con el barrido completo
+struct TrackingStats {
+    bool fullScan = false;          // barrido completo en este fotograma
+    size_t pixels = 0;              // píxeles binarizados (suma de las ROI)
+    size_t lost = 0;                // objetos no encontrados en su ROI
+};
+
+class RoiTracker {
+public:
+    explicit RoiTracker(int margin = TRACK_MARGIN, int rescanInterval = TRACK_RESCAN_INTERVAL,
+                        double minArea = MIN_OBJECT_AREA);
+
+    // Procesa el siguiente fotograma y devuelve los objetos encontrados en él
+    const std::vector<TrackedObject>& update(const cv::Mat& frame, TrackingStats* stats = nullptr);
+
+    const std::vector<TrackedObject>& objects() const { return objects_; }
+
+    // Olvida los objetos: el siguiente update hace un barrido completo
+    void reset();
+
+private:
+    void fullScan(const cv::Mat& frame);
+    bool trackObject(const cv::Mat& frame, TrackedObject& object, size_t& pixels);
+
+    int margin_;
+    int rescanInterval_;
+    double minArea_;
+
+    ExtractionContext context_;     // búferes de las ROI, reutilizados
+    std::vector<TrackedObject> objects_;
+    long framesSinceScan_ = 0;
+    int nextId_ = 0;
+};
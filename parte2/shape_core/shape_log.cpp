@@ -0,0 +1,46 @@
+#include "shape_log.h"
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+
+namespace {
+
+void defaultSink(LogLevel level, const char* message) {
+    if (level == LogLevel::Error) {
+        std::fprintf(stderr, " %s\n", message);
+    } else {
+        std::fprintf(stdout, "✓ %s\n", message);
+    }
+}
+
+std::atomic<LogSink> currentSink{defaultSink};
+std::atomic<int> currentLevel{static_cast<int>(LogLevel::Debug)};
+
+}  // namespace
+
+void setLogSink(LogSink sink) {
+    currentSink.store(sink);
+}
+
+void setLogLevel(LogLevel level) {
+    currentLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+bool logEnabled(LogLevel level) {
+    return static_cast<int>(level) >= currentLevel.load(std::memory_order_relaxed) &&
+           currentSink.load(std::memory_order_relaxed) != nullptr;
+}
+
+void logMessage(LogLevel level, const char* format, ...) {
+    LogSink sink = currentSink.load();
+    if (sink == nullptr) return;
+
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    sink(level, buffer);
+}
@@ -0,0 +1,54 @@
+/**
+ * Registro de mensajes del pipeline con destino (sink) intercambiable.
+ *
+ * La biblioteca no escribe directamente en cout ni en logcat: cada
+ * ejecutable instala su sink con setLogSink(). Por defecto los mensajes de
+ * información van a stdout y los errores a stderr.
+ *
+ * Hay dos filtros por nivel:
+ * - En compilación: SHAPE_LOG_MIN_LEVEL (0 = debug, 1 = info, 2 = error).
+ *   Las llamadas por debajo de ese nivel desaparecen del binario, sin
+ *   evaluar siquiera sus argumentos.
+ * - En ejecución: setLogLevel(). Un mensaje filtrado no se formatea.
+ */
+
+#pragma once
+
+enum class LogLevel {
+    Debug = 0,      // mensajes por etapa del pipeline
+    Info = 1,       // mensajes por operación (corpus cargado, etc.)
+    Error = 2
+};
+
+#ifndef SHAPE_LOG_MIN_LEVEL
+#define SHAPE_LOG_MIN_LEVEL 0
+#endif
+
+// Recibe el mensaje ya formateado (sin salto de línea final)
+using LogSink = void (*)(LogLevel level, const char* message);
+
+// Instala el sink global; nullptr descarta todos los mensajes
+void setLogSink(LogSink sink);
+
+// Nivel mínimo en ejecución (por defecto Debug: se emite todo lo compilado)
+void setLogLevel(LogLevel level);
+bool logEnabled(LogLevel level);
+
+// Formatea al estilo printf y envía el mensaje al sink actual
+void logMessage(LogLevel level, const char* format, ...)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+#define SHAPE_LOG_AT(level, ...)                                            \
+    do {                                                                    \
+        if (static_cast<int>(level) >= SHAPE_LOG_MIN_LEVEL &&               \
+            logEnabled(level)) {                                            \
+            logMessage(level, __VA_ARGS__);                                 \
+        }                                                                   \
+    } while (0)
+
+#define SHAPE_LOGD(...) SHAPE_LOG_AT(LogLevel::Debug, __VA_ARGS__)
+#define SHAPE_LOGI(...) SHAPE_LOG_AT(LogLevel::Info, __VA_ARGS__)
+#define SHAPE_LOGE(...) SHAPE_LOG_AT(LogLevel::Error, __VA_ARGS__)
@@ -0,0 +1,767 @@
+#include "shape_pipeline.h"
+
+#include <opencv2/imgproc.hpp>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+#include "contour_resample.h"
+#include "hu_descriptor.h"
+#include "zernike_descriptor.h"
+#include "shape_log.h"
+#include "spectrum.h"
+#include "thread_pool.h"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+// Contexto de extractShapeDescriptor: uno por hilo, vive lo que el hilo
+ExtractionContext& threadContext() {
+    thread_local ExtractionContext context;
+    return context;
+}
+
+}  // namespace
+
+// PASO 1: PREPROCESAMIENTO Y EXTRACCIÓN DE CONTORNO
+
+/**
+ * Preprocesa la imagen y deja la forma en blanco sobre negro.
+ * 
+ * Pipeline:
+ * - Convertir a escala de grises 
+ * - Binarización con umbral adaptativo 
+ * - operaciones morfológicas para limpiar ruido
+ * 
+ * `gray` y `binary` sólo se reservan si cambia el tamaño de la imagen.
+ */
+void binarizeImage(const Mat& image, Mat& binary, Mat& gray) {
+    // Elemento estructurante: se construye una vez (sólo lectura, seguro entre hilos)
+    static const Mat kernel = getStructuringElement(MORPH_ELLIPSE, Size(3, 3));
+    
+    // Con una imagen gris se usa directamente (sin soltar el búfer de `gray`)
+    const Mat* source = &image;
+    if (image.channels() == 3 || image.channels() == 4) {
+        cvtColor(image, gray, COLOR_BGR2GRAY);
+        source = &gray;
+    }
+    
+    adaptiveThreshold(*source, binary, 255, ADAPTIVE_THRESH_GAUSSIAN_C, 
+                      THRESH_BINARY_INV, 11, 2);
+    
+    // Operaciones morfológicas para limpiar ruido
+    morphologyEx(binary, binary, MORPH_CLOSE, kernel);  
+    morphologyEx(binary, binary, MORPH_OPEN, kernel);   
+}
+
+void binarizeImage(const Mat& image, Mat& binary) {
+    Mat gray;
+    binarizeImage(image, binary, gray);
+}
+
+/**
+ * Extrae los contornos externos de la imagen binaria y se queda con el
+ * de mayor área (devuelta en `area` si no es nulo). findContours puede
+ * modificar `binary`. `contours` y `contour` conservan su capacidad entre
+ * llamadas.
+ */
+bool findLargestContour(Mat& binary, vector<Point>& contour, double* area,
+                        vector<vector<Point>>& contours) {
+    // Extraer todos los contornos
+    findContours(binary, contours, RETR_EXTERNAL, CHAIN_APPROX_NONE);
+    
+    if (contours.empty()) {
+        SHAPE_LOGE("No se encontraron contornos en la imagen");
+        return false;
+    }
+    
+    // Seleccionar el contorno más grande
+    double maxArea = 0;
+    int maxIdx = 0;
+    for (size_t i = 0; i < contours.size(); i++) {
+        double area = contourArea(contours[i]);
+        if (area > maxArea) {
+            maxArea = area;
+            maxIdx = i;
+        }
+    }
+    
+    contour.assign(contours[maxIdx].begin(), contours[maxIdx].end());
+    if (area) *area = maxArea;
+    
+    if (maxArea < 100) {
+        SHAPE_LOGE("Contorno muy pequeño (área < 100 píxeles)");
+        return false;
+    }
+    
+    SHAPE_LOGD("Contorno extraído: %zu puntos, área = %.0f px²", contour.size(), maxArea);
+    
+    return true;
+}
+
+bool findLargestContour(Mat& binary, vector<Point>& contour, double* area) {
+    vector<vector<Point>> contours;
+    return findLargestContour(binary, contour, area, contours);
+}
+
+/**
+ * Preprocesa la imagen y extrae el contorno principal
+ * (binarizeImage + findLargestContour).
+ */
+bool extractContour(const Mat& image, vector<Point>& contour) {
+    Mat binary;
+    binarizeImage(image, binary);
+    return findLargestContour(binary, contour);
+}
+
+// PASO 2: INTERPOLACIÓN LINEAL A 1024 PUNTOS
+
+/**
+ * Interpola el contorno a exactamente NUM_POINTS puntos.
+ * - 1024 puntos captura suficientes detalles de la forma
+ * - El remuestreo (O(n + m), contorno cerrado) está en contour_resample.h
+ */
+vector<Point2f> interpolateContour(const vector<Point>& contour) {
+    int n = contour.size();
+    
+    if (n < 3) {
+        SHAPE_LOGE("Contorno con muy pocos puntos: %d", n);
+        return vector<Point2f>();
+    }
+    
+    vector<Point2f> interpolated = resampleContour(contour, NUM_POINTS);
+    
+    SHAPE_LOGD("Contorno interpolado: %d → %d puntos", n, NUM_POINTS);
+    
+    return interpolated;
+}
+
+// PASO 3: CALCULAR CENTROIDE
+
+/**
+ * Calcula el centroide (centro de masa) del contorno.
+ */
+Point2f calculateCentroid(const vector<Point2f>& contour) {
+    float sumX = 0, sumY = 0;
+    
+    for (const auto& pt : contour) {
+        sumX += pt.x;
+        sumY += pt.y;
+    }
+    
+    Point2f centroid(sumX / contour.size(), sumY / contour.size());
+    
+    SHAPE_LOGD("Centroide calculado: (%.2f, %.2f)", centroid.x, centroid.y);
+    
+    return centroid;
+}
+
+// PASO 4: CONSTRUIR SEÑAL COMPLEJA (COORDENADAS COMPLEJAS)
+
+/**
+ * Construye la señal compleja centrada en el centroide.
+ */
+Mat buildComplexSignal(const vector<Point2f>& contour, const Point2f& centroid) {
+    int n = contour.size();
+    
+    Mat complexSignal(n, 1, CV_32FC2);
+    
+    for (int i = 0; i < n; i++) {
+        float real = contour[i].x - centroid.x;  
+        float imag = contour[i].y - centroid.y;
+        
+        complexSignal.at<Vec2f>(i, 0) = Vec2f(real, imag);
+    }
+    
+    SHAPE_LOGD("Señal compleja construida: z(n) = (x-xc) + j(y-yc)");
+    
+    return complexSignal;
+}
+
+// PASO 5: TRANSFORMADA DE FOURIER (FFT)
+
+/**
+ * Aplica la Transformada Discreta de Fourier, es la firma de la figura
+ */
+void computeFFT(const Mat& complexSignal, vector<float>& magnitudes) {
+    Mat dftOutput;
+    
+    
+    dft(complexSignal, dftOutput, DFT_COMPLEX_OUTPUT);
+    
+    vector<Mat> planes(2);
+    split(dftOutput, planes); 
+    
+    // Calcular magnitudes
+    Mat mag;
+    magnitude(planes[0], planes[1], mag);
+    
+    magnitudes.clear();
+    for (int i = 0; i < mag.rows; i++) {
+        magnitudes.push_back(mag.at<float>(i, 0));
+    }
+    
+    SHAPE_LOGD("FFT calculada: %zu coeficientes", magnitudes.size());
+}
+
+/**
+ * Calcula sólo los coeficientes que usa el descriptor (F[0] .. F[15] por
+ * defecto) en lugar de las 1024 magnitudes de computeFFT. Mismo resultado
+ * que computeFFT en esos coeficientes (misma convención de signo que cv::dft).
+ * Si la señal no tiene SPECTRUM_POINTS muestras se usa computeFFT.
+ */
+void computeHarmonics(const Mat& complexSignal, vector<float>& magnitudes, int bins) {
+    static_assert(NUM_POINTS == SPECTRUM_POINTS, "el motor de espectro es de NUM_POINTS puntos");
+    
+    if (complexSignal.rows != SPECTRUM_POINTS || complexSignal.type() != CV_32FC2) {
+        computeFFT(complexSignal, magnitudes);
+        if (static_cast<int>(magnitudes.size()) > bins) magnitudes.resize(bins);
+        return;
+    }
+    
+    // Estructura de arrays: parte real e imaginaria por separado
+    float re[SPECTRUM_POINTS], im[SPECTRUM_POINTS];
+    for (int n = 0; n < SPECTRUM_POINTS; n++) {
+        const Vec2f& z = complexSignal.at<Vec2f>(n, 0);
+        re[n] = z[0];
+        im[n] = z[1];
+    }
+    
+    magnitudes.resize(bins);
+    spectrumMagnitudes(re, im, bins, magnitudes.data());
+    
+    SHAPE_LOGD("Espectro calculado: %d coeficientes", bins);
+}
+
+// PASO 6: NORMALIZACIÓN 
+
+/**
+ * Normalizamos los coeficientes de Fourier para invarianza a escala.
+
+ * - El primer componente F[0] es solo ENERGÍA DE LA SEÑAL
+ * - lo usamos para LOCALIZAR los demás coeficientes
+
+ */
+void normalizeDescriptor(const vector<float>& magnitudes, vector<float>& descriptor) {
+    descriptor.assign(NUM_HARMONICS, 0.0f);
+    
+    if (magnitudes.size() < 2) {
+        SHAPE_LOGE("Muy pocos coeficientes de Fourier");
+        return;
+    }
+    
+    
+    float dc = magnitudes[0];
+    
+    float fundamental = magnitudes[1];
+    
+    if (fundamental < 1e-5) {
+        SHAPE_LOGE("Fundamental muy pequeño, posible error en la señal");
+        return;
+    }
+    
+    for (int k = 1; k <= NUM_HARMONICS && k < magnitudes.size(); k++) {
+        descriptor[k - 1] = magnitudes[k] / fundamental;
+    }
+    
+    SHAPE_LOGD("Descriptor normalizado: %zu armónicos (F[0]=%g descartado)", descriptor.size(), dc);
+}
+
+vector<float> normalizeDescriptor(const vector<float>& magnitudes) {
+    vector<float> descriptor;
+    normalizeDescriptor(magnitudes, descriptor);
+    return descriptor;
+}
+
+/**
+ * Pasos 3-6 sobre un contorno de NUM_POINTS puntos: la señal centrada va
+ * directamente a dos arrays re/im en la pila (sin el Mat de
+ * buildComplexSignal) y las magnitudes y el descriptor a los vectores
+ * recibidos, que conservan su capacidad.
+ */
+void computeDescriptor(const vector<Point2f>& resampled,
+                       vector<float>& magnitudes, vector<float>& descriptor) {
+    // PASO 3: Calcular centroide
+    Point2f centroid = calculateCentroid(resampled);
+    
+    // PASOS 4-5: Señal compleja y FFT (FIRMA), sólo los coeficientes del descriptor
+    if (resampled.size() == static_cast<size_t>(SPECTRUM_POINTS)) {
+        float re[SPECTRUM_POINTS], im[SPECTRUM_POINTS];
+        for (int n = 0; n < SPECTRUM_POINTS; n++) {
+            re[n] = resampled[n].x - centroid.x;
+            im[n] = resampled[n].y - centroid.y;
+        }
+        magnitudes.resize(NUM_HARMONICS + 1);
+        spectrumMagnitudes(re, im, NUM_HARMONICS + 1, magnitudes.data());
+    } else {
+        computeHarmonics(buildComplexSignal(resampled, centroid), magnitudes);
+    }
+    
+    // PASO 6: Normalizar
+    normalizeDescriptor(magnitudes, descriptor);
+}
+
+// PASOS 3-6 POR LOTES
+
+/**
+ * Descriptores de muchos contornos con el espectro por lotes:
+ * - los contornos se centran y se intercalan de SPECTRUM_BATCH en
+ *   SPECTRUM_BATCH (muestra n del contorno c en re[n·SPECTRUM_BATCH + c])
+ * - batchSpectrumMagnitudes calcula F[0]..F[NUM_HARMONICS] de todo el grupo
+ * - la normalización escribe directamente en la fila de la matriz
+ * Sin Mat ni vectores por contorno: los búferes se reservan una vez por llamada.
+ */
+Mat computeDescriptorBatch(const vector<vector<Point2f>>& contours, vector<float>* fundamentals) {
+    static_assert(NUM_POINTS == SPECTRUM_POINTS, "el motor de espectro es de NUM_POINTS puntos");
+    static_assert(NUM_HARMONICS + 1 <= BATCH_SPECTRUM_MAX_BINS, "demasiados armónicos para el lote");
+    
+    const int count = contours.size();
+    const int BINS = NUM_HARMONICS + 1;
+    
+    Mat descriptors = Mat::zeros(count, NUM_HARMONICS, CV_32F);
+    if (fundamentals) fundamentals->assign(count, 0.0f);
+    
+    vector<float> re(SPECTRUM_POINTS * SPECTRUM_BATCH), im(SPECTRUM_POINTS * SPECTRUM_BATCH);
+    float magnitudes[SPECTRUM_BATCH * BINS];
+    
+    for (int first = 0; first < count; first += SPECTRUM_BATCH) {
+        // PASOS 3-4: cada contorno centrado en su carril; los carriles sin
+        // contorno válido quedan a 0 (|F[1]| = 0 → fila a cero)
+        for (int c = 0; c < SPECTRUM_BATCH; c++) {
+            int i = first + c;
+            if (i >= count || contours[i].size() != static_cast<size_t>(NUM_POINTS)) {
+                for (int n = 0; n < SPECTRUM_POINTS; n++) {
+                    re[n * SPECTRUM_BATCH + c] = 0.0f;
+                    im[n * SPECTRUM_BATCH + c] = 0.0f;
+                }
+                continue;
+            }
+            
+            const vector<Point2f>& contour = contours[i];
+            Point2f centroid = calculateCentroid(contour);
+            for (int n = 0; n < SPECTRUM_POINTS; n++) {
+                re[n * SPECTRUM_BATCH + c] = contour[n].x - centroid.x;
+                im[n * SPECTRUM_BATCH + c] = contour[n].y - centroid.y;
+            }
+        }
+        
+        // PASO 5: F[0]..F[NUM_HARMONICS] de todo el grupo
+        batchSpectrumMagnitudes(re.data(), im.data(), BINS, magnitudes);
+        
+        // PASO 6: Normalizar por |F[1]|
+        for (int c = 0; c < SPECTRUM_BATCH && first + c < count; c++) {
+            const float* mag = magnitudes + c * BINS;
+            float fundamental = mag[1];
+            if (fundamentals) (*fundamentals)[first + c] = fundamental;
+            if (fundamental < 1e-5) continue;
+            
+            float* row = descriptors.ptr<float>(first + c);
+            for (int k = 1; k <= NUM_HARMONICS; k++) {
+                row[k - 1] = mag[k] / fundamental;
+            }
+        }
+    }
+    
+    SHAPE_LOGD("Descriptores por lotes: %d contornos", count);
+    
+    return descriptors;
+}
+
+// PASOS 2-6 DESDE UN CONTORNO VECTORIAL
+
+/**
+ * Para contornos que no salen de una imagen (los trazos del dibujo en
+ * Android): remuestreo a NUM_POINTS y pasos 3-6, sin ningún trabajo por
+ * píxel. El descriptor queda en context.features.
+ */
+bool extractContourFeatures(const vector<Point>& contour, ExtractionContext& context,
+                            ExtractionSummary* summary) {
+    int64 start = getTickCount();
+    ExtractionSummary localSummary;
+    ExtractionSummary& info = summary ? *summary : localSummary;
+    info = ExtractionSummary();
+    info.contourPoints = contour.size();
+    
+    // PASO 2: Interpolar a 1024 puntos (interpolateContour sin vector nuevo)
+    if (!resampleContour(contour, NUM_POINTS, context.resampled, context.cumulativeLength)) {
+        SHAPE_LOGE("Contorno con muy pocos puntos: %zu", contour.size());
+        info.failedStage = "interpolación";
+        context.features.clear();
+        return false;
+    }
+    
+    // PASOS 3-6: Centroide, señal compleja, FFT y normalización
+    computeDescriptor(context.resampled, context.magnitudes, context.features);
+    
+    info.ok = true;
+    info.fundamental = context.magnitudes.size() > 1 ? context.magnitudes[1] : 0.0f;
+    info.elapsedMs = 1000.0 * (getTickCount() - start) / getTickFrequency();
+    
+    return true;
+}
+
+ShapeDescriptor extractContourDescriptor(const vector<Point>& contour, const string& label,
+                                         ExtractionSummary* summary) {
+    ExtractionContext& context = threadContext();
+    if (!extractContourFeatures(contour, context, summary)) {
+        return ShapeDescriptor();
+    }
+    
+    return ShapeDescriptor(context.features, label);
+}
+
+// F. PRINCIPAL: EXTRAER DESCRIPTOR COMPLETO
+
+/**
+ * Pasos 1-2 del pipeline: contorno más grande remuestreado a NUM_POINTS
+ * (en context.resampled), con los búferes del contexto.
+ */
+bool extractResampledContour(const Mat& image, ExtractionContext& context,
+                             ExtractionSummary* summary) {
+    ExtractionSummary localSummary;
+    ExtractionSummary& info = summary ? *summary : localSummary;
+    
+    // PASO 1: Extraer contorno
+    binarizeImage(image, context.binary, context.gray);
+    if (!findLargestContour(context.binary, context.contour, &info.contourArea, context.contours)) {
+        info.failedStage = "contorno";
+        return false;
+    }
+    info.contourPoints = context.contour.size();
+    
+    // PASO 2: Interpolar a 1024 puntos (interpolateContour sin vector nuevo)
+    if (!resampleContour(context.contour, NUM_POINTS, context.resampled, context.cumulativeLength)) {
+        SHAPE_LOGE("Contorno con muy pocos puntos: %zu", context.contour.size());
+        info.failedStage = "interpolación";
+        return false;
+    }
+    
+    SHAPE_LOGD("Contorno interpolado: %zu → %d puntos", context.contour.size(), NUM_POINTS);
+    
+    return true;
+}
+
+/**
+ * Pipeline completo sobre los búferes de `context` (ver ExtractionContext):
+ * el descriptor queda en context.features.
+ */
+bool extractShapeFeatures(const Mat& image, ExtractionContext& context, ExtractionSummary* summary) {
+    int64 start = getTickCount();
+    ExtractionSummary localSummary;
+    ExtractionSummary& info = summary ? *summary : localSummary;
+    info = ExtractionSummary();
+    
+    // PASOS 1-2: Extraer contorno e interpolar a 1024 puntos
+    if (!extractResampledContour(image, context, &info)) {
+        context.features.clear();
+        return false;
+    }
+    
+    // PASOS 3-6: Centroide, señal compleja, FFT y normalización
+    computeDescriptor(context.resampled, context.magnitudes, context.features);
+    
+    info.ok = true;
+    info.fundamental = context.magnitudes.size() > 1 ? context.magnitudes[1] : 0.0f;
+    info.elapsedMs = 1000.0 * (getTickCount() - start) / getTickFrequency();
+    
+    SHAPE_LOGD("Descriptor extraído exitosamente");
+    
+    return true;
+}
+
+/**
+ * Pipeline completo
+ * 
+ * Pasos:
+ * 1. Sacar el contorno
+ * 2. Interpolar a 1024 puntos
+ * 3. Calcular centroide
+ * 4. Construir señal compleja
+ * 5. Aplicar FFT → FIRMA
+ * 6. Normalizar por |F[1]|
+ * 
+ * Si se pasa `summary`, se rellena con un resumen de la imagen (una sola
+ * estructura por imagen en vez de un mensaje por etapa).
+ * 
+ * Usa el contexto del hilo (extractShapeFeatures): las imágenes siguientes
+ * reutilizan sus búferes y sólo se reserva el ShapeDescriptor devuelto.
+ */
+ShapeDescriptor extractShapeDescriptor(const Mat& image, 
+                                       const string& label, 
+                                       const string& filename,
+                                       ExtractionSummary* summary) {
+    SHAPE_LOGD("Procesando: %s", filename.empty() ? "imagen" : filename.c_str());
+    
+    ExtractionContext& context = threadContext();
+    if (!extractShapeFeatures(image, context, summary)) {
+        return ShapeDescriptor();
+    }
+    
+    return ShapeDescriptor(context.features, label, filename);
+}
+
+/**
+ * Pipeline completo por lotes: los pasos 1-2 siguen siendo por imagen y
+ * los pasos 3-6 de todas las imágenes van en una llamada a
+ * computeDescriptorBatch. elapsedMs de cada imagen = sus pasos 1-2 más su
+ * parte proporcional del lote.
+ */
+vector<ShapeDescriptor> extractShapeDescriptorBatch(const vector<Mat>& images,
+                                                    const vector<string>& labels,
+                                                    const vector<string>& filenames,
+                                                    ExtractionSummary* summaries) {
+    const size_t count = images.size();
+    vector<ShapeDescriptor> results(count);
+    vector<ExtractionSummary> localSummaries(summaries ? 0 : count);
+    ExtractionSummary* info = summaries ? summaries : localSummaries.data();
+    
+    // PASOS 1-2 por imagen
+    ExtractionContext& context = threadContext();
+    vector<vector<Point2f>> contours;
+    vector<size_t> imageOfContour;
+    contours.reserve(count);
+    imageOfContour.reserve(count);
+    
+    for (size_t i = 0; i < count; i++) {
+        int64 start = getTickCount();
+        info[i] = ExtractionSummary();
+        
+        if (extractResampledContour(images[i], context, &info[i])) {
+            contours.push_back(context.resampled);
+            imageOfContour.push_back(i);
+        }
+        info[i].elapsedMs = 1000.0 * (getTickCount() - start) / getTickFrequency();
+    }
+    
+    // PASOS 3-6 de todo el lote
+    int64 start = getTickCount();
+    vector<float> fundamentals;
+    Mat descriptors = computeDescriptorBatch(contours, &fundamentals);
+    double batchMs = 1000.0 * (getTickCount() - start) / getTickFrequency();
+    
+    for (size_t j = 0; j < contours.size(); j++) {
+        size_t i = imageOfContour[j];
+        const float* row = descriptors.ptr<float>(j);
+        results[i] = ShapeDescriptor(vector<float>(row, row + NUM_HARMONICS), labels[i], filenames[i]);
+        info[i].ok = true;
+        info[i].fundamental = fundamentals[j];
+        info[i].elapsedMs += batchMs / contours.size();
+    }
+    
+    return results;
+}
+
+// MODO MULTIOBJETO
+
+/**
+ * Como findLargestContour pero conserva todos los contornos externos con
+ * área >= minArea (hojas escaneadas o fotogramas con muchas formas). Los
+ * demás se descartan sin copiar: `contours` se compacta en su sitio.
+ */
+void findContoursAbove(Mat& binary, double minArea, vector<vector<Point>>& contours,
+                       vector<double>* areas) {
+    findContours(binary, contours, RETR_EXTERNAL, CHAIN_APPROX_NONE);
+    if (areas) areas->clear();
+    
+    size_t kept = 0;
+    for (size_t i = 0; i < contours.size(); i++) {
+        double area = contourArea(contours[i]);
+        if (area < minArea) continue;
+        if (kept != i) contours[kept].swap(contours[i]);
+        if (areas) areas->push_back(area);
+        kept++;
+    }
+    contours.resize(kept);
+    
+    SHAPE_LOGD("Contornos con área >= %.0f px²: %zu", minArea, kept);
+}
+
+/**
+ * Pasos 1-6 para todos los objetos:
+ * - PASO 1 una vez por imagen (con los búferes del contexto del hilo)
+ * - PASOS 2-6 por grupos de contornos: cada grupo remuestrea sus contornos
+ *   y llama a computeDescriptorBatch, en el hilo que lo ejecuta; los grupos
+ *   escriben en objetos distintos, sin cerrojos
+ *
+ * Con pool, los grupos tienen ceil(n / hilos) contornos redondeado a
+ * SPECTRUM_BATCH (como mucho OBJECT_CHUNK), para que unas pocas decenas de
+ * formas también se repartan. El hilo que llama toma grupos igual que los
+ * del pool y sólo espera a los de esta llamada (no pool->wait(), que
+ * esperaría a todo el pool y se bloquearía desde uno de sus hilos).
+ */
+vector<ShapeObject> extractShapeObjects(const Mat& image, double minArea, ThreadPool* pool) {
+    ExtractionContext& context = threadContext();
+    
+    // PASO 1: Binarizar y quedarse con los contornos suficientemente grandes
+    binarizeImage(image, context.binary, context.gray);
+    vector<vector<Point>> contours;
+    vector<double> areas;
+    findContoursAbove(context.binary, minArea, contours, &areas);
+    
+    vector<ShapeObject> objects(contours.size());
+    for (size_t i = 0; i < contours.size(); i++) {
+        objects[i].box = boundingRect(contours[i]);
+        objects[i].area = areas[i];
+    }
+    
+    size_t chunkSize = OBJECT_CHUNK;
+    if (pool != nullptr) {
+        size_t perThread = (contours.size() + pool->size() - 1) / pool->size();
+        perThread = (perThread + SPECTRUM_BATCH - 1) / SPECTRUM_BATCH * SPECTRUM_BATCH;
+        if (perThread > 0 && perThread < chunkSize) chunkSize = perThread;
+    }
+    const size_t chunks = (contours.size() + chunkSize - 1) / chunkSize;
+    
+    // PASOS 2-6 de los contornos [first, first + chunkSize)
+    auto processChunk = [&contours, &objects, chunkSize](size_t first) {
+        size_t last = min(first + chunkSize, contours.size());
+        vector<vector<Point2f>> resampled(last - first);
+        vector<float> cumulativeLength;
+        for (size_t i = first; i < last; i++) {
+            resampleContour(contours[i], NUM_POINTS, resampled[i - first], cumulativeLength);
+        }
+        
+        // Fila a cero (contorno no válido o |F[1]| < 1e-5) → features vacío
+        vector<float> fundamentals;
+        Mat descriptors = computeDescriptorBatch(resampled, &fundamentals);
+        for (size_t i = first; i < last; i++) {
+            if (resampled[i - first].empty() || fundamentals[i - first] < 1e-5) continue;
+            const float* row = descriptors.ptr<float>(static_cast<int>(i - first));
+            objects[i].features.assign(row, row + NUM_HARMONICS);
+        }
+    };
+    
+    if (pool == nullptr || chunks <= 1) {
+        for (size_t c = 0; c < chunks; c++) {
+            processChunk(c * chunkSize);
+        }
+    } else {
+        // Estado compartido con las tareas: una tarea que arranca cuando ya no
+        // quedan grupos (la llamada pudo terminar) sólo toca este estado
+        struct ChunkLatch {
+            atomic<size_t> next{0};
+            size_t done = 0;                // protegido por doneMutex
+            mutex doneMutex;
+            condition_variable doneCv;
+            exception_ptr firstError;
+        };
+        auto latch = make_shared<ChunkLatch>();
+        
+        auto runChunks = [latch, chunks, chunkSize, &processChunk] {
+            for (size_t c; (c = latch->next.fetch_add(1)) < chunks; ) {
+                exception_ptr error;
+                try {
+                    processChunk(c * chunkSize);
+                } catch (...) {
+                    error = current_exception();
+                }
+                lock_guard<mutex> lock(latch->doneMutex);
+                if (error && !latch->firstError) latch->firstError = error;
+                if (++latch->done == chunks) latch->doneCv.notify_all();
+            }
+        };
+        
+        size_t helpers = (chunks - 1 < pool->size()) ? chunks - 1 : pool->size();
+        for (size_t h = 0; h < helpers; h++) {
+            pool->submit(runChunks);
+        }
+        runChunks();
+        
+        unique_lock<mutex> lock(latch->doneMutex);
+        latch->doneCv.wait(lock, [&latch, chunks] { return latch->done == chunks; });
+        if (latch->firstError) rethrow_exception(latch->firstError);
+    }
+    
+    SHAPE_LOGD("Objetos extraídos: %zu", objects.size());
+    
+    return objects;
+}
+
+// DESCRIPTORES DISPONIBLES
+
+const char* descriptorKindName(DescriptorKind kind) {
+    switch (kind) {
+        case DescriptorKind::Hu: return "hu";
+        case DescriptorKind::Zernike: return "zernike";
+        default: return "fft";
+    }
+}
+
+bool parseDescriptorKind(const string& name, DescriptorKind& kind) {
+    for (DescriptorKind candidate : {DescriptorKind::Fft, DescriptorKind::Hu, DescriptorKind::Zernike}) {
+        if (name == descriptorKindName(candidate)) {
+            kind = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+int descriptorSize(DescriptorKind kind) {
+    switch (kind) {
+        case DescriptorKind::Hu: return NUM_HU_MOMENTS;
+        case DescriptorKind::Zernike: return NUM_ZERNIKE_MOMENTS;
+        default: return NUM_HARMONICS;
+    }
+}
+
+ShapeDescriptor extractDescriptor(DescriptorKind kind, const Mat& image, const string& label,
+                                  const string& filename, ExtractionSummary* summary) {
+    if (kind == DescriptorKind::Fft) {
+        return extractShapeDescriptor(image, label, filename, summary);
+    }
+    
+    ExtractionContext& context = threadContext();
+    bool ok = (kind == DescriptorKind::Hu) ? extractHuFeatures(image, context, summary)
+                                           : extractZernikeFeatures(image, context, summary);
+    if (!ok) {
+        return ShapeDescriptor();
+    }
+    return ShapeDescriptor(context.features, label, filename);
+}
+
+vector<ShapeDescriptor> extractDescriptorBatch(DescriptorKind kind, const vector<Mat>& images,
+                                               const vector<string>& labels,
+                                               const vector<string>& filenames,
+                                               ExtractionSummary* summaries) {
+    if (kind == DescriptorKind::Fft) {
+        return extractShapeDescriptorBatch(images, labels, filenames, summaries);
+    }
+    if (kind == DescriptorKind::Zernike) {
+        return extractZernikeDescriptorBatch(images, labels, filenames, threadContext(), summaries);
+    }
+    
+    vector<ShapeDescriptor> results(images.size());
+    for (size_t i = 0; i < images.size(); i++) {
+        results[i] = extractDescriptor(kind, images[i], labels[i], filenames[i],
+                                       summaries ? &summaries[i] : nullptr);
+    }
+    return results;
+}
+
+// PASO 7: COMPARACIÓN (DISTANCIA EUCLÍDEA)
+
+/**
+ * Calcula la distancia euclídea entre dos descriptores.
+ * tenemos en cuenta que mientras más parecidas sean las formas, MÁS PEQUEÑO el valor de la distancia
+ 
+ */
+float euclideanDistance(const vector<float>& d1, const vector<float>& d2) {
+    if (d1.size() != d2.size()) {
+        SHAPE_LOGE("Descriptores de diferente tamaño");
+        return 1e9;  
+    }
+    
+    float sum = 0.0f;
+    for (size_t i = 0; i < d1.size(); i++) {
+        float diff = d1[i] - d2[i];
+        sum += diff * diff;
+    }
+    
+    return sqrt(sum);
+}
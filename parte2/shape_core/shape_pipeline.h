@@ -0,0 +1,232 @@
+/**
+ * PRÁCTICA 3-2: Shape Signature con FFT de Coordenadas Complejas
+ *
+ * Pipeline compartido por shape_app (escritorio) y la librería JNI de Android:
+ * 1. SACAR EL CONTORNO (findContours)
+ * 2. INTERPOLACIÓN LINEAL a 1024 puntos
+ * 3. CALCULAR coordenadas complejas
+ * 4. SACAR LA TRANSFORMADA DE FOURIER (FIRMA)
+ * 5. NORMALIZAR
+ * 6. COMPARAR con distancia euclídea → menor distancia = más parecido
+ */
+
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+class ThreadPool;
+
+// CONSTANTES GLOBALES
+
+const int NUM_POINTS = 1024;        // Interpolación a 1024 puntos
+const int NUM_HARMONICS = 15;       // Número de armónicos para el descriptor
+
+// ESTRUCTURA: Descriptor de Forma
+
+struct ShapeDescriptor {
+    std::vector<float> features;
+    std::string label;
+    std::string filename;
+
+    ShapeDescriptor() {}
+    ShapeDescriptor(const std::vector<float>& f, const std::string& l, const std::string& fn = "")
+        : features(f), label(l), filename(fn) {}
+};
+
+// RESUMEN POR IMAGEN: un registro en lugar de un mensaje por etapa
+
+struct ExtractionSummary {
+    bool ok = false;
+    const char* failedStage = "";   // etapa donde falló ("" si ok)
+    size_t contourPoints = 0;       // puntos del contorno original
+    double contourArea = 0;         // área del contorno, px²
+    float fundamental = 0;          // |F[1]| antes de normalizar
+    double elapsedMs = 0;           // tiempo total de extracción
+};
+
+// CONTEXTO DE EXTRACCIÓN: búferes reutilizables entre imágenes
+
+/**
+ * Búferes intermedios del pipeline. Se reutilizan de una imagen a la
+ * siguiente y sólo crecen cuando llega una imagen o un contorno mayor:
+ * tras el calentamiento, extractShapeFeatures no reserva memoria en el
+ * código de shape_core. Las reservas internas de OpenCV (motor de filtros
+ * de adaptiveThreshold/morphologyEx, memoria de findContours) quedan fuera.
+ *
+ * Un contexto por hilo: no se puede compartir entre hilos a la vez.
+ */
+struct ExtractionContext {
+    // PASO 1
+    cv::Mat gray;
+    cv::Mat binary;
+    std::vector<std::vector<cv::Point>> contours;
+    std::vector<cv::Point> contour;         // el de mayor área
+    // PASO 2
+    std::vector<float> cumulativeLength;
+    std::vector<cv::Point2f> resampled;     // NUM_POINTS puntos
+    // PASOS 3-6
+    std::vector<float> magnitudes;          // |F[0]| .. |F[NUM_HARMONICS]|
+    std::vector<float> features;            // descriptor normalizado
+    // Zernike (zernike_descriptor.h)
+    cv::Mat roiSquare;                      // ROI centrada en su centro de masas
+    cv::Mat roiGrid;                        // la misma escalada a grid×grid
+    cv::Mat zernikeGrids;                   // lote de rejillas, N×grid² CV_32F
+};
+
+// PASO 1: Preprocesamiento y extracción del contorno más grande
+bool extractContour(const cv::Mat& image, std::vector<cv::Point>& contour);
+
+// PASO 1a: Gris + umbral adaptativo + morfología (forma en blanco)
+void binarizeImage(const cv::Mat& image, cv::Mat& binary);
+
+// PASO 1a sin reservas: `gray` se reutiliza entre llamadas
+void binarizeImage(const cv::Mat& image, cv::Mat& binary, cv::Mat& gray);
+
+// PASO 1b: Contorno externo de mayor área (puede modificar `binary`)
+bool findLargestContour(cv::Mat& binary, std::vector<cv::Point>& contour,
+                        double* area = nullptr);
+
+// PASO 1b sin reservas: `contours` (todos los contornos) se reutiliza entre llamadas
+bool findLargestContour(cv::Mat& binary, std::vector<cv::Point>& contour, double* area,
+                        std::vector<std::vector<cv::Point>>& contours);
+
+// PASO 2: Interpolación lineal a NUM_POINTS puntos
+std::vector<cv::Point2f> interpolateContour(const std::vector<cv::Point>& contour);
+
+// PASO 3: Centroide del contorno
+cv::Point2f calculateCentroid(const std::vector<cv::Point2f>& contour);
+
+// PASO 4: Señal compleja z(n) = (x - xc) + j(y - yc)
+cv::Mat buildComplexSignal(const std::vector<cv::Point2f>& contour, const cv::Point2f& centroid);
+
+// PASO 5: Magnitudes de la DFT completa con cv::dft (referencia)
+void computeFFT(const cv::Mat& complexSignal, std::vector<float>& magnitudes);
+
+// PASO 5: Sólo |X[0]| .. |X[bins-1]| con el motor de espectro (spectrum.h)
+void computeHarmonics(const cv::Mat& complexSignal, std::vector<float>& magnitudes,
+                      int bins = NUM_HARMONICS + 1);
+
+// PASO 6: Normalización por |F[1]|
+std::vector<float> normalizeDescriptor(const std::vector<float>& magnitudes);
+
+// PASO 6 sin reservas: escribe NUM_HARMONICS valores en `descriptor`
+void normalizeDescriptor(const std::vector<float>& magnitudes, std::vector<float>& descriptor);
+
+// Pasos 3-6 de un contorno remuestreado, sin Mat intermedios
+void computeDescriptor(const std::vector<cv::Point2f>& resampled,
+                       std::vector<float>& magnitudes, std::vector<float>& descriptor);
+
+// Pasos 1-2: contorno remuestreado a NUM_POINTS en context.resampled;
+// rellena contourPoints, contourArea y failedStage de `summary` (si no es nulo)
+bool extractResampledContour(const cv::Mat& image, ExtractionContext& context,
+                             ExtractionSummary* summary = nullptr);
+
+/**
+ * Pasos 3-6 de muchos contornos a la vez: matriz N×NUM_HARMONICS (CV_32F),
+ * fila i = descriptor de contours[i]. Agrupa los contornos de SPECTRUM_BATCH
+ * en SPECTRUM_BATCH (un carril SIMD por contorno, batchSpectrumMagnitudes).
+ * Fila a cero si el contorno no tiene NUM_POINTS puntos o |F[1]| < 1e-5
+ * (igual que normalizeDescriptor). `fundamentals` recibe |F[1]| de cada uno.
+ */
+cv::Mat computeDescriptorBatch(const std::vector<std::vector<cv::Point2f>>& contours,
+                               std::vector<float>* fundamentals = nullptr);
+
+// Pipeline completo (pasos 1-6) con los búferes de `context`; descriptor en context.features
+bool extractShapeFeatures(const cv::Mat& image, ExtractionContext& context,
+                          ExtractionSummary* summary = nullptr);
+
+// Pasos 2-6 desde un contorno ya en puntos (p. ej. strokesToContour), sin paso 1
+bool extractContourFeatures(const std::vector<cv::Point>& contour, ExtractionContext& context,
+                            ExtractionSummary* summary = nullptr);
+
+// Pasos 2-6 con el contexto del hilo; features vacío si falla
+ShapeDescriptor extractContourDescriptor(const std::vector<cv::Point>& contour,
+                                         const std::string& label = "",
+                                         ExtractionSummary* summary = nullptr);
+
+// Pipeline completo (pasos 1-6) con un contexto por hilo; features vacío si falla
+ShapeDescriptor extractShapeDescriptor(const cv::Mat& image,
+                                       const std::string& label = "",
+                                       const std::string& filename = "",
+                                       ExtractionSummary* summary = nullptr);
+
+/**
+ * Pipeline completo para un lote de imágenes: pasos 1-2 por imagen y
+ * pasos 3-6 en una sola llamada a computeDescriptorBatch. Mismo resultado
+ * que extractShapeDescriptor imagen a imagen; `summaries` (opcional) tiene
+ * images.size() elementos.
+ */
+std::vector<ShapeDescriptor> extractShapeDescriptorBatch(const std::vector<cv::Mat>& images,
+                                                         const std::vector<std::string>& labels,
+                                                         const std::vector<std::string>& filenames,
+                                                         ExtractionSummary* summaries = nullptr);
+
+// MODO MULTIOBJETO: todos los contornos de una imagen
+
+const double MIN_OBJECT_AREA = 100;     // área mínima por objeto, px² (como findLargestContour)
+
+struct ShapeObject {
+    cv::Rect box;                       // caja envolvente del contorno
+    double area = 0;                    // px²
+    std::vector<float> features;        // descriptor normalizado (vacío si |F[1]| ≈ 0)
+};
+
+// PASO 1b multiobjeto: contornos externos con área >= minArea (puede modificar `binary`)
+void findContoursAbove(cv::Mat& binary, double minArea,
+                       std::vector<std::vector<cv::Point>>& contours,
+                       std::vector<double>* areas = nullptr);
+
+/**
+ * Pipeline completo para cada objeto de la imagen: binarización y
+ * findContours una sola vez y, para los contornos con área >= minArea,
+ * remuestreo + pasos 3-6 en grupos de hasta OBJECT_CHUNK contornos
+ * (computeDescriptorBatch). Con `pool` los grupos se reparten entre sus
+ * hilos y el que llama; la llamada sólo espera a sus propios grupos, así
+ * que se puede hacer desde un hilo del mismo pool. Objetos en el orden de
+ * findContours.
+ */
+const int OBJECT_CHUNK = 32;
+
+std::vector<ShapeObject> extractShapeObjects(const cv::Mat& image,
+                                             double minArea = MIN_OBJECT_AREA,
+                                             ThreadPool* pool = nullptr);
+
+// DESCRIPTORES DISPONIBLES (shape_app --descriptor)
+
+enum class DescriptorKind {
+    Fft,        // firma FFT del contorno (NUM_HARMONICS valores)
+    Hu,         // momentos de Hu de la imagen binaria (hu_descriptor.h)
+    Zernike     // momentos de Zernike de la ROI (zernike_descriptor.h)
+};
+
+const char* descriptorKindName(DescriptorKind kind);
+
+// Devuelve false si `name` no es "fft", "hu" ni "zernike"
+bool parseDescriptorKind(const std::string& name, DescriptorKind& kind);
+
+// Valores por descriptor (dimensión del corpus)
+int descriptorSize(DescriptorKind kind);
+
+// Pipeline completo del descriptor elegido con el contexto del hilo; features vacío si falla
+ShapeDescriptor extractDescriptor(DescriptorKind kind, const cv::Mat& image,
+                                  const std::string& label = "",
+                                  const std::string& filename = "",
+                                  ExtractionSummary* summary = nullptr);
+
+/**
+ * Lote de imágenes con el descriptor elegido y el contexto del hilo: FFT
+ * con extractShapeDescriptorBatch, Zernike con un solo producto de
+ * matrices (extractZernikeDescriptorBatch), Hu imagen a imagen.
+ */
+std::vector<ShapeDescriptor> extractDescriptorBatch(DescriptorKind kind,
+                                                    const std::vector<cv::Mat>& images,
+                                                    const std::vector<std::string>& labels,
+                                                    const std::vector<std::string>& filenames,
+                                                    ExtractionSummary* summaries = nullptr);
+
+// PASO 7: Comparación por distancia euclídea
+float euclideanDistance(const std::vector<float>& d1, const std::vector<float>& d2);
+
@@ -0,0 +1,405 @@
+#include "spectrum.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+using namespace std;
+
+namespace {
+
+const int N = SPECTRUM_POINTS;
+const int COLUMNS = 64;             // n = j + COLUMNS·m: 64 carriles j
+const int ROWS = N / COLUMNS;       // ... por 16 filas m
+
+static_assert(N == 1024, "fft1024 y las tablas asumen N = 4^5 = 1024");
+
+// TABLAS EN COMPILACIÓN
+
+constexpr double PI = 3.14159265358979323846;
+
+// Series de Taylor en double para |x| <= π/4 (error < 1e-16)
+constexpr double taylorCos(double x) {
+    double term = 1.0, sum = 1.0;
+    for (int i = 1; i < 12; i++) {
+        term *= -x * x / ((2 * i - 1) * (2 * i));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double taylorSin(double x) {
+    double term = x, sum = x;
+    for (int i = 1; i < 12; i++) {
+        term *= -x * x / ((2 * i) * (2 * i + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+/**
+ * cos(2π·n/N) por simetría: cuadrante (n / (N/4)) y ángulo reducido a
+ * [0, π/4], donde la serie converge en pocos términos.
+ */
+constexpr double cosTurn(int n) {
+    const int quarter = N / 4;
+    n = ((n % N) + N) % N;
+    int quadrant = n / quarter;
+    int r = n % quarter;
+    // cos y sin de φ = 2π·r/N, φ ∈ [0, π/2)
+    double c = r <= quarter / 2 ? taylorCos(2 * PI * r / N) : taylorSin(2 * PI * (quarter - r) / N);
+    double s = r <= quarter / 2 ? taylorSin(2 * PI * r / N) : taylorCos(2 * PI * (quarter - r) / N);
+    switch (quadrant) {
+        case 0:  return c;
+        case 1:  return -s;
+        case 2:  return -c;
+        default: return s;
+    }
+}
+
+constexpr double sinTurn(int n) {
+    return cosTurn(n - N / 4);
+}
+
+// W^n = e^{-2πi·n/N} = cos(2πn/N) − i·sin(2πn/N)
+struct TwiddleTable {
+    float re[N];
+    float im[N];
+};
+
+constexpr TwiddleTable makeTwiddles() {
+    TwiddleTable table{};
+    for (int n = 0; n < N; n++) {
+        table.re[n] = static_cast<float>(cosTurn(n));
+        table.im[n] = static_cast<float>(-sinTurn(n));
+    }
+    return table;
+}
+
+/**
+ * Twiddles de las etapas radix-4 en el orden en que se usan: para la etapa
+ * de cuarto q, W^{p·j·N/(4q)} con p = 1..3 y j = 0..q-1 contiguos (la
+ * mariposa carga 8 j seguidos en vez de recorrer la tabla a saltos). Las
+ * etapas q = 4, 16, 64, 256 empiezan en (q − 4) / 3: 340 entradas.
+ */
+const int STAGE_TWIDDLES = 340;
+
+constexpr int stageOffset(int quarter) {
+    return (quarter - 4) / 3;
+}
+
+struct StageTwiddleTable {
+    float re[3][STAGE_TWIDDLES];
+    float im[3][STAGE_TWIDDLES];
+};
+
+constexpr StageTwiddleTable makeStageTwiddles() {
+    StageTwiddleTable table{};
+    for (int quarter = 4; quarter < N; quarter *= 4) {
+        for (int j = 0; j < quarter; j++) {
+            for (int p = 1; p <= 3; p++) {
+                int n = p * j * (N / (4 * quarter));
+                table.re[p - 1][stageOffset(quarter) + j] = static_cast<float>(cosTurn(n));
+                table.im[p - 1][stageOffset(quarter) + j] = static_cast<float>(-sinTurn(n));
+            }
+        }
+    }
+    return table;
+}
+
+// W^{j·k} para j < COLUMNS y k < ROWS: segundo paso del espectro parcial
+struct ColumnTwiddleTable {
+    float re[ROWS][COLUMNS];
+    float im[ROWS][COLUMNS];
+};
+
+constexpr ColumnTwiddleTable makeColumnTwiddles() {
+    ColumnTwiddleTable table{};
+    for (int k = 0; k < ROWS; k++) {
+        for (int j = 0; j < COLUMNS; j++) {
+            table.re[k][j] = static_cast<float>(cosTurn(j * k));
+            table.im[k][j] = static_cast<float>(-sinTurn(j * k));
+        }
+    }
+    return table;
+}
+
+// Inversión de los `digits` dígitos en base 4 de n
+constexpr int reverseDigits(int n, int digits) {
+    int reversed = 0;
+    for (int digit = 0; digit < digits; digit++) {
+        reversed = reversed * 4 + (n & 3);
+        n >>= 2;
+    }
+    return reversed;
+}
+
+struct DigitReverseTable {
+    uint16_t index[N];
+};
+
+constexpr DigitReverseTable makeDigitReverse() {
+    DigitReverseTable table{};
+    for (int n = 0; n < N; n++) {
+        table.index[n] = static_cast<uint16_t>(reverseDigits(n, 5));
+    }
+    return table;
+}
+
+constexpr TwiddleTable TWIDDLES = makeTwiddles();
+constexpr StageTwiddleTable STAGE = makeStageTwiddles();
+constexpr ColumnTwiddleTable COLUMN = makeColumnTwiddles();
+constexpr DigitReverseTable DIGIT_REVERSE = makeDigitReverse();
+
+// MARIPOSAS RADIX-4
+
+/**
+ * Mariposa radix-4 (decimación en el tiempo, signo −) de los cuatro
+ * operandos ya girados: y_m = Σ_p a_p · (−i)^{p·m}.
+ */
+inline void butterfly4(float& r0, float& i0, float& r1, float& i1,
+                       float& r2, float& i2, float& r3, float& i3) {
+    float s02r = r0 + r2, s02i = i0 + i2;
+    float d02r = r0 - r2, d02i = i0 - i2;
+    float s13r = r1 + r3, s13i = i1 + i3;
+    float d13r = r1 - r3, d13i = i1 - i3;
+
+    r0 = s02r + s13r;  i0 = s02i + s13i;
+    r1 = d02r + d13i;  i1 = d02i - d13r;     // d02 − i·d13
+    r2 = s02r - s13r;  i2 = s02i - s13i;
+    r3 = d02r - d13i;  i3 = d02i + d13r;     // d02 + i·d13
+}
+
+inline void rotate(float& r, float& i, float wr, float wi) {
+    float t = r * wr - i * wi;
+    i = r * wi + i * wr;
+    r = t;
+}
+
+/**
+ * COUNT mariposas contiguas sobre las cuatro cuartas partes r0..r3 / i0..i3
+ * con twiddles w*[j · W_STEP] (W_STEP = 0: un twiddle común; W_STEP < 0: sin
+ * twiddles, primera etapa). Los punteros son __restrict y COUNT es
+ * constante: el bucle se vectoriza también con -O2.
+ */
+template <int COUNT, int W_STEP>
+void butterflies(float* __restrict r0, float* __restrict i0, float* __restrict r1, float* __restrict i1,
+                 float* __restrict r2, float* __restrict i2, float* __restrict r3, float* __restrict i3,
+                 const float* w1r, const float* w1i, const float* w2r, const float* w2i,
+                 const float* w3r, const float* w3i) {
+    for (int j = 0; j < COUNT; j++) {
+        float a0r = r0[j], a0i = i0[j];
+        float a1r = r1[j], a1i = i1[j];
+        float a2r = r2[j], a2i = i2[j];
+        float a3r = r3[j], a3i = i3[j];
+        if (W_STEP >= 0) {
+            rotate(a1r, a1i, w1r[j * W_STEP], w1i[j * W_STEP]);
+            rotate(a2r, a2i, w2r[j * W_STEP], w2i[j * W_STEP]);
+            rotate(a3r, a3i, w3r[j * W_STEP], w3i[j * W_STEP]);
+        }
+        butterfly4(a0r, a0i, a1r, a1i, a2r, a2i, a3r, a3i);
+        r0[j] = a0r;  i0[j] = a0i;
+        r1[j] = a1r;  i1[j] = a1i;
+        r2[j] = a2r;  i2[j] = a2i;
+        r3[j] = a3r;  i3[j] = a3i;
+    }
+}
+
+/**
+ * Etapa de la FFT completa con cuarto q: en cada grupo de 4q muestras, la
+ * posición j de cada cuarta parte se gira con su twiddle (tabla STAGE,
+ * contigua en j) y pasa por la mariposa.
+ */
+template <int QUARTER>
+void radix4Stage(float* re, float* im) {
+    const int offset = stageOffset(QUARTER);
+    for (int group = 0; group < N; group += 4 * QUARTER) {
+        float* r = re + group;
+        float* i = im + group;
+        butterflies<QUARTER, 1>(r, i, r + QUARTER, i + QUARTER,
+                             r + 2 * QUARTER, i + 2 * QUARTER, r + 3 * QUARTER, i + 3 * QUARTER,
+                             STAGE.re[0] + offset, STAGE.im[0] + offset,
+                             STAGE.re[1] + offset, STAGE.im[1] + offset,
+                             STAGE.re[2] + offset, STAGE.im[2] + offset);
+    }
+}
+
+/**
+ * Mariposa sobre cuatro filas de COLUMNS carriles con un twiddle común por
+ * fila (las 64 DFT de 16 puntos del espectro parcial avanzan a la vez).
+ */
+void rowButterfly(float (*re)[COLUMNS], float (*im)[COLUMNS], int row, int step, int twiddle) {
+    butterflies<COLUMNS, 0>(re[row], im[row], re[row + step], im[row + step],
+                            re[row + 2 * step], im[row + 2 * step], re[row + 3 * step], im[row + 3 * step],
+                            &TWIDDLES.re[twiddle], &TWIDDLES.im[twiddle],
+                            &TWIDDLES.re[2 * twiddle], &TWIDDLES.im[2 * twiddle],
+                            &TWIDDLES.re[3 * twiddle], &TWIDDLES.im[3 * twiddle]);
+}
+
+}  // namespace
+
+/**
+ * Con n = j + 64·m (j < 64, m < 16):
+ *   X[k] = Σ_j W^{j·k} · Y_j[k mod 16],  Y_j[r] = Σ_m z[j + 64·m] · W_16^{r·m}
+ * PASO 1: las 64 DFT de 16 puntos Y_j (2 etapas radix-4, cada fila de la
+ * tabla son los 64 carriles j), coste fijo ~1/5 de la suma directa.
+ * PASO 2: por cada coeficiente pedido, un producto escalar de 64 términos.
+ */
+void partialSpectrumMagnitudes(const float* re, const float* im, int bins, float* magnitudes) {
+    bins = min(bins, N);
+    alignas(32) float yr[ROWS][COLUMNS];
+    alignas(32) float yi[ROWS][COLUMNS];
+
+    // PASO 1: filas en orden de dígitos invertidos + 2 etapas radix-4
+    for (int row = 0; row < ROWS; row++) {
+        int m = reverseDigits(row, 2);
+        copy(re + m * COLUMNS, re + (m + 1) * COLUMNS, yr[row]);
+        copy(im + m * COLUMNS, im + (m + 1) * COLUMNS, yi[row]);
+    }
+    for (int row = 0; row < ROWS; row += 4) {
+        butterflies<COLUMNS, -1>(yr[row], yi[row], yr[row + 1], yi[row + 1],
+                                 yr[row + 2], yi[row + 2], yr[row + 3], yi[row + 3],
+                                 nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+    }
+    for (int row = 0; row < 4; row++) {
+        rowButterfly(yr, yi, row, 4, row * (N / ROWS));     // W_16^{p·row}
+    }
+
+    // PASO 2: X[k] = Σ_j W^{j·k} · Y_j[k mod 16]
+    alignas(32) float wr[COLUMNS];
+    alignas(32) float wi[COLUMNS];
+    for (int k = 0; k < bins; k++) {
+        const float* twr = COLUMN.re[k % ROWS];
+        const float* twi = COLUMN.im[k % ROWS];
+        if (k >= ROWS) {
+            for (int j = 0; j < COLUMNS; j++) {
+                wr[j] = TWIDDLES.re[(j * k) & (N - 1)];
+                wi[j] = TWIDDLES.im[(j * k) & (N - 1)];
+            }
+            twr = wr;
+            twi = wi;
+        }
+
+        const float* cr = yr[k % ROWS];
+        const float* ci = yi[k % ROWS];
+        float sumRe[8] = {}, sumIm[8] = {};
+        for (int j = 0; j < COLUMNS; j += 8) {
+            for (int lane = 0; lane < 8; lane++) {
+                sumRe[lane] += cr[j + lane] * twr[j + lane] - ci[j + lane] * twi[j + lane];
+                sumIm[lane] += cr[j + lane] * twi[j + lane] + ci[j + lane] * twr[j + lane];
+            }
+        }
+        float xr = 0.0f, xi = 0.0f;
+        for (int lane = 0; lane < 8; lane++) {
+            xr += sumRe[lane];
+            xi += sumIm[lane];
+        }
+        magnitudes[k] = sqrt(xr * xr + xi * xi);
+    }
+}
+
+/**
+ * Entrada en orden de dígitos invertidos y 5 etapas radix-4. La primera
+ * etapa (grupos de 4 muestras) no tiene twiddles: se hace aparte sin
+ * multiplicaciones.
+ */
+void fft1024(const float* re, const float* im, float* outRe, float* outIm) {
+    for (int n = 0; n < N; n++) {
+        outRe[n] = re[DIGIT_REVERSE.index[n]];
+        outIm[n] = im[DIGIT_REVERSE.index[n]];
+    }
+
+    for (int g = 0; g < N; g += 4) {
+        float* r = outRe + g;
+        float* i = outIm + g;
+        butterfly4(r[0], i[0], r[1], i[1], r[2], i[2], r[3], i[3]);
+    }
+
+    radix4Stage<4>(outRe, outIm);
+    radix4Stage<16>(outRe, outIm);
+    radix4Stage<64>(outRe, outIm);
+    radix4Stage<256>(outRe, outIm);
+}
+
+void spectrumMagnitudes(const float* re, const float* im, int bins, float* magnitudes) {
+    bins = min(bins, N);
+    if (bins <= PARTIAL_SPECTRUM_MAX_BINS) {
+        partialSpectrumMagnitudes(re, im, bins, magnitudes);
+        return;
+    }
+
+    float outRe[N], outIm[N];
+    fft1024(re, im, outRe, outIm);
+    for (int k = 0; k < bins; k++) {
+        magnitudes[k] = sqrt(outRe[k] * outRe[k] + outIm[k] * outIm[k]);
+    }
+}
+
+/**
+ * Mismo esquema que partialSpectrumMagnitudes con n = j + 64·m, pero cada
+ * muestra es un vector de SPECTRUM_BATCH señales. Con la entrada
+ * intercalada, la fila m (muestras j = 0..63 de las 8 señales) son 512
+ * floats contiguos:
+ * PASO 1: las DFT de 16 puntos Y_j de todas las (j, señal) a la vez, con
+ * mariposas de 512 carriles sobre las filas.
+ * PASO 2: por coeficiente, X_c[k] = Σ_j W^{j·k} · Y_j[k mod 16] con el
+ * twiddle en broadcast y un acumulador por señal (carril).
+ * Todo el trabajo es vertical: ni reducciones horizontales ni twiddles por
+ * carril.
+ */
+void batchSpectrumMagnitudes(const float* re, const float* im, int bins, float* magnitudes) {
+    const int B = SPECTRUM_BATCH;
+    const int WIDTH = COLUMNS * B;
+    bins = min(bins, BATCH_SPECTRUM_MAX_BINS);
+
+    // 2 × 32 KB (L2): cada fila se escribe y se lee una vez
+    alignas(32) float yr[ROWS][WIDTH];
+    alignas(32) float yi[ROWS][WIDTH];
+
+    // PASO 1: filas en orden de dígitos invertidos + 2 etapas radix-4
+    for (int row = 0; row < ROWS; row++) {
+        int m = reverseDigits(row, 2);
+        copy(re + m * WIDTH, re + (m + 1) * WIDTH, yr[row]);
+        copy(im + m * WIDTH, im + (m + 1) * WIDTH, yi[row]);
+    }
+    for (int row = 0; row < ROWS; row += 4) {
+        butterflies<WIDTH, -1>(yr[row], yi[row], yr[row + 1], yi[row + 1],
+                               yr[row + 2], yi[row + 2], yr[row + 3], yi[row + 3],
+                               nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+    }
+    for (int row = 0; row < 4; row++) {
+        int twiddle = row * (N / ROWS);     // W_16^{p·row}
+        butterflies<WIDTH, 0>(yr[row], yi[row], yr[row + 4], yi[row + 4],
+                              yr[row + 8], yi[row + 8], yr[row + 12], yi[row + 12],
+                              &TWIDDLES.re[twiddle], &TWIDDLES.im[twiddle],
+                              &TWIDDLES.re[2 * twiddle], &TWIDDLES.im[2 * twiddle],
+                              &TWIDDLES.re[3 * twiddle], &TWIDDLES.im[3 * twiddle]);
+    }
+
+    // PASO 2: X_c[k] = Σ_j W^{j·k} · Y_j[k mod 16], dos coeficientes por
+    // pasada: cuatro cadenas de FMA independientes por carril
+    for (int k0 = 0; k0 < bins; k0 += 2) {
+        int k1 = min(k0 + 1, bins - 1);
+        const float* ar = yr[k0 % ROWS];
+        const float* ai = yi[k0 % ROWS];
+        const float* br = yr[k1 % ROWS];
+        const float* bi = yi[k1 % ROWS];
+        float aRe[B] = {}, aIm[B] = {}, bRe[B] = {}, bIm[B] = {};
+        for (int j = 0; j < COLUMNS; j++, ar += B, ai += B, br += B, bi += B) {
+            float awr = TWIDDLES.re[(j * k0) & (N - 1)];
+            float awi = TWIDDLES.im[(j * k0) & (N - 1)];
+            float bwr = TWIDDLES.re[(j * k1) & (N - 1)];
+            float bwi = TWIDDLES.im[(j * k1) & (N - 1)];
+            for (int c = 0; c < B; c++) {
+                aRe[c] += ar[c] * awr - ai[c] * awi;
+                aIm[c] += ar[c] * awi + ai[c] * awr;
+                bRe[c] += br[c] * bwr - bi[c] * bwi;
+                bIm[c] += br[c] * bwi + bi[c] * bwr;
+            }
+        }
+        for (int c = 0; c < B; c++) {
+            magnitudes[c * bins + k0] = sqrt(aRe[c] * aRe[c] + aIm[c] * aIm[c]);
+            magnitudes[c * bins + k1] = sqrt(bRe[c] * bRe[c] + bIm[c] * bIm[c]);
+        }
+    }
+}
@@ -0,0 +1,48 @@
+/**
+ * Motor de espectro para la firma FFT de la forma.
+ *
+ * El descriptor sólo usa |X[0]| .. |X[NUM_HARMONICS]| de una señal de
+ * SPECTRUM_POINTS muestras, así que no hace falta la DFT completa:
+ *
+ * - partialSpectrumMagnitudes: evalúa sólo los primeros `bins` coeficientes:
+ *   64 DFT de 16 puntos en paralelo (una por carril SIMD) y un producto
+ *   escalar de 64 términos por coeficiente, con tablas de twiddles
+ *   calculadas en compilación (constexpr).
+ * - fft1024: FFT radix-4 completa de 1024 puntos (5 etapas, estructura de
+ *   arrays re/im) para cuando se piden muchos coeficientes.
+ * - spectrumMagnitudes: elige entre las dos según `bins`.
+ * - batchSpectrumMagnitudes: el espectro parcial de SPECTRUM_BATCH señales
+ *   a la vez, con las muestras intercaladas para que cada carril SIMD sea
+ *   una señal distinta (sin reducciones horizontales ni twiddles por carril).
+ *
+ * Convención de signo igual que cv::dft (directa):
+ *   X[k] = Σ_n z[n] · e^{-2πi·k·n/N},  z[n] = re[n] + i·im[n]
+ * (con e^{+i} |X[k]| pasaría a ser |X[N−k]| y cambiaría el descriptor).
+ */
+
+#pragma once
+
+const int SPECTRUM_POINTS = 1024;       // muestras de la señal (= NUM_POINTS)
+
+// Hasta este número de coeficientes el espectro parcial gana a la FFT completa
+const int PARTIAL_SPECTRUM_MAX_BINS = 32;
+
+// |X[k]| para k = 0..bins-1 (bins <= SPECTRUM_POINTS) sin la FFT completa
+void partialSpectrumMagnitudes(const float* re, const float* im, int bins, float* magnitudes);
+
+// X[k] para k = 0..SPECTRUM_POINTS-1; la salida no puede solaparse con la entrada
+void fft1024(const float* re, const float* im, float* outRe, float* outIm);
+
+// |X[k]| para k = 0..bins-1 con el camino más rápido para ese número de coeficientes
+void spectrumMagnitudes(const float* re, const float* im, int bins, float* magnitudes);
+
+// Señales por lote de batchSpectrumMagnitudes (un carril SIMD de 8 floats por señal)
+const int SPECTRUM_BATCH = 8;
+const int BATCH_SPECTRUM_MAX_BINS = 64;
+
+/**
+ * |X_c[k]| de SPECTRUM_BATCH señales, k = 0..bins-1 (bins <= BATCH_SPECTRUM_MAX_BINS).
+ * Entrada intercalada: re[n·SPECTRUM_BATCH + c] es la muestra n de la señal c.
+ * Salida por señal: magnitudes[c·bins + k].
+ */
+void batchSpectrumMagnitudes(const float* re, const float* im, int bins, float* magnitudes);
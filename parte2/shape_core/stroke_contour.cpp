@@ -0,0 +1,125 @@
+#include "stroke_contour.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "shape_log.h"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+const double MIN_AREA = 100;    // px², como findLargestContour
+
+struct Stroke {
+    int first;      // índice del primer punto en xy
+    int count;      // número de puntos
+};
+
+inline Point2f strokePoint(const float* xy, int index) {
+    return Point2f(xy[2 * index], xy[2 * index + 1]);
+}
+
+inline float squaredDistance(const Point2f& a, const Point2f& b) {
+    Point2f d = a - b;
+    return d.x * d.x + d.y * d.y;
+}
+
+// Área con signo (fórmula del lazo, como contourArea con oriented = true)
+double signedArea(const vector<Point2f>& contour) {
+    double sum = 0;
+    for (size_t i = 0, j = contour.size() - 1; i < contour.size(); j = i++) {
+        sum += static_cast<double>(contour[j].x) * contour[i].y -
+               static_cast<double>(contour[i].x) * contour[j].y;
+    }
+    return sum / 2;
+}
+
+// Cadena 8-conexa de a a b (sin b): un píxel por paso en el eje mayor
+void appendChain(const Point& a, const Point& b, vector<Point>& chain) {
+    int steps = max(abs(b.x - a.x), abs(b.y - a.y));
+    for (int k = 0; k < steps; k++) {
+        chain.push_back(Point(a.x + cvRound(static_cast<double>(b.x - a.x) * k / steps),
+                              a.y + cvRound(static_cast<double>(b.y - a.y) * k / steps)));
+    }
+}
+
+}  // namespace
+
+bool strokesToContour(const float* xy, int valueCount, const int* strokeLengths, int strokeCount,
+                      vector<Point>& contour, double* area) {
+    contour.clear();
+    if (area) *area = 0;
+    vector<Point2f> polyline;
+    
+    // PASO 1: trazos no vacíos, todos dentro de los valueCount floats de `xy`
+    vector<Stroke> strokes;
+    long long offset = 0;
+    for (int s = 0; s < strokeCount; s++) {
+        if (strokeLengths[s] < 0 || 2 * (offset + strokeLengths[s]) > valueCount) {
+            SHAPE_LOGE("Trazos inconsistentes: longitud %d con %d valores", strokeLengths[s], valueCount);
+            return false;
+        }
+        if (strokeLengths[s] > 0) strokes.push_back({static_cast<int>(offset), strokeLengths[s]});
+        offset += strokeLengths[s];
+    }
+    polyline.reserve(static_cast<size_t>(offset));
+    
+    // PASO 2: encadenar por el extremo más cercano al final del recorrido
+    vector<bool> used(strokes.size(), false);
+    for (size_t step = 0; step < strokes.size(); step++) {
+        size_t best = 0;
+        bool reversed = false;
+        if (step > 0) {
+            float bestDistance = -1;
+            for (size_t s = 0; s < strokes.size(); s++) {
+                if (used[s]) continue;
+                const Stroke& stroke = strokes[s];
+                float toFirst = squaredDistance(polyline.back(), strokePoint(xy, stroke.first));
+                float toLast = squaredDistance(polyline.back(),
+                                               strokePoint(xy, stroke.first + stroke.count - 1));
+                if (bestDistance < 0 || min(toFirst, toLast) < bestDistance) {
+                    bestDistance = min(toFirst, toLast);
+                    best = s;
+                    reversed = toLast < toFirst;
+                }
+            }
+        }
+        
+        used[best] = true;
+        const Stroke& stroke = strokes[best];
+        for (int i = 0; i < stroke.count; i++) {
+            int index = reversed ? stroke.first + stroke.count - 1 - i : stroke.first + i;
+            polyline.push_back(strokePoint(xy, index));
+        }
+    }
+    
+    if (polyline.size() < 3) {
+        SHAPE_LOGE("Trazo con muy pocos puntos: %zu", polyline.size());
+        return false;
+    }
+    
+    // PASO 3: mismo sentido que los contornos externos de findContours
+    // (antihorario en pantalla, con y hacia abajo: área con signo negativa)
+    double oriented = signedArea(polyline);
+    if (oriented > 0) reverse(polyline.begin(), polyline.end());
+    if (area) *area = fabs(oriented);
+    
+    if (fabs(oriented) < MIN_AREA) {
+        SHAPE_LOGE("Trazo muy pequeño (área < 100 píxeles)");
+        return false;
+    }
+    
+    // PASO 4: cadena de píxeles cerrada (el último punto enlaza con el primero)
+    for (size_t i = 0; i < polyline.size(); i++) {
+        const Point2f& next = polyline[i + 1 == polyline.size() ? 0 : i + 1];
+        appendChain(Point(cvRound(polyline[i].x), cvRound(polyline[i].y)),
+                    Point(cvRound(next.x), cvRound(next.y)), contour);
+    }
+    
+    SHAPE_LOGD("Contorno desde trazos: %zu puntos de %zu trazos, área = %.0f px²",
+               contour.size(), strokes.size(), fabs(oriented));
+    
+    return contour.size() >= 3;
+}
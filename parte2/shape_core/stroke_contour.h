@@ -0,0 +1,41 @@
+/**
+ * Contorno a partir de los trazos vectoriales del dibujo, sin rasterizar.
+ *
+ * DrawingView ya tiene los puntos táctiles de cada trazo: en lugar de
+ * pintarlos en un bitmap a pantalla completa para que el paso 1
+ * (umbral + morfología + findContours) los vuelva a convertir en puntos,
+ * se encadenan los trazos en una polilínea cerrada que sustituye al
+ * contorno del paso 1 y va directa a la interpolación y la FFT.
+ *
+ * - Los trazos se unen por el extremo más cercano (invirtiendo el trazo si
+ *   hace falta): un triángulo dibujado en tres trazos en cualquier sentido
+ *   da un único recorrido.
+ * - El último punto se une con el primero (resampleContour trata el
+ *   contorno como cerrado), así un trazo que no llega a cerrarse del todo
+ *   se cierra con un segmento recto.
+ * - Se orienta como los contornos externos de findContours (antihorario
+ *   en pantalla): el sentido del recorrido cambia |F[k]| por |F[N-k]|.
+ * - Se convierte en una cadena de píxeles 8-conexa, como la que devuelve
+ *   findContours con CHAIN_APPROX_NONE: el corpus se extrajo de contornos
+ *   de píxeles y el escalonado forma parte de lo que ve el descriptor.
+ *
+ * Se usa la línea central del trazo, no el borde exterior del trazo
+ * grueso: con un trazo de 20 px sobre formas de cientos de píxeles la
+ * diferencia en el descriptor normalizado es pequeña.
+ */
+
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <vector>
+
+/**
+ * `xy` = x0, y0, x1, y1, ... de todos los trazos seguidos (`valueCount`
+ * floats); strokeLengths[s] = puntos del trazo s. false si alguna longitud
+ * es negativa o los trazos piden más de valueCount / 2 puntos (datos de
+ * JNI sin verificar), si no hay al menos 3 puntos o si el área encerrada
+ * es < 100 px² (el mismo umbral que findLargestContour); `area` (opcional)
+ * recibe el área encerrada.
+ */
+bool strokesToContour(const float* xy, int valueCount, const int* strokeLengths, int strokeCount,
+                      std::vector<cv::Point>& contour, double* area = nullptr);
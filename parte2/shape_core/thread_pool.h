@@ -0,0 +1,164 @@
+/**
+ * Pool de hilos con robo de trabajo (work stealing).
+ *
+ * Cada hilo tiene su propia cola de tareas: consume por el extremo trasero
+ * y, cuando se queda sin trabajo, roba por el extremo delantero de las
+ * colas de los demás hilos. Así una clase con imágenes más pesadas no deja
+ * al resto de hilos ociosos.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // numThreads == 0 → un hilo por núcleo disponible
+    explicit ThreadPool(unsigned numThreads = 0) {
+        if (numThreads == 0) {
+            numThreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (unsigned i = 0; i < numThreads; i++) {
+            queues_.push_back(std::make_unique<WorkQueue>());
+        }
+        for (unsigned i = 0; i < numThreads; i++) {
+            workers_.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stopping_ = true;
+        }
+        wakeCv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(queues_.size()); }
+
+    /**
+     * Encola una tarea. Si se llama desde un hilo del propio pool la tarea
+     * va a la cola de ese hilo (localidad); si no, se reparte en round-robin.
+     */
+    void submit(Task task) {
+        unsigned target = (currentPool == this)
+            ? currentIndex
+            : nextQueue_.fetch_add(1, std::memory_order_relaxed) % size();
+
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+            queues_[target]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            queued_++;
+        }
+        wakeCv_.notify_one();
+    }
+
+    /**
+     * Bloquea hasta que terminan todas las tareas enviadas. Si alguna lanzó
+     * una excepción, se relanza aquí la primera.
+     */
+    void wait() {
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        doneCv_.wait(lock, [this] { return pending_.load() == 0; });
+
+        if (firstError_) {
+            std::exception_ptr error = firstError_;
+            firstError_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool popLocal(unsigned idx, Task& task) {
+        WorkQueue& queue = *queues_[idx];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) return false;
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(unsigned idx, Task& task) {
+        for (unsigned offset = 1; offset < size(); offset++) {
+            WorkQueue& victim = *queues_[(idx + offset) % size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.tasks.empty()) continue;
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    void workerLoop(unsigned idx) {
+        currentPool = this;
+        currentIndex = idx;
+
+        while (true) {
+            Task task;
+            if (popLocal(idx, task) || steal(idx, task)) {
+                {
+                    std::lock_guard<std::mutex> lock(sleepMutex_);
+                    queued_--;
+                }
+                try {
+                    task();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(sleepMutex_);
+                    if (!firstError_) firstError_ = std::current_exception();
+                }
+                if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    std::lock_guard<std::mutex> lock(sleepMutex_);
+                    doneCv_.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wakeCv_.wait(lock, [this] { return stopping_ || queued_ > 0; });
+            if (stopping_ && queued_ <= 0) return;
+        }
+    }
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex sleepMutex_;
+    std::condition_variable wakeCv_;
+    std::condition_variable doneCv_;
+    long queued_ = 0;                      // tareas en colas (protegido por sleepMutex_)
+    bool stopping_ = false;
+    std::exception_ptr firstError_;
+
+    std::atomic<size_t> pending_{0};       // tareas enviadas y no terminadas
+    std::atomic<unsigned> nextQueue_{0};
+
+    static inline thread_local ThreadPool* currentPool = nullptr;
+    static inline thread_local unsigned currentIndex = 0;
+};
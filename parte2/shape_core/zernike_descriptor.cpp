@@ -0,0 +1,368 @@
+#include "zernike_descriptor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "hu_descriptor.h"
+#include "shape_log.h"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+double factorial(int n) {
+    double result = 1.0;
+    for (int i = 2; i <= n; i++) result *= i;
+    return result;
+}
+
+/**
+ * Coeficientes de R_nl(ρ) = Σ_m c_m · ρ^(n-2m), m = 0..(n-l)/2:
+ * c_m = (-1)^m (n-m)! / (m! ((n+l)/2 - m)! ((n-l)/2 - m)!)
+ */
+vector<double> radialCoefficients(int n, int l) {
+    vector<double> coefficients;
+    for (int m = 0; m <= (n - l) / 2; m++) {
+        double sign = (m & 1) ? -1.0 : 1.0;
+        coefficients.push_back(sign * factorial(n - m) /
+                               (factorial(m) * factorial((n + l) / 2 - m) * factorial((n - l) / 2 - m)));
+    }
+    return coefficients;
+}
+
+double radialPolynomial(const vector<double>& coefficients, int n, double rho) {
+    double value = 0.0;
+    for (size_t m = 0; m < coefficients.size(); m++) {
+        value += coefficients[m] * pow(rho, n - 2 * static_cast<int>(m));
+    }
+    return value;
+}
+
+// Pares (n, l) en el orden de mahotas
+vector<pair<int, int>> momentOrders(int degree) {
+    vector<pair<int, int>> orders;
+    for (int n = 0; n <= degree; n++) {
+        for (int l = 0; l <= n; l++) {
+            if ((n - l) % 2 == 0) orders.emplace_back(n, l);
+        }
+    }
+    return orders;
+}
+
+/**
+ * Evalúa conj(V_nl) en el centro de cada celda de la rejilla. Coordenadas
+ * como mahotas: (índice - centro) / radio, con centro (grid-1)/2 y radio
+ * grid/2; ρ se limita a 1e-9 para definir θ en el centro.
+ */
+unique_ptr<ZernikeBasis> buildBasis(int grid, int degree) {
+    auto basis = make_unique<ZernikeBasis>();
+    basis->grid = grid;
+    basis->degree = degree;
+
+    vector<pair<int, int>> orders = momentOrders(degree);
+    vector<vector<double>> coefficients;
+    for (const auto& [n, l] : orders) {
+        coefficients.push_back(radialCoefficients(n, l));
+        basis->scale.push_back(static_cast<float>((n + 1) / CV_PI));
+    }
+    basis->count = static_cast<int>(orders.size());
+
+    const int columns = 2 * basis->count + 1;
+    basis->weights = Mat::zeros(grid * grid, columns, CV_32F);
+
+    const double centre = (grid - 1) / 2.0;
+    const double radius = grid / 2.0;
+    vector<complex<double>> powers(degree + 1);
+
+    for (int y = 0; y < grid; y++) {
+        for (int x = 0; x < grid; x++) {
+            double xn = (x - centre) / radius;
+            double yn = (y - centre) / radius;
+            double rho = max(sqrt(xn * xn + yn * yn), 1e-9);
+            if (rho > 1.0) continue;
+
+            // e^{ilθ} para l = 0..degree
+            complex<double> angle(xn / rho, yn / rho);
+            powers[0] = 1.0;
+            for (int l = 1; l <= degree; l++) powers[l] = powers[l - 1] * angle;
+
+            float* weights = basis->weights.ptr<float>(y * grid + x);
+            for (int k = 0; k < basis->count; k++) {
+                auto [n, l] = orders[k];
+                complex<double> v = conj(radialPolynomial(coefficients[k], n, rho) * powers[l]);
+                weights[2 * k] = static_cast<float>(v.real());
+                weights[2 * k + 1] = static_cast<float>(v.imag());
+            }
+            weights[columns - 1] = 1.0f;
+        }
+    }
+
+    SHAPE_LOGD("Base de Zernike %dx%d, grado %d: %d momentos", grid, grid, degree, basis->count);
+
+    return basis;
+}
+
+}  // namespace
+
+int zernikeMomentCount(int degree) {
+    return static_cast<int>(momentOrders(degree).size());
+}
+
+// CACHÉ DE BASES
+
+/**
+ * Una base por (grid, grado), creada bajo el cerrojo la primera vez que se
+ * pide. Las entradas no se borran nunca: la referencia devuelta vale toda
+ * la vida del programa y se puede usar sin cerrojo desde cualquier hilo.
+ */
+const ZernikeBasis& zernikeBasis(int grid, int degree) {
+    CV_Assert(grid > 0 && degree >= 0);
+
+    static mutex cacheMutex;
+    static map<pair<int, int>, unique_ptr<ZernikeBasis>> cache;
+
+    lock_guard<mutex> lock(cacheMutex);
+    unique_ptr<ZernikeBasis>& basis = cache[{grid, degree}];
+    if (!basis) basis = buildBasis(grid, degree);
+    return *basis;
+}
+
+// PASOS 1-2: PREPROCESADO Y ROI (como extract_zernike_moments del notebook)
+
+bool findZernikeRoi(const Mat& image, ExtractionContext& context, Rect& roi,
+                    ExtractionSummary* summary) {
+    // PASO 1: Binarizar (mismo preprocesado que Hu)
+    binarizeOtsu(image, context.binary, context.gray);
+
+    // PASO 2: Caja del contorno mayor + margen, recortada a la imagen
+    findContours(context.binary, context.contours, RETR_EXTERNAL, CHAIN_APPROX_SIMPLE);
+    if (context.contours.empty()) {
+        SHAPE_LOGE("No se encontraron contornos en la imagen");
+        if (summary) summary->failedStage = "contorno";
+        return false;
+    }
+
+    double maxArea = -1;
+    size_t maxIdx = 0;
+    for (size_t i = 0; i < context.contours.size(); i++) {
+        double area = contourArea(context.contours[i]);
+        if (area > maxArea) {
+            maxArea = area;
+            maxIdx = i;
+        }
+    }
+    if (summary) {
+        summary->contourPoints = context.contours[maxIdx].size();
+        summary->contourArea = maxArea;
+    }
+
+    Rect box = boundingRect(context.contours[maxIdx]);
+    roi = Rect(box.x - ZERNIKE_PAD, box.y - ZERNIKE_PAD,
+               box.width + 2 * ZERNIKE_PAD, box.height + 2 * ZERNIKE_PAD) &
+          Rect(0, 0, context.binary.cols, context.binary.rows);
+
+    return true;
+}
+
+// PASO 3: ROI A LA REJILLA FIJA
+
+/**
+ * Dos pasos para no perder píxeles al reducir: traslación sub-píxel a un
+ * cuadrado de lado max(ancho, alto) con el centro de masas en su centro
+ * (fuera de la ROI, 0: mahotas sólo ve la ROI) y después resize a grid×grid
+ * (INTER_AREA al reducir). resize lleva el centro (lado-1)/2 a (grid-1)/2 y
+ * el radio lado/2 a grid/2, justo lo que supone la base.
+ */
+bool normalizeZernikeRoi(const Mat& roi, int grid, ExtractionContext& context, float* row) {
+    CV_Assert(roi.type() == CV_8UC1 && grid > 0);
+
+    Moments moments = binaryMoments(roi);
+    if (moments.m00 <= 0) return false;
+
+    const int side = max(roi.cols, roi.rows);
+    const double centre = (side - 1) / 2.0;
+    Matx23d shift(1, 0, centre - moments.m10 / moments.m00,
+                  0, 1, centre - moments.m01 / moments.m00);
+    warpAffine(roi, context.roiSquare, shift, Size(side, side), INTER_LINEAR, BORDER_CONSTANT, Scalar(0));
+
+    resize(context.roiSquare, context.roiGrid, Size(grid, grid), 0, 0,
+           side > grid ? INTER_AREA : INTER_LINEAR);
+
+    Mat gridRow(grid, grid, CV_32F, row);
+    context.roiGrid.convertTo(gridRow, CV_32F);
+    return true;
+}
+
+// PASO 4: MOMENTOS DEL LOTE CON UN SOLO PRODUCTO
+
+Mat zernikeMagnitudes(const Mat& grids, const ZernikeBasis& basis) {
+    CV_Assert(grids.type() == CV_32F && grids.cols == basis.grid * basis.grid);
+
+    // (N×grid²) · (grid²×(2·count+1)): parte real, imaginaria y masa de cada imagen
+    Mat products;
+    gemm(grids, basis.weights, 1.0, noArray(), 0.0, products);
+
+    Mat magnitudes = Mat::zeros(grids.rows, basis.count, CV_32F);
+    for (int i = 0; i < grids.rows; i++) {
+        const float* sums = products.ptr<float>(i);
+        float mass = sums[2 * basis.count];
+        if (mass <= 0) continue;
+
+        float* out = magnitudes.ptr<float>(i);
+        for (int k = 0; k < basis.count; k++) {
+            out[k] = basis.scale[k] * hypot(sums[2 * k], sums[2 * k + 1]) / mass;
+        }
+    }
+    return magnitudes;
+}
+
+// REFERENCIA: ALGORITMO DE MAHOTAS
+
+/**
+ * Igual que mahotas.features.zernike_moments (en double): centro de masas
+ * de toda la ROI, coordenadas (índice - centro) / radio y, para cada píxel
+ * con valor > 0 dentro del disco, los polinomios radiales de todos los
+ * momentos evaluados en su ρ.
+ */
+void zernikeMomentsDirect(const Mat& roi, double radius, int degree, float* moments) {
+    CV_Assert(roi.type() == CV_8UC1 && radius > 0);
+
+    vector<pair<int, int>> orders = momentOrders(degree);
+    vector<vector<double>> coefficients;
+    for (const auto& [n, l] : orders) coefficients.push_back(radialCoefficients(n, l));
+
+    Moments m = binaryMoments(roi);
+    fill(moments, moments + orders.size(), 0.0f);
+    if (m.m00 <= 0) return;
+    const double cx = m.m10 / m.m00;
+    const double cy = m.m01 / m.m00;
+
+    vector<complex<double>> sums(orders.size(), 0.0);
+    vector<complex<double>> powers(degree + 1);
+    double mass = 0.0;
+
+    for (int y = 0; y < roi.rows; y++) {
+        const uint8_t* pixels = roi.ptr<uint8_t>(y);
+        for (int x = 0; x < roi.cols; x++) {
+            if (pixels[x] == 0) continue;
+            double xn = (x - cx) / radius;
+            double yn = (y - cy) / radius;
+            double rho = max(sqrt(xn * xn + yn * yn), 1e-9);
+            if (rho > 1.0) continue;
+
+            double p = pixels[x];
+            mass += p;
+            complex<double> angle(xn / rho, yn / rho);
+            powers[0] = 1.0;
+            for (int l = 1; l <= degree; l++) powers[l] = powers[l - 1] * angle;
+
+            for (size_t k = 0; k < orders.size(); k++) {
+                auto [n, l] = orders[k];
+                sums[k] += p * conj(radialPolynomial(coefficients[k], n, rho) * powers[l]);
+            }
+        }
+    }
+    if (mass <= 0) return;
+
+    for (size_t k = 0; k < orders.size(); k++) {
+        moments[k] = static_cast<float>((orders[k].first + 1) / CV_PI * abs(sums[k]) / mass);
+    }
+}
+
+// F. PRINCIPAL: DESCRIPTOR DE ZERNIKE
+
+/**
+ * Una imagen es un lote de uno (producto vector × base). En el resumen,
+ * contourArea y contourPoints son los del contorno mayor.
+ */
+bool extractZernikeFeatures(const Mat& image, ExtractionContext& context, ExtractionSummary* summary) {
+    int64 start = getTickCount();
+    ExtractionSummary localSummary;
+    ExtractionSummary& info = summary ? *summary : localSummary;
+    info = ExtractionSummary();
+    context.features.clear();
+
+    // PASOS 1-2: Binarizar + ROI
+    Rect roi;
+    if (!findZernikeRoi(image, context, roi, &info)) return false;
+
+    // PASO 3: Rejilla normalizada
+    const ZernikeBasis& basis = zernikeBasis();
+    context.zernikeGrids.create(1, basis.grid * basis.grid, CV_32F);
+    if (!normalizeZernikeRoi(context.binary(roi), basis.grid, context,
+                             context.zernikeGrids.ptr<float>(0))) {
+        SHAPE_LOGE("ROI sin forma tras la binarización");
+        info.failedStage = "momentos";
+        return false;
+    }
+
+    // PASO 4: Momentos
+    Mat magnitudes = zernikeMagnitudes(context.zernikeGrids, basis);
+    const float* row = magnitudes.ptr<float>(0);
+    context.features.assign(row, row + basis.count);
+
+    info.ok = true;
+    info.elapsedMs = 1000.0 * (getTickCount() - start) / getTickFrequency();
+
+    SHAPE_LOGD("Descriptor de Zernike extraído (ROI %dx%d)", roi.width, roi.height);
+
+    return true;
+}
+
+vector<ShapeDescriptor> extractZernikeDescriptorBatch(const vector<Mat>& images,
+                                                      const vector<string>& labels,
+                                                      const vector<string>& filenames,
+                                                      ExtractionContext& context,
+                                                      ExtractionSummary* summaries) {
+    const size_t count = images.size();
+    vector<ShapeDescriptor> results(count);
+    vector<ExtractionSummary> localSummaries(summaries ? 0 : count);
+    ExtractionSummary* info = summaries ? summaries : localSummaries.data();
+
+    const ZernikeBasis& basis = zernikeBasis();
+    context.zernikeGrids.create(static_cast<int>(count), basis.grid * basis.grid, CV_32F);
+
+    // PASOS 1-3 por imagen: una fila de la matriz del lote por imagen válida
+    vector<size_t> imageOfRow;
+    imageOfRow.reserve(count);
+
+    for (size_t i = 0; i < count; i++) {
+        int64 start = getTickCount();
+        info[i] = ExtractionSummary();
+
+        Rect roi;
+        if (findZernikeRoi(images[i], context, roi, &info[i])) {
+            int rowIndex = static_cast<int>(imageOfRow.size());
+            if (normalizeZernikeRoi(context.binary(roi), basis.grid, context,
+                                    context.zernikeGrids.ptr<float>(rowIndex))) {
+                imageOfRow.push_back(i);
+            } else {
+                info[i].failedStage = "momentos";
+            }
+        }
+        info[i].elapsedMs = 1000.0 * (getTickCount() - start) / getTickFrequency();
+    }
+    if (imageOfRow.empty()) return results;
+
+    // PASO 4 de todo el lote
+    int64 start = getTickCount();
+    Mat magnitudes = zernikeMagnitudes(context.zernikeGrids.rowRange(0, static_cast<int>(imageOfRow.size())),
+                                       basis);
+    double batchMs = 1000.0 * (getTickCount() - start) / getTickFrequency();
+
+    for (size_t j = 0; j < imageOfRow.size(); j++) {
+        size_t i = imageOfRow[j];
+        const float* row = magnitudes.ptr<float>(static_cast<int>(j));
+        results[i] = ShapeDescriptor(vector<float>(row, row + basis.count), labels[i], filenames[i]);
+        info[i].ok = true;
+        info[i].elapsedMs += batchMs / imageOfRow.size();
+    }
+
+    return results;
+}
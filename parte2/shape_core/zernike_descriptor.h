@@ -0,0 +1,96 @@
+/**
+ * Descriptor de momentos de Zernike (el de la parte 1, en C++).
+ *
+ * Mismo preprocesado y misma definición que extract_zernike_moments del
+ * notebook (mahotas.features.zernike_moments, grado 8 → 25 momentos):
+ * mediana 5×5 + Otsu invertido, ROI = caja del contorno mayor con
+ * ZERNIKE_PAD px de margen, radio = max(ancho, alto) / 2, centro = centro
+ * de masas de la ROI y
+ *
+ *     |Z_nl| = (n+1)/π · |Σ p(x,y) · conj(R_nl(ρ)·e^{ilθ})| / Σ p(x,y)
+ *
+ * sumando los píxeles con ρ <= 1.
+ *
+ * En lugar de evaluar los polinomios radiales píxel a píxel (lo que hace
+ * mahotas, zernikeMomentsDirect), cada ROI se centra en su centro de masas
+ * y se escala a una rejilla fija de grid×grid: así la base V_nl(x, y) no
+ * depende de la imagen, se calcula una vez por (grid, grado) y queda en
+ * caché (zernikeBasis), y los momentos de un lote de N imágenes son un
+ * único producto de matrices (N×grid²) · (grid²×columnas de la base).
+ */
+
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <string>
+#include <vector>
+
+#include "shape_pipeline.h"
+
+const int ZERNIKE_DEGREE = 8;           // grado máximo n (el del notebook)
+const int NUM_ZERNIKE_MOMENTS = 25;     // pares (n, l) con l <= n <= 8 y n - l par
+const int ZERNIKE_GRID = 64;            // lado de la rejilla normalizada, px
+const int ZERNIKE_PAD = 5;              // margen de la ROI alrededor del contorno, px
+
+// Momentos de un grado: pares (n, l) con 0 <= l <= n <= degree y n - l par
+int zernikeMomentCount(int degree);
+
+/**
+ * Base de Zernike sobre la rejilla, un píxel por fila: columna 2k =
+ * Re conj(V_nl), columna 2k+1 = Im conj(V_nl) del momento k (orden de
+ * mahotas: n creciente y l creciente) y última columna = máscara del disco
+ * (ρ <= 1), para normalizar por la masa en el mismo producto. Píxeles fuera
+ * del disco a 0.
+ */
+struct ZernikeBasis {
+    int grid = 0;
+    int degree = 0;
+    int count = 0;                      // momentos (zernikeMomentCount(degree))
+    cv::Mat weights;                    // grid² × (2·count + 1), CV_32F
+    std::vector<float> scale;           // (n+1)/π de cada momento
+};
+
+// Base de (grid, degree); se calcula la primera vez y queda en caché (thread-safe)
+const ZernikeBasis& zernikeBasis(int grid = ZERNIKE_GRID, int degree = ZERNIKE_DEGREE);
+
+// PASOS 1-2: Otsu (binarizeOtsu) + ROI del contorno mayor en context.binary
+bool findZernikeRoi(const cv::Mat& image, ExtractionContext& context, cv::Rect& roi,
+                    ExtractionSummary* summary = nullptr);
+
+/**
+ * PASO 3: la ROI binaria (CV_8UC1) con su centro de masas en el centro de
+ * la rejilla y el radio max(ancho, alto) / 2 escalado a grid / 2. Escribe
+ * grid² valores en `row` con los búferes de `context`. Devuelve false si
+ * la ROI está vacía.
+ */
+bool normalizeZernikeRoi(const cv::Mat& roi, int grid, ExtractionContext& context, float* row);
+
+/**
+ * PASO 4: |Z_nl| de N rejillas (matriz N×grid², CV_32F, una por fila) con
+ * un solo cv::gemm contra la base. Devuelve N×basis.count (CV_32F); fila
+ * a 0 si la rejilla no tiene masa dentro del disco.
+ */
+cv::Mat zernikeMagnitudes(const cv::Mat& grids, const ZernikeBasis& basis);
+
+/**
+ * Referencia: el algoritmo de mahotas píxel a píxel sobre la ROI original
+ * (centro de masas, polinomios radiales en cada píxel). Escribe
+ * zernikeMomentCount(degree) valores en `moments`.
+ */
+void zernikeMomentsDirect(const cv::Mat& roi, double radius, int degree, float* moments);
+
+// Pipeline completo de una imagen con los búferes de `context`; descriptor en context.features
+bool extractZernikeFeatures(const cv::Mat& image, ExtractionContext& context,
+                            ExtractionSummary* summary = nullptr);
+
+/**
+ * Pipeline completo de un lote: pasos 1-3 por imagen y un único producto
+ * de matrices para todo el lote. `summaries` (opcional) tiene
+ * images.size() elementos; descriptor vacío en las imágenes que fallan.
+ */
+std::vector<ShapeDescriptor> extractZernikeDescriptorBatch(const std::vector<cv::Mat>& images,
+                                                           const std::vector<std::string>& labels,
+                                                           const std::vector<std::string>& filenames,
+                                                           ExtractionContext& context,
+                                                           ExtractionSummary* summaries = nullptr);
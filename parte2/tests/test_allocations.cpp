@@ -0,0 +1,132 @@
+/**
+ * Reservas de memoria de la extracción tras el calentamiento.
+ *
+ * Este archivo reemplaza el operator new global de shape_tests para contar
+ * las reservas. Con el mismo ExtractionContext (o los mismos vectores):
+ * - computeDescriptor y extractContourFeatures no reservan nada;
+ * - extractShapeFeatures sólo reserva lo que reservan por dentro las
+ *   llamadas de OpenCV del paso 1 (cvtColor, adaptiveThreshold,
+ *   morphologyEx, findContours), que se miden aparte sobre los mismos
+ *   búferes y se descuentan.
+ * Los datos de los Mat (fastMalloc) no pasan por operator new: para esos se
+ * comprueba que los búferes del contexto no cambian de dirección.
+ */
+
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "contour_resample.h"
+#include "shape_pipeline.h"
+#include "synthetic_shapes.h"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+atomic<size_t> allocationCount{0};
+
+size_t allocations() {
+    return allocationCount.load(memory_order_relaxed);
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    if (void* ptr = malloc(size ? size : 1)) return ptr;
+    throw bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+namespace {
+
+const int SHAPES[] = {SHAPE_CIRCLE, SHAPE_TRIANGLE, SHAPE_SQUARE};
+const int STEADY_CALLS = 10;
+
+// Direcciones de los búferes del contexto: si cambian, el contexto se ha vuelto a reservar
+vector<const void*> bufferAddresses(const ExtractionContext& context) {
+    return {context.gray.data, context.binary.data, context.contour.data(),
+            context.cumulativeLength.data(), context.resampled.data(),
+            context.magnitudes.data(), context.features.data()};
+}
+
+// Pasos 3-6 con vectores reutilizados: cero reservas tras la primera llamada
+TEST(Allocations, ComputeDescriptorSteadyState) {
+    for (int shape : SHAPES) {
+        vector<Point2f> resampled = resampleContour(makeShapeContour(shape, 4096), NUM_POINTS);
+        vector<float> magnitudes, descriptor;
+        computeDescriptor(resampled, magnitudes, descriptor);   // calentamiento
+
+        size_t before = allocations();
+        for (int i = 0; i < STEADY_CALLS; i++) {
+            computeDescriptor(resampled, magnitudes, descriptor);
+        }
+        EXPECT_EQ(allocations() - before, 0u) << shapeName(shape);
+    }
+}
+
+// Pasos 2-6 con un contexto reutilizado (el camino de los trazos en Android)
+TEST(Allocations, ExtractContourFeaturesSteadyState) {
+    ExtractionContext context;
+    vector<vector<Point>> contours;
+    for (int shape : SHAPES) {
+        contours.push_back(makeShapeContour(shape, 4096));
+        ASSERT_TRUE(extractContourFeatures(contours.back(), context));   // calentamiento
+    }
+
+    for (size_t s = 0; s < contours.size(); s++) {
+        size_t before = allocations();
+        for (int i = 0; i < STEADY_CALLS; i++) {
+            ASSERT_TRUE(extractContourFeatures(contours[s], context));
+        }
+        EXPECT_EQ(allocations() - before, 0u) << shapeName(SHAPES[s]);
+    }
+}
+
+/**
+ * Pipeline completo: las únicas reservas son las internas de OpenCV en el
+ * paso 1. Con un solo hilo de OpenCV el reparto de parallel_for_ no añade
+ * reservas que dependan del planificador.
+ */
+TEST(Allocations, ExtractShapeFeaturesOnlyOpenCvAllocates) {
+    int threads = getNumThreads();
+    setNumThreads(1);
+
+    for (int size : {512, 2048}) {
+        for (int shape : SHAPES) {
+            Mat image = makeShapeImage(shape, size);
+            ExtractionContext context;
+            ASSERT_TRUE(extractShapeFeatures(image, context));     // calentamiento
+            vector<const void*> warm = bufferAddresses(context);
+
+            size_t before = allocations();
+            binarizeImage(image, context.binary, context.gray);
+            findContours(context.binary, context.contours, RETR_EXTERNAL, CHAIN_APPROX_NONE);
+            size_t openCv = allocations() - before;
+
+            before = allocations();
+            ASSERT_TRUE(extractShapeFeatures(image, context));
+            size_t total = allocations() - before;
+
+            EXPECT_EQ(total, openCv) << shapeName(shape) << " " << size << " px";
+            EXPECT_EQ(bufferAddresses(context), warm) << shapeName(shape) << " " << size << " px";
+        }
+    }
+
+    setNumThreads(threads);
+}
+
+}  // namespace
@@ -0,0 +1,176 @@
+/**
+ * Garantías del buzón de LatestWorker con varios productores que envían
+ * tan rápido como pueden y un manejador lento o instantáneo:
+ * - cada envío se procesa o se sustituye, nunca las dos cosas ni ninguna;
+ * - los resultados llegan en orden de secuencia estrictamente creciente;
+ * - el último envío siempre se procesa (el usuario ve el resultado final).
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "latest_worker.h"
+
+using namespace std;
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+const int SUBMISSIONS_PER_PRODUCER = 2000;
+const int ROUNDS = 3;
+
+// Espera activa: un sleep de pocos µs dura mucho más en la mayoría de sistemas
+void spinFor(chrono::microseconds duration) {
+    Clock::time_point end = Clock::now() + duration;
+    while (Clock::now() < end) {
+    }
+}
+
+// (productores, µs de trabajo del manejador)
+class LatestWorkerStress : public testing::TestWithParam<tuple<int, int>> {};
+
+TEST_P(LatestWorkerStress, EverySubmissionAccountedAndLastProcessed) {
+    const int producers = get<0>(GetParam());
+    const chrono::microseconds work(get<1>(GetParam()));
+
+    vector<uint64_t> sequences;          // sólo lo toca el hilo del worker
+    LatestWorker<vector<float>> worker([&](vector<float>& stroke, uint64_t sequence) {
+        ASSERT_FALSE(stroke.empty());
+        spinFor(work);
+        sequences.push_back(sequence);
+    });
+
+    uint64_t submitted = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        vector<thread> threads;
+        for (int p = 0; p < producers; p++) {
+            threads.emplace_back([&worker, p] {
+                vector<float> stroke(64, static_cast<float>(p));
+                for (int i = 0; i < SUBMISSIONS_PER_PRODUCER; i++) {
+                    worker.submit(stroke);
+                }
+            });
+        }
+        for (thread& t : threads) t.join();
+        worker.drain();
+        submitted += static_cast<uint64_t>(producers) * SUBMISSIONS_PER_PRODUCER;
+
+        LatestWorker<vector<float>>::Stats stats = worker.stats();
+        ASSERT_EQ(stats.submitted, submitted) << "ronda " << round;
+        EXPECT_EQ(stats.processed + stats.replaced, stats.submitted) << "ronda " << round;
+        EXPECT_EQ(stats.processed, sequences.size()) << "ronda " << round;
+        ASSERT_FALSE(sequences.empty());
+        EXPECT_EQ(sequences.back(), stats.submitted) << "el último envío no se procesó";
+    }
+
+    for (size_t i = 1; i < sequences.size(); i++) {
+        ASSERT_LT(sequences[i - 1], sequences[i]) << "resultados fuera de orden en " << i;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(ProducersAndWork, LatestWorkerStress,
+                         testing::Combine(testing::Values(1, 4), testing::Values(0, 50, 1000)));
+
+// Con un solo productor, el trabajo que recibe el manejador es el de su número de secuencia
+TEST(LatestWorker, HandlerReceivesJobOfItsSequence) {
+    atomic<bool> matches{true};
+    LatestWorker<uint64_t> worker([&](uint64_t& job, uint64_t sequence) {
+        if (job != sequence) matches = false;
+    });
+    for (uint64_t i = 1; i <= 10000; i++) {
+        ASSERT_EQ(worker.submit(i), i);
+    }
+    worker.drain();
+    EXPECT_TRUE(matches);
+}
+
+// Un envío mientras el manejador está ocupado espera en el buzón y sustituye al anterior
+TEST(LatestWorker, PendingJobIsReplacedWhileBusy) {
+    atomic<bool> started{false}, release{false};
+    vector<int> handled;
+    LatestWorker<int> worker([&](int& job, uint64_t) {
+        started = true;
+        while (!release) this_thread::yield();
+        handled.push_back(job);
+    });
+
+    worker.submit(1);
+    while (!started) this_thread::yield();
+    worker.submit(2);
+    worker.submit(3);       // sustituye a 2 sin que llegue a procesarse
+    release = true;
+    worker.drain();
+
+    EXPECT_EQ(handled, (vector<int>{1, 3}));
+    LatestWorker<int>::Stats stats = worker.stats();
+    EXPECT_EQ(stats.submitted, 3u);
+    EXPECT_EQ(stats.processed, 2u);
+    EXPECT_EQ(stats.replaced, 1u);
+}
+
+// drain relanza la primera excepción del manejador una sola vez y el hilo sigue vivo
+TEST(LatestWorker, DrainRethrowsHandlerErrorOnce) {
+    LatestWorker<int> worker([](int& job, uint64_t) {
+        if (job < 0) throw runtime_error("trazo inválido");
+    });
+    worker.submit(-1);
+    EXPECT_THROW(worker.drain(), runtime_error);
+
+    worker.submit(1);
+    EXPECT_NO_THROW(worker.drain());
+    EXPECT_EQ(worker.stats().processed, 2u);
+}
+
+// Tras stop (el destructor) el trabajo en curso termina y el del buzón se descarta
+TEST(LatestWorker, DestructorDiscardsPendingJob) {
+    atomic<bool> started{false}, release{false};
+    atomic<int> handled{0};
+    {
+        LatestWorker<int> worker([&](int&, uint64_t) {
+            started = true;
+            while (!release) this_thread::yield();
+            handled++;
+        });
+        worker.submit(1);
+        while (!started) this_thread::yield();
+        worker.submit(2);
+        worker.stop();      // antes de soltar el manejador: 2 no puede empezar
+        release = true;
+    }
+    EXPECT_EQ(handled.load(), 1);
+}
+
+// drain tras stop vuelve en cuanto acaba el trabajo en curso, también con envíos posteriores
+TEST(LatestWorker, DrainAfterStopReturns) {
+    atomic<bool> started{false}, release{false};
+    atomic<int> handled{0};
+    LatestWorker<int> worker([&](int&, uint64_t) {
+        started = true;
+        while (!release) this_thread::yield();
+        handled++;
+    });
+    worker.submit(1);
+    while (!started) this_thread::yield();
+    worker.submit(2);
+    worker.stop();
+    release = true;
+    worker.drain();
+
+    worker.submit(3);       // con el hilo parado se descarta sin llegar al buzón
+    worker.drain();
+
+    EXPECT_EQ(handled.load(), 1);
+    LatestWorker<int>::Stats stats = worker.stats();
+    EXPECT_EQ(stats.submitted, 3u);
+    EXPECT_EQ(stats.processed, 1u);
+    EXPECT_EQ(stats.replaced, 2u);
+}
+
+}  // namespace
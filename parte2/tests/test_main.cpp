@@ -0,0 +1,15 @@
+/**
+ * Punto de entrada de shape_tests. Igual que gtest_main, pero silencia los
+ * logs de shape_core (y sin sink, los mensajes no se formatean ni reservan).
+ */
+
+#include <gtest/gtest.h>
+
+#include "shape_log.h"
+
+int main(int argc, char** argv) {
+    setLogSink(nullptr);
+
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
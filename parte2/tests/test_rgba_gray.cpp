@@ -0,0 +1,86 @@
+/**
+ * rgbaToGray frente a cvtColor(COLOR_RGBA2GRAY): mismos pesos en punto fijo,
+ * así que el resultado debe ser idéntico byte a byte (diferencia máxima 0)
+ * en cualquier ancho (bloques de 32 píxeles + resto), en ROIs con stride y
+ * en ROIs de un solo píxel.
+ */
+
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "rgba_gray.h"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+Mat randomRgba(int rows, int cols, uint64 seed) {
+    Mat rgba(rows, cols, CV_8UC4);
+    RNG rng(seed);
+    rng.fill(rgba, RNG::UNIFORM, Scalar::all(0), Scalar::all(256));
+    return rgba;
+}
+
+double maxDiff(const Mat& rgba) {
+    Mat expected, actual;
+    cvtColor(rgba, expected, COLOR_RGBA2GRAY);
+    rgbaToGray(rgba, actual);
+    EXPECT_EQ(actual.size(), rgba.size());
+    EXPECT_EQ(actual.type(), CV_8UC1);
+    return norm(expected, actual, NORM_INF);
+}
+
+// Anchos a ambos lados del bloque de 32 píxeles, pares e impares
+const int WIDTHS[] = {1, 2, 3, 7, 31, 32, 33, 63, 64, 65, 517, 1081};
+
+TEST(RgbaToGray, MatchesCvtColorForAnyWidth) {
+    for (int width : WIDTHS) {
+        for (int height : {1, 3, 17}) {
+            Mat rgba = randomRgba(height, width, width * 131 + height);
+            EXPECT_EQ(maxDiff(rgba), 0.0) << width << "×" << height;
+        }
+    }
+}
+
+// ROI interior: el stride de fila es el de la imagen completa, no 4·cols
+TEST(RgbaToGray, MatchesCvtColorOnStridedRoi) {
+    Mat canvas = randomRgba(301, 1091, 7);
+    for (int width : WIDTHS) {
+        Rect roi(5, 3, width, 290);
+        ASSERT_FALSE(canvas(roi).isContinuous());
+        EXPECT_EQ(maxDiff(canvas(roi)), 0.0) << "ROI de " << width << " px de ancho";
+    }
+}
+
+TEST(RgbaToGray, MatchesCvtColorOnSinglePixelRois) {
+    Mat canvas = randomRgba(37, 53, 11);
+    for (Point at : {Point(0, 0), Point(52, 0), Point(0, 36), Point(52, 36), Point(31, 18), Point(32, 5)}) {
+        EXPECT_EQ(maxDiff(canvas(Rect(at, Size(1, 1)))), 0.0) << at;
+    }
+}
+
+// Todos los valores de cada canal, con el búfer de salida reutilizado entre llamadas
+TEST(RgbaToGray, MatchesCvtColorOnEveryChannelValue) {
+    Mat ramp(256, 256, CV_8UC4);
+    for (int y = 0; y < ramp.rows; y++) {
+        for (int x = 0; x < ramp.cols; x++) {
+            ramp.at<Vec4b>(y, x) = Vec4b(x, y, (x + y) & 0xFF, (x * y) & 0xFF);
+        }
+    }
+    Mat expected, gray;
+    for (int order = 0; order < 3; order++) {
+        // Rota R, G y B para que cada canal recorra los 256 valores
+        Mat rotated(ramp.size(), CV_8UC4);
+        const int fromTo[] = {0, order, 1, (order + 1) % 3, 2, (order + 2) % 3, 3, 3};
+        mixChannels(&ramp, 1, &rotated, 1, fromTo, 4);
+        cvtColor(rotated, expected, COLOR_RGBA2GRAY);
+        const uchar* data = gray.data;
+        rgbaToGray(rotated, gray);
+        if (data) EXPECT_EQ(gray.data, data) << "el búfer de salida se ha vuelto a reservar";
+        EXPECT_EQ(norm(expected, gray, NORM_INF), 0.0) << "orden " << order;
+    }
+}
+
+}  // namespace
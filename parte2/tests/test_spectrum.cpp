@@ -0,0 +1,57 @@
+/**
+ * Motor de espectro (computeHarmonics) frente a cv::dft (computeFFT) en las
+ * formas sintéticas, en el sentido de makeShapeContour (F[1] concentra la
+ * energía, descriptor ~[1, 0, ...]) y en el de findContours
+ * (makeTracedContour, componentes de ~15 a ~160 como en el corpus real).
+ * Tras normalizar, cada componente debe coincidir dentro de
+ * descriptorTolerance: 1e-5 · ‖F‖₂ / |F[1]|.
+ */
+
+#include <gtest/gtest.h>
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+#include "contour_resample.h"
+#include "shape_pipeline.h"
+#include "synthetic_shapes.h"
+
+using namespace cv;
+using namespace std;
+
+namespace {
+
+// (forma, orientación de findContours)
+class HarmonicsVsDft : public testing::TestWithParam<tuple<int, bool>> {};
+
+TEST_P(HarmonicsVsDft, NormalizedDescriptorWithinTolerance) {
+    const int shape = get<0>(GetParam());
+    const bool traced = get<1>(GetParam());
+    vector<Point> contour = traced ? makeTracedContour(shape, 4096) : makeShapeContour(shape, 4096);
+    vector<Point2f> interpolated = resampleContour(contour, NUM_POINTS);
+    Mat signal = buildComplexSignal(interpolated, calculateCentroid(interpolated));
+
+    vector<float> reference, magnitudes;
+    computeFFT(signal, reference);
+    computeHarmonics(signal, magnitudes);
+    vector<float> expected = normalizeDescriptor(reference);
+    vector<float> actual = normalizeDescriptor(magnitudes);
+
+    ASSERT_EQ(actual.size(), expected.size());
+    double maxError = 0, maxValue = 0;
+    for (size_t k = 0; k < expected.size(); k++) {
+        maxError = max(maxError, static_cast<double>(fabs(expected[k] - actual[k])));
+        maxValue = max(maxValue, static_cast<double>(expected[k]));
+    }
+    EXPECT_GT(maxValue, 0.0) << "descriptor a cero";
+    EXPECT_LE(maxError, descriptorTolerance(interpolated))
+        << shapeName(shape) << (traced ? " (findContours)" : "") << ", componente mayor " << maxValue;
+}
+
+INSTANTIATE_TEST_SUITE_P(SyntheticShapes, HarmonicsVsDft,
+                         testing::Combine(testing::Values(SHAPE_CIRCLE, SHAPE_TRIANGLE, SHAPE_SQUARE),
+                                          testing::Bool()));
+
+}  // namespace